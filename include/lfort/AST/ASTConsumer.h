@@ -139,6 +139,14 @@ public:
   /// body may be parsed anyway if it is needed (for instance, if it contains
   /// the code completion point or is constexpr).
   virtual bool shouldSkipSubprogramBody(Decl *D) { return true; }
+
+  /// \brief This callback is called at the end of the program if the Parser
+  /// skipped the bodies of program units that nothing has asked for since.
+  ///
+  /// \return \c true if the consumer needs those bodies, for instance to
+  /// generate code for them.  They are then parsed and handed to
+  /// HandleTopLevelDecl again.
+  virtual bool needsSkippedSubprogramBodies() { return false; }
 };
 
 } // end namespace lfort.
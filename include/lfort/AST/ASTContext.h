@@ -1744,6 +1744,24 @@ public:
   /// \brief Return number of constant array elements.
   uint64_t getConstantArrayElementCount(const ConstantArrayType *CA) const;
 
+  /// \brief Determine whether \p T is a Fortran character type, which is
+  /// represented as an array of characters.
+  bool isFortranCharacterType(QualType T) const;
+
+  /// \brief Determine whether \p T is a Fortran array type rather than a
+  /// scalar type.  Character types are scalars.
+  bool isFortranArrayType(QualType T) const {
+    return getAsArrayType(T) && !isFortranCharacterType(T);
+  }
+
+  /// \brief Return the type of the elements of a Fortran array, or \p T
+  /// itself if it is a scalar.
+  QualType getFortranScalarType(QualType T) const;
+
+  /// \brief Return the type of an array of the same shape as \p ArrayTy
+  /// whose elements are of type \p ScalarTy.
+  QualType getFortranArrayOfShape(QualType ArrayTy, QualType ScalarTy) const;
+
   /// \brief Perform adjustment on the parameter type of a function.
   ///
   /// This routine adjusts the given parameter type @p T to the actual
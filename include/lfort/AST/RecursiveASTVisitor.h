@@ -1877,6 +1877,7 @@ DEF_TRAVERSE_STMT(ContinueStmt, { })
 DEF_TRAVERSE_STMT(DefaultStmt, { })
 DEF_TRAVERSE_STMT(DoStmt, { })
 DEF_TRAVERSE_STMT(ForStmt, { })
+DEF_TRAVERSE_STMT(DoConcurrentStmt, { })
 DEF_TRAVERSE_STMT(GotoStmt, { })
 DEF_TRAVERSE_STMT(IfStmt, { })
 DEF_TRAVERSE_STMT(IndirectGotoStmt, { })
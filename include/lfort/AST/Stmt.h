@@ -1174,6 +1174,122 @@ public:
   }
 };
 
+/// DoConcurrentStmt - This represents a Fortran 2008 DO CONCURRENT construct
+/// (R818).  The index-names of its concurrent-header are declared by a single
+/// DeclStmt, and each index has a lower limit, an upper limit and an optional
+/// step.  The iterations may be executed in any order, or concurrently.
+///
+/// \code
+/// do concurrent (i = 1:n, j = 1:m:2, a(i, j) > 0)
+///   b(i, j) = sqrt(a(i, j))
+/// end do
+/// \endcode
+class DoConcurrentStmt : public Stmt {
+public:
+  /// \brief The limits of each index-name, in the order they are stored.
+  enum { LOWER, UPPER, STEP, LIMITS_PER_INDEX };
+
+private:
+  enum { INDICES, FIRST_LIMIT };
+  unsigned NumIndices;
+  Stmt **SubExprs;
+  SourceLocation DoLoc, LParenLoc, RParenLoc, EndLoc;
+
+  unsigned getMaskIndex() const {
+    return FIRST_LIMIT + NumIndices * LIMITS_PER_INDEX;
+  }
+  unsigned getLimitIndex(unsigned I, unsigned Kind) const {
+    assert(I < NumIndices && "Index out of range!");
+    return FIRST_LIMIT + I * LIMITS_PER_INDEX + Kind;
+  }
+
+  DoConcurrentStmt(ASTContext &C, EmptyShell Empty, unsigned NumIndices);
+
+public:
+  /// \brief Build a DO CONCURRENT construct.  \p Limits holds the lower
+  /// limit, upper limit and step of each index in turn, with a null step
+  /// where none was written.
+  DoConcurrentStmt(ASTContext &C, SourceLocation DoLoc,
+                   SourceLocation LParenLoc, DeclStmt *Indices,
+                   ArrayRef<Expr *> Limits, Expr *Mask,
+                   SourceLocation RParenLoc, Stmt *Body,
+                   SourceLocation EndLoc);
+
+  /// \brief Build an empty DO CONCURRENT construct with \p NumIndices
+  /// indices.
+  static DoConcurrentStmt *CreateEmpty(ASTContext &C, unsigned NumIndices);
+
+  unsigned getNumIndices() const { return NumIndices; }
+
+  /// \brief Retrieve the DeclStmt that declares the index-names.
+  DeclStmt *getIndexDeclStmt() {
+    return reinterpret_cast<DeclStmt*>(SubExprs[INDICES]);
+  }
+  const DeclStmt *getIndexDeclStmt() const {
+    return reinterpret_cast<DeclStmt*>(SubExprs[INDICES]);
+  }
+  void setIndexDeclStmt(DeclStmt *S) {
+    SubExprs[INDICES] = reinterpret_cast<Stmt*>(S);
+  }
+
+  /// \brief Retrieve the variable of the \p I'th index-name.
+  VarDecl *getIndexVar(unsigned I) const;
+
+  Expr *getLower(unsigned I) const {
+    return reinterpret_cast<Expr*>(SubExprs[getLimitIndex(I, LOWER)]);
+  }
+  Expr *getUpper(unsigned I) const {
+    return reinterpret_cast<Expr*>(SubExprs[getLimitIndex(I, UPPER)]);
+  }
+  /// \brief Retrieve the step of the \p I'th index, or null if it has the
+  /// default step of one.
+  Expr *getStep(unsigned I) const {
+    return reinterpret_cast<Expr*>(SubExprs[getLimitIndex(I, STEP)]);
+  }
+  void setLower(unsigned I, Expr *E) {
+    SubExprs[getLimitIndex(I, LOWER)] = reinterpret_cast<Stmt*>(E);
+  }
+  void setUpper(unsigned I, Expr *E) {
+    SubExprs[getLimitIndex(I, UPPER)] = reinterpret_cast<Stmt*>(E);
+  }
+  void setStep(unsigned I, Expr *E) {
+    SubExprs[getLimitIndex(I, STEP)] = reinterpret_cast<Stmt*>(E);
+  }
+
+  /// \brief Retrieve the scalar-mask-expr, or null if there is none.
+  Expr *getMask() const {
+    return reinterpret_cast<Expr*>(SubExprs[getMaskIndex()]);
+  }
+  void setMask(Expr *E) {
+    SubExprs[getMaskIndex()] = reinterpret_cast<Stmt*>(E);
+  }
+
+  Stmt *getBody() { return SubExprs[getMaskIndex() + 1]; }
+  const Stmt *getBody() const { return SubExprs[getMaskIndex() + 1]; }
+  void setBody(Stmt *S) { SubExprs[getMaskIndex() + 1] = S; }
+
+  SourceLocation getDoLoc() const { return DoLoc; }
+  void setDoLoc(SourceLocation L) { DoLoc = L; }
+  SourceLocation getLParenLoc() const { return LParenLoc; }
+  void setLParenLoc(SourceLocation L) { LParenLoc = L; }
+  SourceLocation getRParenLoc() const { return RParenLoc; }
+  void setRParenLoc(SourceLocation L) { RParenLoc = L; }
+  SourceLocation getEndLoc() const { return EndLoc; }
+  void setEndLoc(SourceLocation L) { EndLoc = L; }
+
+  SourceLocation getLocStart() const LLVM_READONLY { return DoLoc; }
+  SourceLocation getLocEnd() const LLVM_READONLY { return EndLoc; }
+
+  static bool classof(const Stmt *T) {
+    return T->getStmtClass() == DoConcurrentStmtClass;
+  }
+
+  // Iterators
+  child_range children() {
+    return child_range(&SubExprs[0], &SubExprs[getMaskIndex() + 2]);
+  }
+};
+
 /// GotoStmt - This represents a direct goto.
 ///
 class GotoStmt : public Stmt {
@@ -38,6 +38,7 @@ namespace sys { class Path; }
 }
 
 namespace lfort {
+class DirectoryListingStatCache;
 class FileManager;
 class FileSystemStatCache;
 
@@ -159,10 +160,16 @@ class FileManager : public RefCountedBase<FileManager> {
   // Statistics.
   unsigned NumDirLookups, NumFileLookups;
   unsigned NumDirCacheMisses, NumFileCacheMisses;
+  uint64_t NumBytesMapped, NumBytesCopied;
+  unsigned NumSharedMappings;
 
   // Caching.
   OwningPtr<FileSystemStatCache> StatCache;
 
+  /// \brief The directory listing cache within the StatCache chain, if
+  /// FileSystemOptions::CacheDirectoryListings is set.
+  DirectoryListingStatCache *DirListingCache;
+
   bool getStatValue(const char *Path, struct stat &StatBuf,
                     bool isFile, int *FileDescriptor);
 
@@ -170,6 +177,9 @@ class FileManager : public RefCountedBase<FileManager> {
   /// or a directory) as virtual directories.
   void addAncestorsAsVirtualDirs(StringRef Path);
 
+  /// \brief Account for a buffer read from disk in the statistics.
+  void noteBufferRead(const llvm::MemoryBuffer *Buffer);
+
 public:
   FileManager(const FileSystemOptions &FileSystemOpts);
   ~FileManager();
@@ -193,6 +203,15 @@ public:
   /// \brief Removes all FileSystemStatCache objects from the manager.
   void clearStatCaches();
 
+  /// \brief Forget the cached listing of the directory containing
+  /// \p Filename, so that a file created there since it was read will be
+  /// found.
+  void invalidateDirectoryListing(StringRef Filename);
+
+  /// \brief Persist the directory listings read so far, if a directory
+  /// listing cache file was requested.
+  void writeDirectoryListingCache();
+
   /// \brief Lookup, cache, and verify the specified directory (real or
   /// virtual).
   ///
@@ -227,6 +246,10 @@ public:
 
   /// \brief Open the specified file as a MemoryBuffer, returning a new
   /// MemoryBuffer if successful, otherwise returning null.
+  ///
+  /// If FileSystemOptions::MapSourceFiles is set, the buffer for a
+  /// non-volatile file refers to a read-only mapping of it that is shared
+  /// with every other buffer for the same version of the file in the process.
   llvm::MemoryBuffer *getBufferForFile(const FileEntry *Entry,
                                        std::string *ErrorStr = 0,
                                        bool isVolatile = false);
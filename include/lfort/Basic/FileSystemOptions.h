@@ -25,6 +25,20 @@ public:
   /// \brief If set, paths are resolved as if the working directory was
   /// set to the value of WorkingDir.
   std::string WorkingDir;
+
+  /// \brief Whether lookups of nonexistent files are answered from cached
+  /// directory listings rather than by stat'ing each candidate path.
+  unsigned CacheDirectoryListings : 1;
+
+  /// \brief If set, directory listings are persisted across compilations in
+  /// this file.
+  std::string DirectoryListingCachePath;
+
+  /// \brief Whether source files are always read through read-only memory
+  /// mappings, shared by every FileManager in the process.
+  unsigned MapSourceFiles : 1;
+
+  FileSystemOptions() : CacheDirectoryListings(false), MapSourceFiles(false) { }
 };
 
 } // end namespace lfort
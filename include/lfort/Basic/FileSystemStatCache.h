@@ -18,6 +18,9 @@
 #include "lfort/Basic/LLVM.h"
 #include "llvm/ADT/OwningPtr.h"
 #include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/StringSet.h"
+#include <string>
+#include <ctime>
 #include <sys/stat.h>
 #include <sys/types.h>
 
@@ -101,6 +104,81 @@ public:
                                bool isFile, int *FileDescriptor);
 };
 
+/// \brief A stat cache that answers lookups of nonexistent files from
+/// directory listings instead of the file system.
+///
+/// The first lookup of a path in a given directory reads the whole
+/// directory once.  Later lookups of names that are not in the listing
+/// return \c CacheMissing without a system call, which is what header
+/// search does for every search directory that lacks the requested file.
+/// Names that are in the listing are passed down the chain so that the
+/// real stat information is obtained.
+///
+/// Listings of absolute directories can be persisted across compilations
+/// in a cache file.  A persisted listing is only reused if the directory's
+/// modification time is unchanged and predates the time it was read, which
+/// costs one stat of the directory instead of reading it.
+class DirectoryListingStatCache : public FileSystemStatCache {
+  struct DirectoryListing {
+    DirectoryListing() : Exists(false), Validated(false), ModTime(0),
+                         ListedAt(0) { }
+
+    /// \brief Whether the directory exists at all.
+    bool Exists;
+
+    /// \brief Whether the listing is known to match the file system in this
+    /// compilation, as opposed to having been loaded from the cache file.
+    bool Validated;
+
+    /// \brief The modification time of the directory when it was read.
+    time_t ModTime;
+
+    /// \brief The time at which the directory was read.
+    time_t ListedAt;
+
+    /// \brief The entries of the directory, lowercased so that lookups on
+    /// case-insensitive file systems are never answered incorrectly.
+    llvm::StringSet<> Names;
+  };
+
+  llvm::StringMap<DirectoryListing, llvm::BumpPtrAllocator> Listings;
+
+  /// \brief The file listings are persisted in, if any.
+  std::string CachePath;
+
+  /// \brief Whether a directory has been read since the cache file was
+  /// loaded.
+  bool Dirty;
+
+  // Statistics.
+  unsigned NumDirectoriesRead, NumListingsReused, NumStatsAvoided;
+
+  DirectoryListing *getListing(StringRef DirName);
+  void readCacheFile();
+
+public:
+  /// \brief Create a directory listing cache, loading persisted listings
+  /// from \p CachePath if it is not empty.
+  explicit DirectoryListingStatCache(StringRef CachePath = StringRef());
+
+  /// \brief Write the listings back to the cache file, if any directory was
+  /// read since it was loaded.
+  ///
+  /// The file is replaced atomically so that concurrent compilations sharing
+  /// a cache file never observe a partial write.  Failure to write the cache
+  /// is not an error.
+  void writeCacheFile();
+
+  /// \brief Forget the listing of the given directory, e.g., because the
+  /// client is about to create a file in it.
+  void invalidateDirectory(StringRef DirName);
+
+  void PrintStats() const;
+
+  virtual LookupResult getStat(const char *Path, struct stat &StatBuf,
+                               bool isFile, int *FileDescriptor);
+};
+
 } // end namespace lfort
 
 #endif
@@ -0,0 +1,86 @@
+//===--- FortranIntrinsics.h - Fortran intrinsic procedures -----*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// \brief Defines the IDs and descriptions of the Fortran intrinsic
+/// procedures, which are generated from FortranIntrinsics.td.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_LFORT_BASIC_FORTRANINTRINSICS_H
+#define LLVM_LFORT_BASIC_FORTRANINTRINSICS_H
+
+#include "lfort/Basic/LLVM.h"
+#include "llvm/ADT/StringRef.h"
+
+namespace lfort {
+
+namespace intrinsic {
+enum ID {
+  NotIntrinsic = 0,      // This is not an intrinsic procedure.
+#define FORTRAN_INTRINSIC(NAME) FI_##NAME,
+#define GET_FORTRAN_INTRINSIC_LIST
+#include "lfort/Basic/FortranIntrinsics.inc"
+#undef GET_FORTRAN_INTRINSIC_LIST
+#undef FORTRAN_INTRINSIC
+  NumIntrinsics
+};
+
+/// \brief The description of an intrinsic procedure.
+///
+/// The argument and result type codes are documented in
+/// FortranIntrinsics.td.
+struct Info {
+  /// \brief The generic name of the intrinsic.
+  const char *Name;
+
+  /// \brief The comma-separated argument keywords, in positional order.
+  const char *Keywords;
+
+  /// \brief One type code per argument, optionally followed by '.' if the
+  /// last argument may be repeated.
+  const char *ArgTypes;
+
+  /// \brief The type code of the result, 'v' for a subroutine.
+  char ResultType;
+
+  /// \brief The number of leading arguments that must be present.
+  unsigned char NumRequired;
+
+  /// \brief The position of the KIND argument, or -1 if there is none.
+  signed char KindArg;
+
+  /// \brief Whether the intrinsic is elemental.
+  bool Elemental;
+
+  /// \brief Return the number of arguments, not counting repetitions.
+  unsigned getNumArgs() const {
+    StringRef Args(ArgTypes);
+    return Args.size() - Args.endswith(".");
+  }
+
+  /// \brief Whether the last argument may be repeated.
+  bool isVariadic() const { return StringRef(ArgTypes).endswith("."); }
+
+  /// \brief Whether the intrinsic is a subroutine rather than a function.
+  bool isSubroutine() const { return ResultType == 'v'; }
+};
+
+/// \brief Return the intrinsic with the given (lowercase) name, or
+/// NotIntrinsic if there is none.
+ID lookup(StringRef Name);
+
+/// \brief Return the description of the given intrinsic.
+const Info &getInfo(ID IntrinsicID);
+
+} // end namespace intrinsic
+
+} // end namespace lfort
+
+#endif
@@ -19,6 +19,7 @@
 #include "lfort/Basic/LLVM.h"
 #include "lfort/Basic/OperatorKinds.h"
 #include "lfort/Basic/TokenKinds.h"
+#include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/PointerLikeTypeTraits.h"
@@ -426,12 +427,28 @@ class IdentifierTable {
 
   IdentifierInfoLookup* ExternalLookup;
 
+  /// \brief True if identifiers are hashed and compared on their case-folded
+  /// spelling, so that \c FOO, \c Foo and \c foo share one IdentifierInfo.
+  bool FoldCase;
+
 public:
   /// \brief Create the identifier table, populating it with info about the
   /// language keywords for the language specified by \p LangOpts.
   IdentifierTable(const LangOptions &LangOpts,
                   IdentifierInfoLookup* externalLookup = 0);
 
+  /// \brief Whether names are interned by their case-folded spelling.
+  bool isCaseFolding() const { return FoldCase; }
+
+  /// \brief Copy the \p Len bytes at \p Src to \p Dst, lowering any ASCII
+  /// upper-case letters on the way.
+  ///
+  /// The bulk of the copy is done 16 bytes at a time when vector instructions
+  /// are available.  \p Src and \p Dst may be the same buffer.
+  ///
+  /// \returns true if any character was changed.
+  static bool foldCase(const char *Src, unsigned Len, char *Dst);
+
   /// \brief Set the external identifier lookup mechanism.
   void setExternalIdentifierLookup(IdentifierInfoLookup *IILookup) {
     ExternalLookup = IILookup;
@@ -449,6 +466,21 @@ public:
   /// \brief Return the identifier token info for the specified named
   /// identifier.
   IdentifierInfo &get(StringRef Name) {
+    if (FoldCase) {
+      SmallString<64> Folded;
+      if (fold(Name, Folded))
+        return getFolded(Folded);
+    }
+    return getFolded(Name);
+  }
+
+  /// \brief Return the identifier token info for a name which is already in
+  /// canonical form, i.e. which has already been through foldCase() if this
+  /// table is case folding.
+  ///
+  /// This is the entry point used by the lexer, which folds identifiers
+  /// directly out of the source buffer.
+  IdentifierInfo &getFolded(StringRef Name) {
     llvm::StringMapEntry<IdentifierInfo*> &Entry =
       HashTable.GetOrCreateValue(Name);
 
@@ -491,6 +523,10 @@ public:
   /// introduce or modify an identifier. If they called get(), they would
   /// likely end up in a recursion.
   IdentifierInfo &getOwn(StringRef Name) {
+    SmallString<64> Folded;
+    if (FoldCase && fold(Name, Folded))
+      Name = Folded;
+
     llvm::StringMapEntry<IdentifierInfo*> &Entry =
       HashTable.GetOrCreateValue(Name);
 
@@ -526,6 +562,11 @@ public:
   void PrintStats() const;
 
   void AddKeywords(const LangOptions &LangOpts);
+
+private:
+  /// \brief Fold \p Name into \p Folded.  Returns false, leaving \p Folded
+  /// untouched, if \p Name is already in canonical form.
+  static bool fold(StringRef Name, SmallVectorImpl<char> &Folded);
 };
 
 /// \brief A family of Objective-C methods. 
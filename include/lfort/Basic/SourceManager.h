@@ -113,13 +113,15 @@ namespace SrcMgr {
 
     /// \brief A bump pointer allocated array of offsets for each source line.
     ///
-    /// This is lazily computed.  This is owned by the SourceManager
-    /// BumpPointerAllocator object.
+    /// This is lazily computed, and only as far into the buffer as line
+    /// information has been asked for; see LineScanOffset.  This is owned by
+    /// the SourceManager BumpPointerAllocator object.
     unsigned *SourceLineCache;
 
-    /// \brief The number of lines in this ContentCache.
+    /// \brief The number of lines in SourceLineCache.
     ///
-    /// This is only valid if SourceLineCache is non-null.
+    /// This is only valid if SourceLineCache is non-null.  It is the number
+    /// of lines in this ContentCache once LineTableComplete is set.
     unsigned NumLines : 31;
 
     /// \brief Indicates whether the buffer itself was provided to override
@@ -132,16 +134,28 @@ namespace SrcMgr {
     /// \brief True if this content cache was initially created for a source
     /// file considered as a system one.
     unsigned IsSystemFile : 1;
+
+    /// \brief True once SourceLineCache covers the whole buffer.
+    unsigned LineTableComplete : 1;
+
+    /// \brief The number of entries SourceLineCache has room for.
+    unsigned LineCacheCapacity;
+
+    /// \brief The buffer offset up to which SourceLineCache is known to hold
+    /// the start of every line.
+    unsigned LineScanOffset;
     
     ContentCache(const FileEntry *Ent = 0)
       : Buffer(0, false), OrigEntry(Ent), ContentsEntry(Ent),
         SourceLineCache(0), NumLines(0), BufferOverridden(false),
-        IsSystemFile(false) {}
+        IsSystemFile(false), LineTableComplete(false), LineCacheCapacity(0),
+        LineScanOffset(0) {}
     
     ContentCache(const FileEntry *Ent, const FileEntry *contentEnt)
       : Buffer(0, false), OrigEntry(Ent), ContentsEntry(contentEnt),
         SourceLineCache(0), NumLines(0), BufferOverridden(false),
-        IsSystemFile(false) {}
+        IsSystemFile(false), LineTableComplete(false), LineCacheCapacity(0),
+        LineScanOffset(0) {}
     
     ~ContentCache();
     
@@ -150,7 +164,8 @@ namespace SrcMgr {
     /// is not transferred, so this is a logical error.
     ContentCache(const ContentCache &RHS)
       : Buffer(0, false), SourceLineCache(0), BufferOverridden(false),
-        IsSystemFile(false)
+        IsSystemFile(false), LineTableComplete(false), LineCacheCapacity(0),
+        LineScanOffset(0)
     {
       OrigEntry = RHS.OrigEntry;
       ContentsEntry = RHS.ContentsEntry;
@@ -555,6 +570,10 @@ class SourceManager : public RefCountedBase<SourceManager> {
   /// (likely to change while trying to use them). Defaults to false.
   bool UserFilesAreVolatile;
 
+  /// \brief True if presumed column numbers are card columns of fixed-form
+  /// source, rather than byte offsets within the line.  Defaults to false.
+  bool FixedFormColumns;
+
   struct OverriddenFilesInfoTy {
     /// \brief Files that have been overriden with the contents from another
     /// file.
@@ -689,6 +708,15 @@ public:
   /// (likely to change while trying to use them).
   bool userFilesAreVolatile() const { return UserFilesAreVolatile; }
 
+  /// \brief Set true if presumed column numbers, which are the ones reported
+  /// in diagnostics and debug information, should be fixed-form card columns.
+  ///
+  /// \see getCardColumnNumber
+  void setFixedFormColumns(bool value) { FixedFormColumns = value; }
+
+  /// \brief True if presumed column numbers are fixed-form card columns.
+  bool hasFixedFormColumns() const { return FixedFormColumns; }
+
   /// \brief Retrieve the module build stack.
   PCModuleBuildStack getPCModuleBuildStack() const {
     return StoredPCModuleBuildStack;
@@ -1189,6 +1217,15 @@ public:
   /// before calling this method.
   unsigned getColumnNumber(FileID FID, unsigned FilePos,
                            bool *Invalid = 0) const;
+
+  /// \brief Return the fixed-form card column for the specified file
+  /// position.
+  ///
+  /// This is the same as getColumnNumber() unless the line holds tabs.  A tab
+  /// in the label or continuation field (columns 1-6) advances to column 7,
+  /// as in tab-format source, and any other tab to the next multiple of 8.
+  unsigned getCardColumnNumber(FileID FID, unsigned FilePos,
+                               bool *Invalid = 0) const;
   unsigned getSpellingColumnNumber(SourceLocation Loc, bool *Invalid = 0) const;
   unsigned getExpansionColumnNumber(SourceLocation Loc,
                                     bool *Invalid = 0) const;
@@ -1199,8 +1236,8 @@ public:
   /// for the position indicated.
   ///
   /// This requires building and caching a table of line offsets for the
-  /// MemoryBuffer, so this is not cheap: use only when about to emit a
-  /// diagnostic.
+  /// MemoryBuffer up to the position, so this is not cheap: use only when
+  /// about to emit a diagnostic.
   unsigned getLineNumber(FileID FID, unsigned FilePos, bool *Invalid = 0) const;
   unsigned getSpellingLineNumber(SourceLocation Loc, bool *Invalid = 0) const;
   unsigned getExpansionLineNumber(SourceLocation Loc, bool *Invalid = 0) const;
@@ -527,6 +527,10 @@ public:
   /// Create the AST context.
   void createASTContext();
 
+  /// Create the ASTReader that reads module files, and attach it to the AST
+  /// context as its external source.
+  void createPCModuleManager();
+
   /// Create an external AST source to read a PCH file and attach it to the AST
   /// context.
   void createPCHExternalASTSource(StringRef Path,
@@ -649,6 +653,18 @@ public:
                                       PCModuleIdPath Path,
                                       PCModule::NameVisibilityKind Visibility,
                                       bool IsInclusionDirective);
+
+  virtual bool loadFortranModule(SourceLocation UseLoc, IdentifierInfo *Name);
+
+  virtual bool loadFortranSubmoduleFile(SourceLocation Loc, StringRef Name);
+
+private:
+  /// Read the Fortran module or submodule file \p File, on behalf of the
+  /// module or submodule \p Name.
+  ///
+  /// \returns true if the file was read without errors.
+  bool readFortranModuleFile(const FileEntry *File, SourceLocation Loc,
+                             StringRef Name);
 };
 
 } // end namespace lfort
@@ -209,6 +209,16 @@ protected:
 
   virtual bool hasPCHSupport() const { return true; }
 };
+
+/// \brief Lists the module files a source file provides and requires, and
+/// the files it includes, without parsing it.
+///
+/// Build systems use this to order compiles that produce and consume
+/// Fortran module files before running any of them.
+class ScanModuleDepsAction : public PreprocessorFrontendAction {
+protected:
+  void ExecuteAction();
+};
   
 }  // end namespace lfort
 
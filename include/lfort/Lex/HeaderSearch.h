@@ -197,6 +197,17 @@ class HeaderSearch {
   /// \brief Uniqued set of framework names, which is used to track which 
   /// headers were included as framework headers.
   llvm::StringSet<llvm::BumpPtrAllocator> FrameworkNames;
+
+  /// \brief Fortran module and submodule files found so far, keyed by
+  /// lowercase file name.  A null entry records a file that is not on the
+  /// path.
+  llvm::StringMap<const FileEntry *, llvm::BumpPtrAllocator>
+    FortranModuleFiles;
+
+  /// \brief The absolute path of each directory whose module file index has
+  /// been checked against the directory's modification time.  An empty path
+  /// marks a directory that could not be indexed.
+  llvm::DenseMap<const DirectoryEntry *, std::string> FortranModuleDirs;
   
   /// \brief Entity used to resolve the identifier IDs of controlling
   /// macros into IdentifierInfo pointers, as needed.
@@ -209,6 +220,11 @@ class HeaderSearch {
   unsigned NumIncluded;
   unsigned NumMultiIncludeFileOptzn;
   unsigned NumFrameworkLookups, NumSubFrameworkLookups;
+  unsigned NumFortranModuleLookups;
+
+  /// \brief Look up a Fortran module or submodule file by its lowercase
+  /// file name.
+  const FileEntry *lookupFortranModuleFileNamed(StringRef LowerFileName);
 
   // HeaderSearch doesn't support default or copy construction.
   HeaderSearch(const HeaderSearch&) LLVM_DELETED_FUNCTION;
@@ -319,6 +335,32 @@ public:
   /// already known.
   void setTarget(const TargetInfo &Target);
   
+  /// \brief Look up the module file for the Fortran module \p ModuleName.
+  ///
+  /// The current directory is searched first, then each directory of the
+  /// include search path, then the module path (-J).  Module names are
+  /// case-insensitive.  Each directory is read once into an index of the
+  /// ".mod" and ".smod" files it contains; indexes are shared by every
+  /// HeaderSearch in the process and rebuilt when the directory's
+  /// modification time changes.
+  ///
+  /// \returns the module file, or null if there is none.
+  const FileEntry *lookupFortranModuleFile(StringRef ModuleName) {
+    return lookupFortranModuleFileNamed(ModuleName.lower() + ".mod");
+  }
+
+  /// \brief Look up the submodule file that the descendants of a Fortran
+  /// module or submodule are compiled against, searching the same
+  /// directories as \c lookupFortranModuleFile().
+  ///
+  /// \param Name The name of the module, or "module@submodule" for a
+  /// submodule.
+  ///
+  /// \returns the submodule file, or null if there is none.
+  const FileEntry *lookupFortranSubmoduleFile(StringRef Name) {
+    return lookupFortranModuleFileNamed(Name.lower() + ".smod");
+  }
+
   /// \brief Given a "foo" or \<foo> reference, look up the indicated file,
   /// return null on failure.
   ///
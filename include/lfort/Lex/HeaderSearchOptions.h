@@ -98,6 +98,10 @@ public:
 
   /// \brief The directory used for the module cache.
   std::string PCModuleCachePath;
+
+  /// \brief The directory Fortran module files are written to, and searched
+  /// for them after the include search path (-J).
+  std::string FortranModulePath;
   
   /// \brief Whether we should disable the use of the hash string within the
   /// module cache.
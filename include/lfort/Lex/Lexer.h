@@ -39,6 +39,83 @@ enum ConflictMarkerKind {
   CMK_Perforce
 };
 
+/// FixedFormCard - The classification of one fixed-form source line ("card"),
+/// computed in one go from its first 72 columns by Lexer::ScanFixedFormCard.
+struct FixedFormCard {
+  enum CardKind {
+    /// The initial line of a statement.
+    Statement,
+    /// A line with a continuation character in column 6.
+    Continuation,
+    /// A comment line.  BodyStart points at the comment character.
+    Comment,
+    /// A preprocessor directive, to be lexed from the start of the line.
+    Directive
+  };
+
+  CardKind Kind;
+
+  /// HasLabel - True if columns 1 to 5 hold a statement label.
+  bool HasLabel;
+
+  /// Label - The value of the statement label, if HasLabel is set.
+  unsigned Label;
+
+  /// BodyStart - The first character of the statement body: column 7, or the
+  /// end of the line for short lines.
+  const char *BodyStart;
+
+  /// BodyEnd - Column 73, if the line extends past column 72 and the rest of
+  /// it must be ignored, otherwise null.
+  const char *BodyEnd;
+};
+
+/// NumericLiteralScan - The classification of a Fortran numeric constant,
+/// worked out by the lexer in the same pass that finds the end of the token.
+/// The preprocessor keeps the most recent ones so that NumericLiteralParser
+/// does not have to scan the spelling again.
+struct NumericLiteralScan {
+  enum ScanKind {
+    /// digit-string [_ kind-param]
+    Integer,
+    /// A real constant, with a period, an exponent or both.
+    Real,
+    /// B'...', O'...' or Z'...' (or with double quotes).
+    BOZ
+  };
+
+  /// TokStart - The spelling the scan describes; null for an unused entry.
+  const char *TokStart;
+
+  /// Length - The length of the token.
+  unsigned Length;
+
+  ScanKind Kind;
+
+  /// Radix - 10, or 2, 8 or 16 for BOZ constants.
+  unsigned Radix;
+
+  /// DigitsBegin/DigitsEnd - The offsets of the digits: the whole significand
+  /// and exponent of a real, the text between the quotes of a BOZ constant.
+  unsigned DigitsBegin, DigitsEnd;
+
+  /// KindBegin - The offset of the '_' that starts the kind parameter, or
+  /// Length if there is none.
+  unsigned KindBegin;
+
+  /// ExponentLetter - 'e', 'd' or 'q' if a real has an exponent, else 0.
+  char ExponentLetter;
+
+  /// HasPeriod - True if a real has a decimal point.
+  bool HasPeriod;
+
+  /// HasValue - True if Value holds the value of an Integer or BOZ constant,
+  /// false if it did not fit in 64 bits.
+  bool HasValue;
+
+  uint64_t Value;
+};
+
 /// Lexer - This provides a simple interface that turns a text buffer into a
 /// stream of tokens.  This provides no support for file reading or buffering,
 /// or buffering/seeking of tokens, only forward lexing is supported.  It relies
@@ -83,6 +160,49 @@ class Lexer : public PreprocessorLexer {
   // CurrentConflictMarkerState - The kind of conflict marker we are handling.
   ConflictMarkerKind CurrentConflictMarkerState;
 
+  // FixedFormBodyEnd - In fixed-form mode, column 73 of the current line if
+  // the line is longer than 72 columns, otherwise null.  Everything from here
+  // to the end of the line is ignored.
+  const char *FixedFormBodyEnd;
+
+  // Continued statements can be lexed out of a "logical line": a copy of the
+  // statement with its continuation lines joined together, so that no token
+  // has to deal with continuations.  See EnterLogicalLine.
+
+  /// LogicalLineSegment - A run of the logical line that was copied verbatim
+  /// from one place in the file.
+  struct LogicalLineSegment {
+    unsigned ViewOffset;   // Offset of the run in the logical line.
+    unsigned FileOffset;   // Offset of the run in the file buffer.
+  };
+
+  // LogicalLineSegments - The remap table for the current logical line,
+  // sorted by offset.  Every segment after the first starts a continuation
+  // line.
+  SmallVector<LogicalLineSegment, 8> LogicalLineSegments;
+
+  // InLogicalLine - True while BufferStart/BufferEnd describe a logical line
+  // rather than the file buffer.
+  bool InLogicalLine;
+
+  // NextLogicalLineSegment - The first segment whose first token has not
+  // been lexed yet.
+  unsigned NextLogicalLineSegment;
+
+  // FileBufferStart/FileBufferEnd - The file buffer, while lexing a logical
+  // line.
+  const char *FileBufferStart;
+  const char *FileBufferEnd;
+
+  // LogicalLineResumePtr - Where to pick up in the file buffer once the
+  // logical line has been lexed, and the value of FixedFormBodyEnd there.
+  const char *LogicalLineResumePtr;
+  const char *LogicalLineResumeBodyEnd;
+
+  // LogicalLineCheckedUpTo - The end of the last line which is known not to
+  // start a continued statement, so that it isn't scanned twice.
+  const char *LogicalLineCheckedUpTo;
+
   Lexer(const Lexer &) LLVM_DELETED_FUNCTION;
   void operator=(const Lexer &) LLVM_DELETED_FUNCTION;
   friend class Preprocessor;
@@ -552,6 +672,7 @@ private:
   // Helper functions to lex the remainder of a token of the specific type.
   void LexIdentifier         (Token &Result, const char *CurPtr);
   void LexNumericConstant    (Token &Result, const char *CurPtr);
+  bool LexFortranNumericConstant(Token &Result);
   void LexFortranIntConstant (Token &Result, const char *CurPtr);
   void LexStringLiteral      (Token &Result, const char *CurPtr,
                               tok::TokenKind Kind);
@@ -567,6 +688,12 @@ private:
   bool SkipBlockComment      (Token &Result, const char *CurPtr);
   bool SaveLineComment       (Token &Result, const char *CurPtr);
   
+  static FixedFormCard ScanFixedFormCard(const char *Line,
+                                         const char *BufferEnd);
+
+  bool EnterLogicalLine(const char *CurPtr);
+  void ExitLogicalLine();
+
   bool IsStartOfConflictMarker(const char *CurPtr);
   bool HandleEndOfConflictMarker(const char *CurPtr);
 
@@ -48,10 +48,25 @@ class NumericLiteralParser {
 
   bool saw_exponent, saw_period, saw_ud_suffix;
 
+  /// ExponentLetter - 'e', 'd' or 'q' if the constant has a Fortran exponent.
+  char ExponentLetter;
+
+  /// KindParamBegin - The '_' that starts a Fortran kind parameter, or
+  /// ThisTokEnd if there is none.
+  const char *KindParamBegin;
+
+  /// CachedValue - The value of an integer constant, as computed by the lexer,
+  /// if HasCachedValue is set.
+  uint64_t CachedValue;
+  bool HasCachedValue;
+
 public:
+  /// \p InPPDirective selects the C rules for a constant in a preprocessor
+  /// expression, where a leading zero still means octal.
   NumericLiteralParser(StringRef TokSpelling,
                        SourceLocation TokLoc,
-                       Preprocessor &PP);
+                       Preprocessor &PP,
+                       bool InPPDirective = false);
   bool hadError;
   bool isUnsigned;
   bool isLong;        // This is *not* set for long long.
@@ -74,6 +89,20 @@ public:
     assert(saw_ud_suffix);
     return StringRef(SuffixBegin, ThisTokEnd - SuffixBegin);
   }
+
+  /// hasKindParam - True if the constant ends in a Fortran kind parameter,
+  /// as in 1.0_dp or 42_8.
+  bool hasKindParam() const {
+    return KindParamBegin != ThisTokEnd;
+  }
+  StringRef getKindParam() const {
+    assert(hasKindParam());
+    return StringRef(KindParamBegin + 1, ThisTokEnd - KindParamBegin - 1);
+  }
+
+  /// getExponentLetter - Return 'e', 'd' or 'q' for a real constant with an
+  /// exponent (in any case), or 0.
+  char getExponentLetter() const { return ExponentLetter; }
   unsigned getUDSuffixOffset() const {
     assert(saw_ud_suffix);
     return SuffixBegin - ThisTokBegin;
@@ -98,6 +127,8 @@ private:
 
   void ParseNumberStartingWithZero(SourceLocation TokLoc);
 
+  void ParseBOZConstant(SourceLocation TokLoc);
+
   /// SkipHexDigits - Read and skip over any hex digits, up to End.
   /// Return a pointer to the first non-hex digit or End.
   const char *SkipHexDigits(const char *ptr) {
@@ -80,6 +80,39 @@ public:
                                       PCModuleIdPath Path,
                                       PCModule::NameVisibilityKind Visibility,
                                       bool IsInclusionDirective) = 0;
+
+  /// \brief Attempt to read the module file of a Fortran module.
+  ///
+  /// The declarations in the module file are deserialized lazily, as name
+  /// lookup finds them.
+  ///
+  /// \param UseLoc The location of the module name in the USE statement.
+  ///
+  /// \param Name The name of the Fortran module.
+  ///
+  /// \returns true if a module file for the module was found.  A module
+  /// file that was found but could not be read has been diagnosed.
+  virtual bool loadFortranModule(SourceLocation UseLoc, IdentifierInfo *Name) {
+    return false;
+  }
+
+  /// \brief Attempt to read the submodule file of a Fortran module or
+  /// submodule, which its descendant submodules are compiled against.
+  ///
+  /// Unlike a module file, a submodule file leaves the private entities of
+  /// the module visible.
+  ///
+  /// \param Loc The location of the parent-identifier in the SUBMODULE
+  /// statement.
+  ///
+  /// \param Name The name of the module, or "module@submodule" for a
+  /// submodule.
+  ///
+  /// \returns true if the submodule file was found.  A file that was found
+  /// but could not be read has been diagnosed.
+  virtual bool loadFortranSubmoduleFile(SourceLocation Loc, StringRef Name) {
+    return false;
+  }
 };
   
 }
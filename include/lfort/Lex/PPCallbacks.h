@@ -141,6 +141,24 @@ public:
                             const PCModule *Imported) {
   }
 
+  /// \brief Callback invoked when the interface of a Fortran module becomes
+  /// known, either because the main file defines the module or because the
+  /// module file was read for a USE statement.
+  ///
+  /// \param Loc The location of the module name.
+  ///
+  /// \param Name The name of the module.
+  ///
+  /// \param File The module file that was read, or null if the main file
+  /// defines the module.
+  ///
+  /// \param InterfaceHash A hash of the module's public interface, which
+  /// only changes when the programs that use the module must be recompiled.
+  virtual void FortranModuleInterface(SourceLocation Loc, StringRef Name,
+                                      const FileEntry *File,
+                                      uint64_t InterfaceHash) {
+  }
+
   /// \brief Callback invoked when the end of the main file is reached.
   ///
   /// No subsequent callbacks will be made.
@@ -312,6 +330,13 @@ public:
     Second->moduleImport(ImportLoc, Path, Imported);
   }
 
+  virtual void FortranModuleInterface(SourceLocation Loc, StringRef Name,
+                                      const FileEntry *File,
+                                      uint64_t InterfaceHash) {
+    First->FortranModuleInterface(Loc, Name, File, InterfaceHash);
+    Second->FortranModuleInterface(Loc, Name, File, InterfaceHash);
+  }
+
   virtual void EndOfMainFile() {
     First->EndOfMainFile();
     Second->EndOfMainFile();
@@ -100,7 +100,7 @@ class PTHManager : public IdentifierInfoLookup {
 
 public:
   // The current PTH version.
-  enum { Version = 10 };
+  enum { Version = 12 };
 
   ~PTHManager();
 
@@ -116,6 +116,12 @@ public:
   ///  be found.
   IdentifierInfo *get(StringRef Name);
 
+  /// getContentKey - Compute the key under which the tokens of a file with
+  ///  the given contents are cached.  This lets a Fortran INCLUDE file be
+  ///  found in the PTH file when it is reached through a different path.
+  static void getContentKey(StringRef Buffer, bool FreeForm,
+                            SmallVectorImpl<char> &Key);
+
   /// Create - This method creates PTHManager objects.  The 'file' argument
   ///  is the name of the PTH file.  This method returns NULL upon failure.
   static PTHManager *Create(const std::string& file, DiagnosticsEngine &Diags);
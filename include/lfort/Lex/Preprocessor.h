@@ -381,6 +381,17 @@ private:  // Cached tokens state.
   /// invoked (at which point the last position is popped).
   std::vector<CachedTokensTy::size_type> BacktrackPositions;
 
+  /// NumericLiteralCache - The numeric constants most recently classified by
+  /// the lexer, indexed by the address of their spelling.  The parser asks
+  /// for a constant shortly after it is lexed, so a small direct-mapped table
+  /// is enough to spare NumericLiteralParser a second scan.
+  enum { NumericLiteralCacheSize = 64 };
+  NumericLiteralScan NumericLiteralCache[NumericLiteralCacheSize];
+
+  static unsigned getNumericLiteralCacheIndex(const char *TokStart) {
+    return (unsigned) (uintptr_t) TokStart % NumericLiteralCacheSize;
+  }
+
   struct MacroInfoChain {
     MacroInfo MI;
     MacroInfoChain *Next;
@@ -975,6 +986,22 @@ public:
     return *SourceMgr.getCharacterData(Tok.getLocation(), Invalid);
   }
 
+  /// cacheNumericLiteral - Remember how the lexer classified a numeric
+  /// constant.
+  void cacheNumericLiteral(const NumericLiteralScan &Scan) {
+    NumericLiteralCache[getNumericLiteralCacheIndex(Scan.TokStart)] = Scan;
+  }
+
+  /// getCachedNumericLiteral - Return how the lexer classified the numeric
+  /// constant spelled by \p Spelling, or null if that has been forgotten.
+  const NumericLiteralScan *getCachedNumericLiteral(StringRef Spelling) const {
+    const NumericLiteralScan &Scan =
+      NumericLiteralCache[getNumericLiteralCacheIndex(Spelling.data())];
+    if (Scan.TokStart != Spelling.data() || Scan.Length != Spelling.size())
+      return 0;
+    return &Scan;
+  }
+
   /// \brief Retrieve the name of the immediate macro expansion.
   ///
   /// This routine starts from a source location, and finds the name of the macro
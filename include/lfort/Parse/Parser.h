@@ -167,6 +167,11 @@ class Parser : public CodeCompletionHandler {
   /// should not be set directly.
   bool InMessageExpression;
 
+  /// \brief Set while parsing the type of an implicit-spec whose type keyword
+  /// is directly followed by the letter-spec list, whose parenthesis must not
+  /// be taken for a kind or char selector.
+  bool ParenIsImplicitLetterSpecList;
+
   /// The "depth" of the template parameters currently being parsed.
   unsigned TemplateParameterDepth;
 
@@ -195,6 +200,8 @@ public:
   Parser(Preprocessor &PP, Sema &Actions, bool SkipSubprogramBodies);
   ~Parser();
 
+  void PrintStats() const;
+
   const LangOptions &getLangOpts() const { return PP.getLangOpts(); }
   const TargetInfo &getTargetInfo() const { return PP.getTargetInfo(); }
   Preprocessor &getPreprocessor() const { return PP; }
@@ -1048,24 +1055,38 @@ private:
     SourceRange getSourceRange() const LLVM_READONLY;
   };
 
-  /// \brief Contains a late templated function.
-  /// Will be parsed at the end of the translation unit.
+  /// \brief Contains a late templated function, or a program unit whose body
+  /// was skipped.
+  /// Will be parsed at the end of the translation unit, or on demand.
   struct LateParsedTemplatedSubprogram {
-    explicit LateParsedTemplatedSubprogram(Decl *MD)
-      : D(MD) {}
+    explicit LateParsedTemplatedSubprogram(Decl *MD, bool IsFortranBody = false)
+      : D(MD), IsFortranBody(IsFortranBody) {}
 
     CachedTokens Toks;
 
     /// \brief The template function declaration to be late parsed.
     Decl *D;
+
+    /// \brief Whether Toks holds the body of a Fortran program unit, ending
+    /// with the first token of its end statement.
+    bool IsFortranBody;
   };
 
   void LexTemplateSubprogramForLateParsing(CachedTokens &Toks);
   void ParseLateTemplatedFuncDef(LateParsedTemplatedSubprogram &LMT);
+  bool isEndOfMainProgram();
+  bool ConsumeAndStoreMainProgramBody(CachedTokens &Toks);
+  bool tryLexMainProgramBodyForLateParsing(CachedTokens &Toks);
+  void ParseLateFortranBody(LateParsedTemplatedSubprogram &LPT);
+  void ParseSkippedFortranBodies();
   typedef llvm::DenseMap<const SubprogramDecl*, LateParsedTemplatedSubprogram*>
     LateParsedTemplateMapT;
   LateParsedTemplateMapT LateParsedTemplateMap;
 
+  /// \brief The program units whose bodies were skipped, in the order they
+  /// appear in the source.
+  SmallVector<SubprogramDecl *, 4> SkippedFortranBodies;
+
   static void LateTemplateParserCallback(void *P, const SubprogramDecl *FD);
   void LateTemplateParser(const SubprogramDecl *FD);
 
@@ -1455,6 +1476,21 @@ private:
   /// A SmallVector of types.
   typedef SmallVector<ParsedType, 12> TypeVector;
 
+  /// \brief The statements of the blocks being parsed, innermost block last.
+  ///
+  /// Nested blocks share this stack, so parsing an execution part does not
+  /// build a statement list per block; each finished block is copied once
+  /// into the ASTContext.
+  StmtVector BlockStmts;
+
+  /// \brief The number of statements parsed into blocks, and the number of
+  /// times BlockStmts had to grow to hold them, for -print-stats.
+  unsigned NumBlockStmts, NumBlockStmtsGrowths;
+
+  /// \brief The number of times a statement list of each block's own would
+  /// have had to grow, for comparison with NumBlockStmtsGrowths.
+  unsigned NumPerBlockStmtsGrowths;
+
   StmtResult ParseStatement(SourceLocation *TrailingElseLoc = 0) {
     StmtVector Stmts;
     return ParseStatementOrDeclaration(Stmts, true, TrailingElseLoc);
@@ -2219,11 +2255,22 @@ public:
   DeclGroupPtrTy ParseSubmodule();
   DeclGroupPtrTy ParseBlockData();
   DeclGroupPtrTy ParseModule();
+  void ParseModuleBody(IdentifierInfo *Name, bool IsSubmodule);
+  void ParseEndModuleStmt(IdentifierInfo *Name, bool IsSubmodule);
+  void ParseAccessStmt();
+  void SkipToEndModule();
 
   DeclGroupPtrTy ParseImportStmt();
   DeclGroupPtrTy ParseImplicit();
+  bool isImplicitLetterSpecListNext();
+  bool ParseImplicitLetterSpecList(
+    SmallVectorImpl<Sema::FortranLetterSpec> &Letters);
 
   StmtResult ParseBlock();
+  StmtResult ParseDoConcurrentConstruct();
+  bool ParseConcurrentHeader(BalancedDelimiterTracker &T,
+                             SmallVectorImpl<VarDecl *> &Indices,
+                             ExprVector &Limits, ExprResult &Mask);
   StmtResult ParseExecOrSpecPartConstruct(StmtVector &Stmts,
              bool ExecOnly = false, bool ActionOnly = false);
   StmtResult ParseExecPartConstruct() {
@@ -2244,10 +2291,20 @@ public:
                 unsigned Context, bool AllowSubprogramDefinitions,
                 SourceLocation *DeclEnd = 0, ForRangeInit *FRI = 0);
   void ParseEntityDecl(Declarator &D);
+  void ParseArraySpec(Declarator &D);
 
   StmtResult ParseExprStatement();
   StmtResult ParseIfStatement();
 
+  /// \brief Returns true if the type keyword at the current token is
+  /// followed by a kind or char selector.
+  bool isTypeSelectorNext() {
+    if (NextToken().isInLine(tok::star))
+      return true;
+    return NextToken().isInLine(tok::l_paren) &&
+           !ParenIsImplicitLetterSpecList;
+  }
+
   void ParseDeclarationTypeSpec(DeclSpec &DS,
                 llvm::SmallVector<DeclaratorChunk, 4> &DeclaratorChunks,
                 const ParsedTemplateInfo &TemplateInfo = ParsedTemplateInfo(),
@@ -171,6 +171,15 @@ public:
                  SmallVectorImpl<std::pair<ValueDecl *, 
                                            SourceLocation> > &Pending) {}
 
+  /// \brief Retrieve the interface hash of the Fortran module \p Name, if the
+  /// external source read it from a module file.
+  ///
+  /// \returns true if the hash is known.
+  virtual bool getFortranModuleInterfaceHash(StringRef Name,
+                                             uint64_t &InterfaceHash) const {
+    return false;
+  }
+
   // isa/cast/dyn_cast support
   static bool classof(const ExternalASTSource *Source) {
     return Source->SemaSource;
@@ -0,0 +1,100 @@
+//===--- GenericResolutionCache.h - Resolved generic calls ------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+//  This file defines the GenericResolutionCache class, which remembers the
+//  specific procedure that calls to a Fortran generic name resolved to.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_LFORT_SEMA_GENERICRESOLUTIONCACHE_H
+#define LLVM_LFORT_SEMA_GENERICRESOLUTIONCACHE_H
+
+#include "lfort/AST/DeclarationName.h"
+#include "lfort/Basic/Specifiers.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/FoldingSet.h"
+#include "llvm/Support/Allocator.h"
+
+namespace lfort {
+
+class NamedDecl;
+class SubprogramDecl;
+
+/// \brief A cache of the resolutions of calls to generic names.
+///
+/// A key is started with addGenericName(), which adds the name and the
+/// number of times the generic has been extended since its first lookup.
+/// The caller then adds the specifics in scope and the type, kind and rank
+/// of the actual arguments.  Extending a generic with noteSpecificDeclared()
+/// changes the keys of all later calls to it, so the resolutions recorded
+/// before are never found again.
+class GenericResolutionCache {
+public:
+  /// Resolution - The specific procedure that calls to a generic resolved
+  /// to, for one set of specifics in scope and one signature of actual
+  /// arguments.
+  class Resolution : public llvm::FastFoldingSetNode {
+    SubprogramDecl *Specific;
+    NamedDecl *FoundDecl;
+    AccessSpecifier FoundAccess;
+
+  public:
+    Resolution(const llvm::FoldingSetNodeID &ID, SubprogramDecl *Specific,
+               NamedDecl *FoundDecl, AccessSpecifier FoundAccess)
+      : FastFoldingSetNode(ID), Specific(Specific), FoundDecl(FoundDecl),
+        FoundAccess(FoundAccess) {}
+
+    SubprogramDecl *getSpecific() const { return Specific; }
+    NamedDecl *getFoundDecl() const { return FoundDecl; }
+    AccessSpecifier getFoundAccess() const { return FoundAccess; }
+  };
+
+private:
+  llvm::BumpPtrAllocator Allocator;
+  llvm::FoldingSet<Resolution> Resolutions;
+
+  /// \brief The number of times each generic name that has been looked up
+  /// has since been extended with another specific.
+  llvm::DenseMap<DeclarationName, unsigned> Extensions;
+
+public:
+  /// \brief Starts the key of a call to the generic \p Name.
+  void addGenericName(llvm::FoldingSetNodeID &ID, DeclarationName Name) {
+    ID.AddPointer(Name.getAsOpaquePtr());
+    ID.AddInteger(Extensions[Name]);
+  }
+
+  /// \brief Returns the resolution recorded under \p ID, if any.
+  Resolution *lookup(const llvm::FoldingSetNodeID &ID) {
+    void *InsertPos;
+    return Resolutions.FindNodeOrInsertPos(ID, InsertPos);
+  }
+
+  /// \brief Records that calls with key \p ID resolve to \p Specific, found
+  /// as \p FoundDecl with access \p FoundAccess.
+  void insert(const llvm::FoldingSetNodeID &ID, SubprogramDecl *Specific,
+              NamedDecl *FoundDecl, AccessSpecifier FoundAccess) {
+    Resolution *R = Allocator.Allocate<Resolution>();
+    R = new (R) Resolution(ID, Specific, FoundDecl, FoundAccess);
+    Resolutions.GetOrInsertNode(R);
+  }
+
+  /// \brief Notes that a subprogram named \p Name was declared, which may
+  /// extend the generic of that name.
+  void noteSpecificDeclared(DeclarationName Name) {
+    llvm::DenseMap<DeclarationName, unsigned>::iterator Known
+      = Extensions.find(Name);
+    if (Known != Extensions.end())
+      ++Known->second;
+  }
+};
+
+}  // end namespace lfort
+
+#endif
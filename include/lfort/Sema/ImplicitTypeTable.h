@@ -0,0 +1,97 @@
+//===--- ImplicitTypeTable.h - Fortran implicit typing rules ----*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+//  This file defines the ImplicitTypeTable class, which maps the initial
+//  letter of a name to the type that the IMPLICIT statements of a Fortran
+//  scoping unit give it.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_LFORT_SEMA_IMPLICITTYPETABLE_H
+#define LLVM_LFORT_SEMA_IMPLICITTYPETABLE_H
+
+#include "lfort/AST/Type.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/DataTypes.h"
+#include <algorithm>
+
+namespace lfort {
+
+/// \brief The implicit typing rules of a Fortran scoping unit.
+///
+/// Each letter maps directly to the type of the entities whose names begin
+/// with it, so an implicit type is resolved with a single array access.  A
+/// null type means the letter has no implicit type, as after IMPLICIT NONE.
+///
+/// A scoping unit shares the table of its host until its own IMPLICIT
+/// statements change it, at which point it gets a copy.
+class ImplicitTypeTable {
+public:
+  enum { NumLetters = 26 };
+
+private:
+  QualType Types[NumLetters];
+
+  /// \brief The letters that the IMPLICIT statements of the scoping unit
+  /// owning this table have given a type, one bit per letter.
+  uint32_t SpecifiedLetters;
+
+  /// \brief Whether the scoping unit owning this table has an IMPLICIT NONE
+  /// statement.
+  bool HasNone;
+
+public:
+  ImplicitTypeTable() : SpecifiedLetters(0), HasNone(false) { }
+
+  /// \brief Creates the table of a scoping unit from the rules of its host,
+  /// none of whose letters count as specified in the new scoping unit.
+  static ImplicitTypeTable inheritFrom(const ImplicitTypeTable &Host) {
+    ImplicitTypeTable Table;
+    std::copy(Host.Types, Host.Types + NumLetters, Table.Types);
+    return Table;
+  }
+
+  /// \brief Returns the index of \p Letter in the table, or -1 if it is not
+  /// a letter.
+  static int getLetterIndex(char Letter) {
+    if (Letter >= 'A' && Letter <= 'Z')
+      Letter += 'a' - 'A';
+    if (Letter < 'a' || Letter > 'z')
+      return -1;
+    return Letter - 'a';
+  }
+
+  /// \brief Returns the implicit type of the name \p Name, or a null type if
+  /// it has none.
+  QualType getType(StringRef Name) const {
+    int Index = Name.empty() ? -1 : getLetterIndex(Name[0]);
+    return Index < 0 ? QualType() : Types[Index];
+  }
+
+  /// \brief Gives the letter with index \p Index the implicit type \p T.
+  void setType(int Index, QualType T) {
+    Types[Index] = T;
+    SpecifiedLetters |= 1u << Index;
+  }
+
+  bool isSpecified(int Index) const {
+    return SpecifiedLetters & (1u << Index);
+  }
+  bool hasSpecifiedLetters() const { return SpecifiedLetters != 0; }
+
+  bool hasNone() const { return HasNone; }
+  void setNone() {
+    std::fill(Types, Types + NumLetters, QualType());
+    HasNone = true;
+  }
+};
+
+}  // end namespace lfort
+
+#endif
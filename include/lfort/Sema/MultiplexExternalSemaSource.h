@@ -355,6 +355,11 @@ public:
   virtual void ReadPendingInstantiations(
               SmallVectorImpl<std::pair<ValueDecl*, SourceLocation> >& Pending);
 
+  /// \brief Retrieve the interface hash of the Fortran module \p Name from
+  /// the first source that read it.
+  virtual bool getFortranModuleInterfaceHash(StringRef Name,
+                                             uint64_t &InterfaceHash) const;
+
   // isa/cast/dyn_cast support
   static bool classof(const MultiplexExternalSemaSource*) { return true; }
   //static bool classof(const ExternalSemaSource*) { return true; }
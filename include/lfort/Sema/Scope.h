@@ -15,12 +15,17 @@
 #define LLVM_LFORT_SEMA_SCOPE_H
 
 #include "lfort/Basic/Diagnostic.h"
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/TinyPtrVector.h"
 
 namespace lfort {
 
 class Decl;
+class IdentifierInfo;
+class ImplicitTypeTable;
+class NamedDecl;
 class UsingDirectiveDecl;
 
 /// Scope - A scope is a transient data structure that is used while parsing the
@@ -147,6 +152,18 @@ private:
   typedef SmallVector<UsingDirectiveDecl *, 2> UsingDirectivesTy;
   UsingDirectivesTy UsingDirectives;
 
+  /// UseAssociatedDecls - For a Fortran scoping unit with USE statements, the
+  /// entities of the USEd modules that each name has been looked up as.  An
+  /// empty entry records that no USEd module has the name, so every name is
+  /// searched for in the modules at most once.
+  typedef llvm::TinyPtrVector<NamedDecl *> UseAssociatedDeclsTy;
+  llvm::DenseMap<IdentifierInfo *, UseAssociatedDeclsTy> UseAssociatedDecls;
+
+  /// ImplicitTypes - The implicit typing rules in effect in this scope, which
+  /// are shared with the parent scope unless this scope is a Fortran scoping
+  /// unit with IMPLICIT statements.  Null means the default rules.
+  ImplicitTypeTable *ImplicitTypes;
+
   /// \brief Used to determine if errors occurred in this scope.
   DiagnosticErrorTrap ErrorTrap;
   
@@ -323,6 +340,28 @@ public:
     return UsingDirectives.end();
   }
 
+  /// \brief Returns the entities \p II was found to name by use association
+  /// in this scope, or null if it has not been looked up yet.
+  const UseAssociatedDeclsTy *getUseAssociatedDecls(IdentifierInfo *II) const {
+    llvm::DenseMap<IdentifierInfo *, UseAssociatedDeclsTy>::const_iterator Pos
+      = UseAssociatedDecls.find(II);
+    return Pos == UseAssociatedDecls.end() ? 0 : &Pos->second;
+  }
+
+  void setUseAssociatedDecls(IdentifierInfo *II,
+                             const UseAssociatedDeclsTy &Decls) {
+    UseAssociatedDecls[II] = Decls;
+  }
+
+  /// \brief Forgets the names looked up by use association, when a USE
+  /// statement makes more modules accessible in this scope.
+  void clearUseAssociatedDecls() {
+    UseAssociatedDecls.clear();
+  }
+
+  ImplicitTypeTable *getImplicitTypes() const { return ImplicitTypes; }
+  void setImplicitTypes(ImplicitTypeTable *Types) { ImplicitTypes = Types; }
+
   /// Init - This is used by the parser to implement scope caching.
   ///
   void Init(Scope *parent, unsigned flags);
@@ -108,6 +108,11 @@ public:
   /// optimization, or if we need to infer a return type.
   SmallVector<ReturnStmt*, 4> Returns;
 
+  /// \brief The variables of a Fortran subprogram that were declared by
+  /// their implicit type on first use, which are declared at the start of
+  /// its body once it has been parsed.
+  SmallVector<VarDecl*, 4> ImplicitlyTypedVars;
+
   /// \brief The stack of currently active compound stamement scopes in the
   /// function.
   SmallVector<CompoundScopeInfo, 4> CompoundScopes;
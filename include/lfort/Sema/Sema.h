@@ -33,6 +33,7 @@
 #include "lfort/Sema/AnalysisBasedWarnings.h"
 #include "lfort/Sema/DeclSpec.h"
 #include "lfort/Sema/ExternalSemaSource.h"
+#include "lfort/Sema/GenericResolutionCache.h"
 #include "lfort/Sema/IdentifierResolver.h"
 #include "lfort/Sema/LocInfoType.h"
 #include "lfort/Sema/ObjCMethodList.h"
@@ -105,6 +106,7 @@ namespace lfort {
   class SubprogramProtoType;
   class SubprogramTemplateDecl;
   class ImplicitConversionSequence;
+  class ImplicitTypeTable;
   class InitListExpr;
   class InitializationKind;
   class InitializationSequence;
@@ -386,6 +388,13 @@ public:
     OpaqueParser = P;
   }
 
+  /// \brief Parses the body of \p FD now, if its parsing was delayed while
+  /// subprogram bodies were being skipped.
+  void ParseLateParsedSubprogramBody(const SubprogramDecl *FD) {
+    if (FD->isLateTemplateParsed() && LateTemplateParser)
+      LateTemplateParser(OpaqueParser, FD);
+  }
+
   class DelayedDiagnostics;
 
   class DelayedDiagnosticsState {
@@ -711,6 +720,10 @@ public:
   /// for C++ records.
   llvm::FoldingSet<SpecialMemberOverloadResult> SpecialMemberCache;
 
+  /// \brief A cache of the resolutions of calls to generic names, keyed on
+  /// the specifics in scope and the type, kind and rank of the arguments.
+  GenericResolutionCache GenericResolutions;
+
   /// \brief The kind of translation unit we are processing.
   ///
   /// When we're processing a complete translation unit, Sema will perform
@@ -1405,6 +1418,8 @@ public:
   void CheckForSubprogramRedefinition(SubprogramDecl *FD);
   Decl *ActOnStartOfSubprogramDef(Scope *S, Declarator &D);
   Decl *ActOnStartOfSubprogramDef(Scope *S, Decl *D);
+  Decl *ActOnMainProgram(Scope *BodyScope, SourceLocation ProgramLoc,
+                         IdentifierInfo *Name, SourceLocation NameLoc);
   void ActOnStartOfObjCMethodDef(Scope *S, Decl *D);
   bool isObjCMethodDecl(Decl *D) {
     return D && isa<ObjCMethodDecl>(D);
@@ -1456,6 +1471,127 @@ public:
   DeclResult ActOnPCModuleImport(SourceLocation AtLoc, SourceLocation ImportLoc,
                                PCModuleIdPath Path);
 
+  /// \brief A name in the rename list or ONLY list of a USE statement.
+  struct FortranUseItem {
+    /// \brief The name by which the entity is known in the using scope.
+    IdentifierInfo *LocalName;
+    SourceLocation LocalNameLoc;
+    /// \brief The name of the entity in the module; the same as
+    /// \c LocalName unless the entity is renamed.
+    IdentifierInfo *UseName;
+    SourceLocation UseNameLoc;
+  };
+
+  /// \brief The parser has seen the module-stmt of a Fortran module.
+  ///
+  /// A Fortran module is represented as a namespace at program scope, which
+  /// becomes the current declaration context.
+  Decl *ActOnStartOfFortranModule(Scope *S, SourceLocation ModuleLoc,
+                                  IdentifierInfo *Name,
+                                  SourceLocation NameLoc);
+
+  /// \brief The parser has seen the end-module-stmt of the module \p Module.
+  Decl *ActOnFinishFortranModule(Decl *Module, SourceLocation EndLoc);
+
+  /// \brief The parser has seen the submodule-stmt of a Fortran submodule.
+  ///
+  /// A submodule is represented as a namespace at program scope named
+  /// "ancestor@submodule", which no Fortran name can clash with.  A using
+  /// directive nominating the parent module or submodule provides host
+  /// association; when the parent is not defined in this program, its
+  /// submodule file is read, so that its private entities are visible too.
+  ///
+  /// \param ParentName The parent submodule, or null if the parent is the
+  /// ancestor module.
+  Decl *ActOnStartOfFortranSubmodule(Scope *S, SourceLocation SubmoduleLoc,
+                                     IdentifierInfo *AncestorName,
+                                     SourceLocation AncestorLoc,
+                                     IdentifierInfo *ParentName,
+                                     SourceLocation ParentLoc,
+                                     IdentifierInfo *Name,
+                                     SourceLocation NameLoc);
+
+  /// \brief The parser has seen the end-submodule-stmt of the submodule
+  /// \p Submodule.
+  Decl *ActOnFinishFortranSubmodule(Decl *Submodule, SourceLocation EndLoc);
+
+  /// \brief The parser has processed a PUBLIC or PRIVATE statement in the
+  /// specification part of a module.  An empty \p Names sets the default
+  /// accessibility of the module's entities.
+  void ActOnFortranAccessStmt(Scope *S, SourceLocation AccessLoc,
+                              bool IsPrivate,
+                              ArrayRef<IdentifierLocPair> Names);
+
+  /// \brief The parser has processed a USE statement.
+  ///
+  /// Without an ONLY list, the module's public entities become visible
+  /// through a using directive.  Each entity in an ONLY or rename list gets
+  /// a using declaration, whose shadow declaration carries the local name.
+  /// Either way, entities are only read from the module file when a lookup
+  /// finds them.
+  DeclGroupPtrTy ActOnFortranUseStmt(Scope *S, SourceLocation UseLoc,
+                                     IdentifierInfo *ModuleName,
+                                     SourceLocation ModuleNameLoc,
+                                     bool IsIntrinsic, bool HasOnly,
+                                     ArrayRef<FortranUseItem> Items);
+
+  /// \brief A letter-spec of an IMPLICIT statement, such as A-H.
+  struct FortranLetterSpec {
+    char First, Last;
+    SourceLocation Loc;
+  };
+
+  /// \brief The parser has processed an implicit-spec of an IMPLICIT
+  /// statement, which gives the type \p Ty to the entities of the scoping
+  /// unit whose names begin with one of \p Letters.
+  void ActOnFortranImplicitSpec(Scope *S, SourceLocation ImplicitLoc,
+                                ParsedType Ty,
+                                ArrayRef<FortranLetterSpec> Letters);
+
+  /// \brief The parser has processed an IMPLICIT NONE statement.
+  void ActOnFortranImplicitNone(Scope *S, SourceLocation ImplicitLoc);
+
+  /// \brief Returns the type that the implicit typing rules in effect in
+  /// \p S give the name \p II, or a null type if they give it none.
+  QualType getFortranImplicitType(Scope *S, IdentifierInfo *II);
+
+  /// \brief The implicit typing rules of scoping units without IMPLICIT
+  /// statements in any host: I to N are integer, other letters real.
+  ImplicitTypeTable &getFortranDefaultImplicitTypes();
+  ImplicitTypeTable *FortranDefaultImplicitTypes;
+
+  /// \brief Find the namespace of the Fortran module \p Name, reading its
+  /// module file if the module is not defined in this program.
+  NamespaceDecl *LookupFortranModule(IdentifierInfo *Name, SourceLocation Loc,
+                                     bool IsIntrinsic);
+
+  /// \brief The Fortran modules defined by this program, in the order in
+  /// which they appear.
+  SmallVector<NamespaceDecl *, 4> FortranModules;
+
+  /// \brief The Fortran submodules defined by this program, in the order in
+  /// which they appear.
+  SmallVector<NamespaceDecl *, 4> FortranSubmodules;
+
+  /// \brief The hash of the public interface of each Fortran module defined
+  /// by this program, which is stored in its module file.
+  llvm::DenseMap<const NamespaceDecl *, uint64_t> FortranModuleInterfaceHashes;
+
+  /// \brief The accessibility given by the PUBLIC and PRIVATE statements of
+  /// the module being parsed.
+  struct FortranModuleAccessInfo {
+    FortranModuleAccessInfo() : DefaultPrivate(false) { }
+
+    /// \brief The location of the access statement without a list, if any.
+    SourceLocation DefaultLoc;
+    bool DefaultPrivate;
+
+    /// \brief The names listed in access statements, and whether each was
+    /// made private.
+    SmallVector<std::pair<IdentifierLocPair, bool>, 8> Names;
+  };
+  FortranModuleAccessInfo CurFortranModuleAccess;
+
   /// \brief Retrieve a suitable printing policy.
   PrintingPolicy getPrintingPolicy() const {
     return getPrintingPolicy(Context, PP);
@@ -2202,6 +2338,7 @@ public:
 
 private:
   bool CppLookupName(LookupResult &R, Scope *S);
+  bool FortranLookupName(LookupResult &R, Scope *S);
 
   // \brief The set of known/encountered (unique, canonicalized) NamespaceDecls.
   //
@@ -2297,8 +2434,12 @@ public:
   NamedDecl *LazilyCreateBuiltin(IdentifierInfo *II, unsigned ID,
                                  Scope *S, bool ForRedeclaration,
                                  SourceLocation Loc);
+  NamedDecl *LazilyCreateFortranIntrinsic(IdentifierInfo *II,
+                                          SourceLocation Loc);
   NamedDecl *ImplicitlyDefineSubprogram(SourceLocation Loc, IdentifierInfo &II,
                                       Scope *S);
+  VarDecl *ImplicitlyDeclareFortranVariable(SourceLocation Loc,
+                                            IdentifierInfo &II, Scope *S);
   void AddKnownSubprogramAttributes(SubprogramDecl *FD);
 
   // More parsing and symbol table subroutines.
@@ -2622,6 +2763,14 @@ public:
                           FullExprArg Third,
                           SourceLocation RParenLoc,
                           Stmt *Body);
+  VarDecl *ActOnDoConcurrentIndex(Scope *S, IdentifierInfo *Name,
+                                  SourceLocation NameLoc, ParsedType Ty);
+  StmtResult ActOnDoConcurrentStmt(SourceLocation DoLoc,
+                                   SourceLocation LParenLoc,
+                                   ArrayRef<VarDecl *> Indices,
+                                   MultiExprArg Limits, Expr *Mask,
+                                   SourceLocation RParenLoc, Stmt *Body,
+                                   SourceLocation EndLoc);
   ExprResult CheckObjCForCollectionOperand(SourceLocation forLoc,
                                            Expr *collection);
   StmtResult ActOnObjCForCollectionStmt(SourceLocation ForColLoc,
@@ -3173,6 +3322,31 @@ public:
   ExprResult CreateBuiltinBinOp(SourceLocation OpLoc, BinaryOperatorKind Opc,
                                 Expr *LHSExpr, Expr *RHSExpr);
 
+  /// \brief Build an intrinsic binary operation at least one of whose
+  /// operands is a Fortran array.  The operation applies element by element
+  /// and yields an array of the shape of its array operands.
+  ExprResult CreateFortranArrayBinOp(SourceLocation OpLoc,
+                                     BinaryOperatorKind Opc,
+                                     Expr *LHSExpr, Expr *RHSExpr);
+
+  /// \brief Build an intrinsic unary operation on a Fortran array, which
+  /// applies element by element.
+  ExprResult CreateFortranArrayUnaryOp(SourceLocation OpLoc,
+                                       UnaryOperatorKind Opc,
+                                       Expr *InputExpr);
+
+  /// \brief Check that the Fortran arrays \p LHS and \p RHS have the same
+  /// shape, diagnosing them at \p Loc if they do not.
+  ///
+  /// \returns true if the arrays do not conform.
+  bool CheckFortranArrayConformance(SourceLocation Loc, Expr *LHS, Expr *RHS);
+
+  /// \brief Build a reference to the element of the Fortran array \p Base
+  /// selected by \p Subscripts, one per dimension in dimension order.
+  ExprResult BuildFortranArrayElementRef(Expr *Base, SourceLocation LParenLoc,
+                                         MultiExprArg Subscripts,
+                                         SourceLocation RParenLoc);
+
   /// ActOnConditionalOp - Parse a ?: operation.  Note that 'LHS' may be null
   /// in the case of a the GNU conditional expr extension.
   ExprResult ActOnConditionalOp(SourceLocation QuestionLoc,
@@ -7214,6 +7388,7 @@ private:
   bool CheckObjCString(Expr *Arg);
 
   ExprResult CheckBuiltinSubprogramCall(unsigned BuiltinID, CallExpr *TheCall);
+  ExprResult CheckFortranIntrinsicCall(unsigned IntrinsicID, CallExpr *TheCall);
   bool CheckARMBuiltinSubprogramCall(unsigned BuiltinID, CallExpr *TheCall);
   bool CheckMipsBuiltinSubprogramCall(unsigned BuiltinID, CallExpr *TheCall);
 
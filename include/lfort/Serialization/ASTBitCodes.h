@@ -277,7 +277,15 @@ namespace lfort {
       HEADER_SEARCH_OPTIONS = 11,
 
       /// \brief Record code for the preprocessor options table.
-      PREPROCESSOR_OPTIONS = 12
+      PREPROCESSOR_OPTIONS = 12,
+
+      /// \brief Record code for the interface hashes of the Fortran modules
+      /// defined by a module file, as (name, hash) pairs.
+      FORTRAN_MODULE_INTERFACES = 13,
+
+      /// \brief Record code that marks a Fortran submodule file, whose
+      /// module-private declarations are visible to its readers.
+      FORTRAN_SUBMODULE_FILE = 14
     };
 
     /// \brief Record types that occur within the input-files block
@@ -1282,7 +1290,10 @@ namespace lfort {
       EXPR_OBJC_BRIDGED_CAST,     // ObjCBridgedCastExpr
       
       STMT_MS_DEPENDENT_EXISTS,   // MSDependentExistsStmt
-      EXPR_LAMBDA                 // LambdaExpr
+      EXPR_LAMBDA,                // LambdaExpr
+
+      // Fortran
+      STMT_DO_CONCURRENT          // DoConcurrentStmt
     };
 
     /// \brief The kinds of designators that can occur in a
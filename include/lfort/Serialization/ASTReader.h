@@ -40,6 +40,7 @@
 #include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/SmallSet.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Bitcode/BitstreamReader.h"
 #include "llvm/Support/DataTypes.h"
@@ -161,6 +162,11 @@ public:
   /// \brief Receives __COUNTER__ value.
   virtual void ReadCounter(const serialization::PCModuleFile &M,
                            unsigned Value) {}
+
+  /// \brief Receives the interface hash of a Fortran module defined by the
+  /// module file.
+  virtual void ReadFortranModuleInterface(StringRef Name,
+                                          uint64_t InterfaceHash) {}
 };
 
 /// \brief ASTReaderListener implementation to validate the information of
@@ -881,6 +887,10 @@ private:
   /// predefines buffer may contain additional definitions.
   std::string SuggestedPredefines;
 
+  /// \brief The interface hashes of the Fortran modules defined by the
+  /// module files that have been read, by module name.
+  llvm::StringMap<uint64_t> FortranModuleInterfaceHashes;
+
   /// \brief Reads a statement from the specified cursor.
   Stmt *ReadStmtFromStream(PCModuleFile &F);
 
@@ -1196,6 +1206,20 @@ public:
   /// build prior to including the precompiled header.
   const std::string &getSuggestedPredefines() { return SuggestedPredefines; }
 
+  /// \brief Retrieve the interface hash of the Fortran module \p Name, if a
+  /// module file that was read defines it.
+  ///
+  /// \returns true if the hash is known.
+  virtual bool getFortranModuleInterfaceHash(StringRef Name,
+                                             uint64_t &InterfaceHash) const {
+    llvm::StringMap<uint64_t>::const_iterator Known
+      = FortranModuleInterfaceHashes.find(Name);
+    if (Known == FortranModuleInterfaceHashes.end())
+      return false;
+    InterfaceHash = Known->second;
+    return true;
+  }
+
   /// \brief Read a preallocated preprocessed entity from the external source.
   ///
   /// \returns null if an error occurred that prevented the preprocessed
@@ -122,6 +122,14 @@ private:
   /// \brief Indicates that the AST contained compiler errors.
   bool ASTHasCompilerErrors;
 
+  /// \brief Indicates that we are writing a Fortran module file, which only
+  /// carries the Fortran modules defined at program scope.
+  bool WritingFortranModuleFile;
+
+  /// \brief Indicates that the Fortran module file is a submodule file, whose
+  /// readers see the module-private declarations.
+  bool WritingFortranSubmoduleFile;
+
   /// \brief Mapping from input file entries to the index into the
   /// offset table where information about that input file is stored.
   llvm::DenseMap<const FileEntry *, uint32_t> InputFileIDs;
@@ -414,7 +422,7 @@ private:
                     llvm::DenseSet<Stmt *> &ParentStmts);
 
   void WriteBlockInfoBlock();
-  void WriteControlBlock(Preprocessor &PP, ASTContext &Context,
+  void WriteControlBlock(Sema &SemaRef, Preprocessor &PP, ASTContext &Context,
                          StringRef isysroot, const std::string &OutputFile);
   void WriteInputFiles(SourceManager &SourceMgr, StringRef isysroot);
   void WriteSourceManagerBlock(SourceManager &SourceMgr,
@@ -491,6 +499,23 @@ public:
                 PCModule *WritingPCModule, StringRef isysroot,
                 bool hasErrors = false);
 
+  /// \brief Set whether subsequent calls to WriteAST write a Fortran module
+  /// file, leaving out everything at program scope other than the Fortran
+  /// modules and the declarations they need.
+  void setWritingFortranModuleFile(bool Value) {
+    WritingFortranModuleFile = Value;
+  }
+
+  /// \brief Set whether the Fortran module file is a submodule file, which
+  /// the descendants of a module are compiled against.
+  void setWritingFortranSubmoduleFile(bool Value) {
+    WritingFortranSubmoduleFile = Value;
+  }
+
+  /// \brief Determine whether the given program-scope declaration belongs in
+  /// the AST file being written.
+  bool isWrittenProgramScopeDecl(const Decl *D) const;
+
   /// \brief Emit a source location.
   void AddSourceLocation(SourceLocation Loc, RecordDataImpl &Record);
 
@@ -749,6 +774,43 @@ public:
   virtual ASTDeserializationListener *GetASTDeserializationListener();
 };
 
+/// \brief AST and semantic-analysis consumer that writes a module file for
+/// each Fortran module defined in the parsed source code, or a submodule
+/// file for each module and submodule.
+///
+/// A module file is an AST file holding just the namespaces of the modules
+/// and what they refer to, named after the module in lowercase with a ".mod"
+/// suffix.  Programs that use a module read its module file.  A submodule
+/// file has the same contents but also exposes the private entities; it is
+/// named "module.smod" or "module@submodule.smod", and the descendants of the
+/// module or submodule are compiled against it.  Since submodules only ever
+/// write submodule files, changing a submodule leaves the module file of its
+/// ancestor alone.
+class FortranModuleFileGenerator : public SemaConsumer {
+  const Preprocessor &PP;
+  std::string OutputDir;
+  bool SubmoduleFiles;
+  Sema *SemaPtr;
+  llvm::SmallVector<char, 128> Buffer;
+  llvm::BitstreamWriter Stream;
+  ASTWriter Writer;
+
+public:
+  /// \param OutputDir The directory to write module files to; the current
+  /// directory if empty.
+  ///
+  /// \param SubmoduleFiles Whether to write submodule files rather than
+  /// module files.
+  FortranModuleFileGenerator(const Preprocessor &PP, StringRef OutputDir,
+                             bool SubmoduleFiles);
+  ~FortranModuleFileGenerator();
+  virtual void InitializeSema(Sema &S) { SemaPtr = &S; }
+  virtual void HandleProgram(ASTContext &Ctx);
+  virtual PPMutationListener *GetPPMutationListener();
+  virtual ASTMutationListener *GetASTMutationListener();
+  virtual ASTDeserializationListener *GetASTDeserializationListener();
+};
+
 } // end namespace lfort
 
 #endif
@@ -95,6 +95,10 @@ public:
   /// \brief Whether this precompiled header is a relocatable PCH file.
   bool RelocatablePCH;
 
+  /// \brief Whether this is a Fortran submodule file, whose module-private
+  /// declarations stay visible to the submodules compiled against it.
+  bool FortranSubmoduleFile;
+
   /// \brief The file entry for the module file.
   const FileEntry *File;
 
@@ -55,6 +55,7 @@ namespace tooling {
 ///   CommonOptionsParser OptionsParser(argc, argv);
 ///   LFortTool Tool(OptionsParser.getCompilations(),
 ///                  OptionsParser.getSourcePathListi());
+///   Tool.setNumThreads(OptionsParser.getNumThreads());
 ///   return Tool.run(newFrontendActionFactory<lfort::SyntaxOnlyAction>());
 /// }
 /// \endcode
@@ -76,11 +77,17 @@ public:
     return SourcePathList;
   }
 
+  /// Returns the number of files to process at the same time (-j).
+  unsigned getNumThreads() const {
+    return NumThreads;
+  }
+
   static const char *const HelpMessage;
 
 private:
   llvm::OwningPtr<CompilationDatabase> Compilations;
   std::vector<std::string> SourcePathList;
+  unsigned NumThreads;
 };
 
 }  // namespace tooling
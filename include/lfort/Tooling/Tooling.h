@@ -141,6 +141,11 @@ class ToolInvocation {
   /// \param Content A null terminated buffer of the file's content.
   void mapVirtualFile(StringRef FilePath, StringRef Content);
 
+  /// \brief Send diagnostics to \p OS instead of llvm::errs().
+  ///
+  /// \param OS The stream to print to. Class does not take ownership.
+  void setDiagnosticStream(llvm::raw_ostream *OS) { DiagnosticStream = OS; }
+
   /// \brief Run the lfort invocation.
   ///
   /// \returns True if there were no errors during execution.
@@ -157,10 +162,13 @@ class ToolInvocation {
   std::vector<std::string> CommandLine;
   llvm::OwningPtr<FrontendAction> ToolAction;
   FileManager *Files;
+  llvm::raw_ostream *DiagnosticStream;
   // Maps <file name> -> <file content>.
   llvm::StringMap<StringRef> MappedFileContents;
 };
 
+struct ToolWorkQueue;
+
 /// \brief Utility to run a FrontendAction over a set of files.
 ///
 /// This class is written to be usable for command line utilities.
@@ -190,19 +198,41 @@ class LFortTool {
   /// \param Adjuster Command line arguments adjuster.
   void setArgumentsAdjuster(ArgumentsAdjuster *Adjuster);
 
+  /// \brief Set the number of translation units processed at the same time.
+  ///
+  /// With more than one thread, each compile command gets its own
+  /// FileManager, rooted at the command's directory instead of changing the
+  /// process' working directory, and the tool's messages and diagnostics for
+  /// each file are printed in the order of the compile commands.  Output the
+  /// actions print directly is not reordered.
+  ///
+  /// \param NumThreads The number of threads, 1 (the default) to run
+  /// everything on the calling thread.
+  void setNumThreads(unsigned NumThreads) { this->NumThreads = NumThreads; }
+
   /// Runs a frontend action over all files specified in the command line.
   ///
   /// \param ActionFactory Factory generating the frontend actions. The function
   /// takes ownership of this parameter. A new action is generated for every
-  /// processed translation unit.
+  /// processed translation unit.  With more than one thread, create() is
+  /// never called concurrently, but the actions it returns run concurrently.
   int run(FrontendActionFactory *ActionFactory);
 
   /// \brief Returns the file manager used in the tool.
   ///
-  /// The file manager is shared between all translation units.
+  /// The file manager is shared between all translation units processed on
+  /// the calling thread; it is not used when running on several threads.
   FileManager &getFiles() { return Files; }
 
  private:
+  friend struct ToolWorkQueue;
+
+  /// \brief Run the compile command \p Index with \p Action, printing the
+  /// tool's messages to \p Out and diagnostics to \p DiagOut.
+  bool runCommand(unsigned Index, const std::string &MainExecutable,
+                  FrontendAction *Action, FileManager &CommandFiles,
+                  llvm::raw_ostream &Out, llvm::raw_ostream &DiagOut);
+
   // We store compile commands as pair (file name, compile command).
   std::vector< std::pair<std::string, CompileCommand> > CompileCommands;
 
@@ -211,6 +241,8 @@ class LFortTool {
   std::vector< std::pair<StringRef, StringRef> > MappedFileContents;
 
   llvm::OwningPtr<ArgumentsAdjuster> ArgsAdjuster;
+
+  unsigned NumThreads;
 };
 
 template <typename T>
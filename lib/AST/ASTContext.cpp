@@ -4021,6 +4021,33 @@ ASTContext::getConstantArrayElementCount(const ConstantArrayType *CA)  const {
   return ElementCount;
 }
 
+bool ASTContext::isFortranCharacterType(QualType T) const {
+  const ArrayType *AT = getAsArrayType(T);
+  return AT && AT->getElementType()->isAnyCharacterType();
+}
+
+QualType ASTContext::getFortranScalarType(QualType T) const {
+  while (!isFortranCharacterType(T)) {
+    const ArrayType *AT = getAsArrayType(T);
+    if (!AT)
+      break;
+    T = AT->getElementType();
+  }
+  return T;
+}
+
+QualType ASTContext::getFortranArrayOfShape(QualType ArrayTy,
+                                            QualType ScalarTy) const {
+  if (!isFortranArrayType(ArrayTy))
+    return ScalarTy;
+
+  const ArrayType *AT = getAsArrayType(ArrayTy);
+  QualType EltTy = getFortranArrayOfShape(AT->getElementType(), ScalarTy);
+  if (const ConstantArrayType *CAT = dyn_cast<ConstantArrayType>(AT))
+    return getConstantArrayType(EltTy, CAT->getSize(), ArrayType::Normal, 0);
+  return getIncompleteArrayType(EltTy, ArrayType::Normal, 0);
+}
+
 /// getFloatingRank - Return a relative rank for floating point types.
 /// This routine will assert if passed a built-in type that isn't a float.
 static FloatingRank getFloatingRank(QualType T) {
@@ -888,6 +888,45 @@ void ForStmt::setConditionVariable(ASTContext &C, VarDecl *V) {
                                        VarRange.getEnd());
 }
 
+DoConcurrentStmt::DoConcurrentStmt(ASTContext &C, SourceLocation DL,
+                                   SourceLocation LP, DeclStmt *Indices,
+                                   ArrayRef<Expr *> Limits, Expr *Mask,
+                                   SourceLocation RP, Stmt *Body,
+                                   SourceLocation EL)
+  : Stmt(DoConcurrentStmtClass), NumIndices(Limits.size() / LIMITS_PER_INDEX),
+    DoLoc(DL), LParenLoc(LP), RParenLoc(RP), EndLoc(EL)
+{
+  assert(Limits.size() % LIMITS_PER_INDEX == 0 &&
+         "Expected a lower limit, upper limit and step per index");
+  SubExprs = new (C) Stmt*[getMaskIndex() + 2];
+  SubExprs[INDICES] = Indices;
+  for (unsigned I = 0, N = Limits.size(); I != N; ++I)
+    SubExprs[FIRST_LIMIT + I] = reinterpret_cast<Stmt*>(Limits[I]);
+  SubExprs[getMaskIndex()] = reinterpret_cast<Stmt*>(Mask);
+  SubExprs[getMaskIndex() + 1] = Body;
+}
+
+DoConcurrentStmt::DoConcurrentStmt(ASTContext &C, EmptyShell Empty,
+                                   unsigned NumIndices)
+  : Stmt(DoConcurrentStmtClass, Empty), NumIndices(NumIndices)
+{
+  SubExprs = new (C) Stmt*[getMaskIndex() + 2];
+  for (unsigned I = 0, N = getMaskIndex() + 2; I != N; ++I)
+    SubExprs[I] = 0;
+}
+
+DoConcurrentStmt *DoConcurrentStmt::CreateEmpty(ASTContext &C,
+                                                unsigned NumIndices) {
+  return new (C) DoConcurrentStmt(C, EmptyShell(), NumIndices);
+}
+
+VarDecl *DoConcurrentStmt::getIndexVar(unsigned I) const {
+  assert(I < NumIndices && "Index out of range!");
+  DeclGroupRef DG = cast<DeclStmt>(SubExprs[INDICES])->getDeclGroup();
+  return cast<VarDecl>(DG.isSingleDecl() ? DG.getSingleDecl()
+                                         : DG.getDeclGroup()[I]);
+}
+
 SwitchStmt::SwitchStmt(ASTContext &C, VarDecl *Var, Expr *cond)
   : Stmt(SwitchStmtClass), FirstCase(0), AllEnumCasesCovered(0)
 {
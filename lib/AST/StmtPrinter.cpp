@@ -271,6 +271,29 @@ void StmtPrinter::VisitDoStmt(DoStmt *Node) {
   OS << ");\n";
 }
 
+void StmtPrinter::VisitDoConcurrentStmt(DoConcurrentStmt *Node) {
+  Indent() << "do concurrent (";
+  for (unsigned I = 0, N = Node->getNumIndices(); I != N; ++I) {
+    if (I)
+      OS << ", ";
+    OS << *Node->getIndexVar(I) << " = ";
+    PrintExpr(Node->getLower(I));
+    OS << ":";
+    PrintExpr(Node->getUpper(I));
+    if (Node->getStep(I)) {
+      OS << ":";
+      PrintExpr(Node->getStep(I));
+    }
+  }
+  if (Node->getMask()) {
+    OS << ", ";
+    PrintExpr(Node->getMask());
+  }
+  OS << ")\n";
+  PrintStmt(Node->getBody());
+  Indent() << "end do\n";
+}
+
 void StmtPrinter::VisitForStmt(ForStmt *Node) {
   Indent() << "for (";
   if (Node->getInit()) {
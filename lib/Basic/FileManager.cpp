@@ -22,7 +22,9 @@
 #include "llvm/ADT/SmallString.h"
 #include "llvm/Config/llvm-config.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/ManagedStatic.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Mutex.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Support/system_error.h"
@@ -45,6 +47,11 @@ using namespace lfort;
 // FIXME: Enhance libsystem to support inode and other fields.
 #include <sys/stat.h>
 
+#if defined(LLVM_ON_UNIX)
+#include <fcntl.h>
+#include <sys/mman.h>
+#endif
+
 /// NON_EXISTENT_DIR - A special value distinct from null that is used to
 /// represent a dir name that doesn't exist on the disk.
 #define NON_EXISTENT_DIR reinterpret_cast<DirectoryEntry*>((intptr_t)-1)
@@ -181,9 +188,19 @@ FileManager::FileManager(const FileSystemOptions &FSO)
   : FileSystemOpts(FSO),
     UniqueRealDirs(*new UniqueDirContainer()),
     UniqueRealFiles(*new UniqueFileContainer()),
-    SeenDirEntries(64), SeenFileEntries(64), NextFileUID(0) {
+    SeenDirEntries(64), SeenFileEntries(64), NextFileUID(0),
+    DirListingCache(0) {
   NumDirLookups = NumFileLookups = 0;
   NumDirCacheMisses = NumFileCacheMisses = 0;
+  NumBytesMapped = NumBytesCopied = 0;
+  NumSharedMappings = 0;
+
+  if (FileSystemOpts.CacheDirectoryListings ||
+      !FileSystemOpts.DirectoryListingCachePath.empty()) {
+    DirListingCache
+      = new DirectoryListingStatCache(FileSystemOpts.DirectoryListingCachePath);
+    addStatCache(DirListingCache);
+  }
 }
 
 FileManager::~FileManager() {
@@ -215,6 +232,9 @@ void FileManager::removeStatCache(FileSystemStatCache *statCache) {
   if (!statCache)
     return;
   
+  if (statCache == DirListingCache)
+    DirListingCache = 0;
+
   if (StatCache.get() == statCache) {
     // This is the first stat cache.
     StatCache.reset(StatCache->takeNextStatCache());
@@ -232,6 +252,24 @@ void FileManager::removeStatCache(FileSystemStatCache *statCache) {
 
 void FileManager::clearStatCaches() {
   StatCache.reset(0);
+  DirListingCache = 0;
+}
+
+void FileManager::invalidateDirectoryListing(StringRef Filename) {
+  if (!DirListingCache)
+    return;
+
+  SmallString<128> FilePath(Filename);
+  FixupRelativePath(FilePath);
+  StringRef DirName = llvm::sys::path::parent_path(FilePath.str());
+  if (DirName.empty())
+    DirName = ".";
+  DirListingCache->invalidateDirectory(DirName);
+}
+
+void FileManager::writeDirectoryListingCache() {
+  if (DirListingCache)
+    DirListingCache->writeCacheFile();
 }
 
 /// \brief Retrieve the directory that the given file name resides in.
@@ -494,12 +532,168 @@ void FileManager::FixupRelativePath(SmallVectorImpl<char> &path) const {
   path = NewPath;
 }
 
+//===----------------------------------------------------------------------===//
+// Shared Read-Only Mappings.
+//===----------------------------------------------------------------------===//
+
+#if defined(LLVM_ON_UNIX)
+namespace {
+/// \brief Identifies one version of a file on disk.
+struct MappedFileKey {
+  dev_t Device;
+  ino_t Inode;
+  off_t Size;
+  time_t ModTime;
+
+  bool operator<(const MappedFileKey &RHS) const {
+    if (Device != RHS.Device) return Device < RHS.Device;
+    if (Inode != RHS.Inode) return Inode < RHS.Inode;
+    if (Size != RHS.Size) return Size < RHS.Size;
+    return ModTime < RHS.ModTime;
+  }
+};
+
+/// \brief A read-only mapping of a file, shared by all buffers for the same
+/// version of the file in this process.
+struct SharedMapping {
+  const char *Start;
+  size_t Size;
+  unsigned RefCount;
+};
+
+typedef std::map<MappedFileKey, SharedMapping> SharedMappingMap;
+} // end anonymous namespace
+
+static llvm::ManagedStatic<llvm::sys::Mutex> SharedMappingLock;
+static llvm::ManagedStatic<SharedMappingMap> SharedMappings;
+
+namespace {
+/// \brief A MemoryBuffer over a shared mapping.  The file is unmapped when
+/// the last buffer referring to it is destroyed.
+class SharedMappedBuffer : public llvm::MemoryBuffer {
+  std::string Name;
+  SharedMappingMap::iterator Mapping;
+
+public:
+  SharedMappedBuffer(StringRef Name, SharedMappingMap::iterator Mapping)
+    : Name(Name), Mapping(Mapping) {
+    init(Mapping->second.Start, Mapping->second.Start + Mapping->second.Size,
+         /*RequiresNullTerminator=*/true);
+  }
+
+  ~SharedMappedBuffer() {
+    llvm::sys::ScopedLock Guard(*SharedMappingLock);
+    if (--Mapping->second.RefCount == 0) {
+      ::munmap(const_cast<char *>(Mapping->second.Start),
+               Mapping->second.Size);
+      SharedMappings->erase(Mapping);
+    }
+  }
+
+  virtual const char *getBufferIdentifier() const { return Name.c_str(); }
+
+  virtual BufferKind getBufferKind() const { return MemoryBuffer_MMap; }
+};
+} // end anonymous namespace
+
+/// \brief Return a buffer for \p Entry that shares the process-wide mapping
+/// of the file, mapping it first if necessary.  \p FD is an open descriptor
+/// for the file, or -1.
+///
+/// Returns null if the file cannot be mapped with the null terminator the
+/// lexer relies on, in which case it should be read normally.
+static llvm::MemoryBuffer *getSharedMappedBuffer(const FileEntry *Entry,
+                                                 StringRef Path, int FD,
+                                                 bool &Shared) {
+  // The zero-filled tail of the last page only provides a terminator if the
+  // file does not end on a page boundary.
+  static const size_t PageSize = ::getpagesize();
+  size_t Size = Entry->getSize();
+  if (Size == 0 || Size % PageSize == 0)
+    return 0;
+
+  MappedFileKey Key = { Entry->getDevice(), Entry->getInode(),
+                        Entry->getSize(), Entry->getModificationTime() };
+
+  llvm::sys::ScopedLock Guard(*SharedMappingLock);
+  SharedMappingMap::iterator Known = SharedMappings->find(Key);
+  if (Known != SharedMappings->end()) {
+    ++Known->second.RefCount;
+    Shared = true;
+    return new SharedMappedBuffer(Path, Known);
+  }
+
+  int OwnedFD = -1;
+  if (FD == -1) {
+    SmallString<128> PathStr(Path);
+    FD = OwnedFD = ::open(PathStr.c_str(), O_RDONLY);
+    if (FD == -1)
+      return 0;
+  }
+
+  // Never map past the end of the file: if it changed since it was stat'ed,
+  // touching the missing pages would fault.
+  void *Start = MAP_FAILED;
+  struct stat StatBuf;
+  if (::fstat(FD, &StatBuf) == 0 && StatBuf.st_size == Entry->getSize() &&
+      StatBuf.st_mtime == Entry->getModificationTime())
+    Start = ::mmap(0, Size, PROT_READ, MAP_PRIVATE, FD, 0);
+  if (OwnedFD != -1)
+    ::close(OwnedFD);
+  if (Start == MAP_FAILED)
+    return 0;
+
+  // The lexer reads the file from start to finish, so ask for all of it to
+  // be read ahead rather than faulting it in a page at a time.
+#ifdef MADV_SEQUENTIAL
+  ::madvise(Start, Size, MADV_SEQUENTIAL);
+#endif
+#ifdef MADV_WILLNEED
+  ::madvise(Start, Size, MADV_WILLNEED);
+#endif
+
+  SharedMapping Mapping = { static_cast<const char *>(Start), Size, 1 };
+  Known = SharedMappings->insert(std::make_pair(Key, Mapping)).first;
+  return new SharedMappedBuffer(Path, Known);
+}
+#endif
+
+void FileManager::noteBufferRead(const llvm::MemoryBuffer *Buffer) {
+  if (!Buffer)
+    return;
+
+  if (Buffer->getBufferKind() == llvm::MemoryBuffer::MemoryBuffer_MMap)
+    NumBytesMapped += Buffer->getBufferSize();
+  else
+    NumBytesCopied += Buffer->getBufferSize();
+}
+
 llvm::MemoryBuffer *FileManager::
 getBufferForFile(const FileEntry *Entry, std::string *ErrorStr,
                  bool isVolatile) {
   OwningPtr<llvm::MemoryBuffer> Result;
   llvm::error_code ec;
 
+#if defined(LLVM_ON_UNIX)
+  // Share a mapping of the file if asked to.  Volatile files may change
+  // under us, so they are always read.
+  if (FileSystemOpts.MapSourceFiles && !isVolatile) {
+    SmallString<128> FilePath(Entry->getName());
+    FixupRelativePath(FilePath);
+    bool Shared = false;
+    if (llvm::MemoryBuffer *Buffer
+          = getSharedMappedBuffer(Entry, FilePath.str(), Entry->FD, Shared)) {
+      if (Entry->FD != -1) {
+        close(Entry->FD);
+        Entry->FD = -1;
+      }
+      NumBytesMapped += Buffer->getBufferSize();
+      NumSharedMappings += Shared;
+      return Buffer;
+    }
+  }
+#endif
+
   uint64_t FileSize = Entry->getSize();
   // If there's a high enough chance that the file have changed since we
   // got its size, force a stat before opening it.
@@ -515,6 +709,7 @@ getBufferForFile(const FileEntry *Entry, std::string *ErrorStr,
 
     close(Entry->FD);
     Entry->FD = -1;
+    noteBufferRead(Result.get());
     return Result.take();
   }
 
@@ -524,6 +719,7 @@ getBufferForFile(const FileEntry *Entry, std::string *ErrorStr,
     ec = llvm::MemoryBuffer::getFile(Filename, Result, FileSize);
     if (ec && ErrorStr)
       *ErrorStr = ec.message();
+    noteBufferRead(Result.get());
     return Result.take();
   }
 
@@ -532,6 +728,7 @@ getBufferForFile(const FileEntry *Entry, std::string *ErrorStr,
   ec = llvm::MemoryBuffer::getFile(FilePath.str(), Result, FileSize);
   if (ec && ErrorStr)
     *ErrorStr = ec.message();
+  noteBufferRead(Result.get());
   return Result.take();
 }
 
@@ -543,6 +740,7 @@ getBufferForFile(StringRef Filename, std::string *ErrorStr) {
     ec = llvm::MemoryBuffer::getFile(Filename, Result);
     if (ec && ErrorStr)
       *ErrorStr = ec.message();
+    noteBufferRead(Result.get());
     return Result.take();
   }
 
@@ -551,6 +749,7 @@ getBufferForFile(StringRef Filename, std::string *ErrorStr) {
   ec = llvm::MemoryBuffer::getFile(FilePath.c_str(), Result);
   if (ec && ErrorStr)
     *ErrorStr = ec.message();
+  noteBufferRead(Result.get());
   return Result.take();
 }
 
@@ -631,6 +830,11 @@ void FileManager::PrintStats() const {
                << NumDirCacheMisses << " dir cache misses.\n";
   llvm::errs() << NumFileLookups << " file lookups, "
                << NumFileCacheMisses << " file cache misses.\n";
+  llvm::errs() << NumBytesMapped << " bytes of files mapped ("
+               << NumSharedMappings << " shared mappings reused), "
+               << NumBytesCopied << " bytes copied.\n";
+  if (DirListingCache)
+    DirListingCache->PrintStats();
 
   //llvm::errs() << PagesMapped << BytesOfPagesMapped << FSLookups;
 }
@@ -12,7 +12,13 @@
 //===----------------------------------------------------------------------===//
 
 #include "lfort/Basic/FileSystemStatCache.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Support/system_error.h"
 #include <fcntl.h>
 
 // FIXME: This is terrible, we need this for ::close.
@@ -122,3 +128,215 @@ MemorizeStatCalls::getStat(const char *Path, struct stat &StatBuf,
   
   return Result;
 }
+
+//===----------------------------------------------------------------------===//
+// DirectoryListingStatCache
+//===----------------------------------------------------------------------===//
+
+/// \brief The first line of a directory listing cache file.  Bump the version
+/// whenever the format changes.
+static const char DirectoryListingCacheSignature[] =
+  "lfort-directory-listings 1";
+
+DirectoryListingStatCache::DirectoryListingStatCache(StringRef CachePath)
+  : CachePath(CachePath), Dirty(false), NumDirectoriesRead(0),
+    NumListingsReused(0), NumStatsAvoided(0) {
+  if (!this->CachePath.empty())
+    readCacheFile();
+}
+
+/// \brief Load the persisted listings.  Each listing is a header line
+/// "<mtime> <listed-at> <count> <directory>" followed by one line per entry.
+/// A malformed file is ignored as a whole.
+void DirectoryListingStatCache::readCacheFile() {
+  OwningPtr<llvm::MemoryBuffer> Buffer;
+  if (llvm::MemoryBuffer::getFile(CachePath, Buffer))
+    return;
+
+  StringRef Line, Rest = Buffer->getBuffer();
+  llvm::tie(Line, Rest) = Rest.split('\n');
+  if (Line != DirectoryListingCacheSignature)
+    return;
+
+  while (!Rest.empty()) {
+    llvm::tie(Line, Rest) = Rest.split('\n');
+
+    StringRef ModTimeStr, ListedAtStr, CountStr;
+    llvm::tie(ModTimeStr, Line) = Line.split(' ');
+    llvm::tie(ListedAtStr, Line) = Line.split(' ');
+    llvm::tie(CountStr, Line) = Line.split(' ');
+
+    long long ModTime, ListedAt;
+    unsigned Count;
+    if (ModTimeStr.getAsInteger(10, ModTime) ||
+        ListedAtStr.getAsInteger(10, ListedAt) ||
+        CountStr.getAsInteger(10, Count) || Line.empty()) {
+      Listings.clear();
+      return;
+    }
+
+    DirectoryListing &Listing = Listings.GetOrCreateValue(Line).getValue();
+    Listing.Exists = true;
+    Listing.ModTime = (time_t)ModTime;
+    Listing.ListedAt = (time_t)ListedAt;
+    for (unsigned I = 0; I != Count; ++I) {
+      if (Rest.empty()) {
+        Listings.clear();
+        return;
+      }
+
+      StringRef Name;
+      llvm::tie(Name, Rest) = Rest.split('\n');
+      Listing.Names.insert(Name);
+    }
+  }
+}
+
+void DirectoryListingStatCache::writeCacheFile() {
+  if (CachePath.empty() || !Dirty)
+    return;
+
+  SmallString<128> TempPath(CachePath);
+  TempPath += "-%%%%%%%%";
+  int FD;
+  if (llvm::sys::fs::unique_file(TempPath.str(), FD, TempPath,
+                                 /*makeAbsolute=*/false, 0664))
+    return;
+
+  llvm::raw_fd_ostream Out(FD, /*shouldClose=*/true);
+  Out << DirectoryListingCacheSignature << '\n';
+  for (llvm::StringMap<DirectoryListing, llvm::BumpPtrAllocator>::iterator
+         I = Listings.begin(), E = Listings.end(); I != E; ++I) {
+    const DirectoryListing &Listing = I->getValue();
+
+    // Only persist listings that can be validated in a later compilation:
+    // those of existing directories named independently of the working
+    // directory.
+    StringRef DirName = I->getKey();
+    if (!Listing.Exists || !llvm::sys::path::is_absolute(DirName) ||
+        DirName.find('\n') != StringRef::npos)
+      continue;
+
+    bool CanPersist = true;
+    for (llvm::StringSet<>::const_iterator
+           N = Listing.Names.begin(), NEnd = Listing.Names.end();
+         N != NEnd; ++N) {
+      if (N->getKey().find('\n') != StringRef::npos) {
+        CanPersist = false;
+        break;
+      }
+    }
+    if (!CanPersist)
+      continue;
+
+    Out << (long long)Listing.ModTime << ' ' << (long long)Listing.ListedAt
+        << ' ' << Listing.Names.size() << ' ' << DirName << '\n';
+    for (llvm::StringSet<>::const_iterator
+           N = Listing.Names.begin(), NEnd = Listing.Names.end();
+         N != NEnd; ++N)
+      Out << N->getKey() << '\n';
+  }
+  Out.close();
+
+  bool Existed;
+  if (Out.has_error()) {
+    Out.clear_error();
+    llvm::sys::fs::remove(TempPath.str(), Existed);
+    return;
+  }
+
+  if (llvm::sys::fs::rename(TempPath.str(), CachePath)) {
+    llvm::sys::fs::remove(TempPath.str(), Existed);
+    return;
+  }
+
+  Dirty = false;
+}
+
+void DirectoryListingStatCache::invalidateDirectory(StringRef DirName) {
+  Listings.erase(DirName);
+}
+
+/// \brief Retrieve a listing of the given directory that is valid for this
+/// compilation, reading the directory if necessary.  Returns null if the
+/// directory exists but could not be read.
+DirectoryListingStatCache::DirectoryListing *
+DirectoryListingStatCache::getListing(StringRef DirName) {
+  DirectoryListing &Listing = Listings.GetOrCreateValue(DirName).getValue();
+  if (Listing.Validated)
+    return &Listing;
+
+  // Nothing exists beneath a directory that does not exist.
+  SmallString<128> DirPath(DirName);
+  struct stat DirBuf;
+  if (::stat(DirPath.c_str(), &DirBuf) != 0 || !S_ISDIR(DirBuf.st_mode)) {
+    Listing.Exists = false;
+    Listing.Validated = true;
+    Listing.Names.clear();
+    return &Listing;
+  }
+
+  // A persisted listing is still accurate if the directory has not been
+  // modified since.  A modification within the second the listing was taken
+  // would not change the time stamp, so such listings are not trusted.
+  if (Listing.Exists && Listing.ModTime == DirBuf.st_mtime &&
+      Listing.ModTime < Listing.ListedAt) {
+    Listing.Validated = true;
+    ++NumListingsReused;
+    return &Listing;
+  }
+
+  Listing.Exists = true;
+  Listing.ModTime = DirBuf.st_mtime;
+  Listing.ListedAt = ::time(0);
+  Listing.Names.clear();
+
+  llvm::error_code EC;
+  for (llvm::sys::fs::directory_iterator Dir(DirPath.str(), EC), DirEnd;
+       Dir != DirEnd && !EC; Dir.increment(EC))
+    Listing.Names.insert(llvm::sys::path::filename(Dir->path()).lower());
+
+  if (EC) {
+    Listings.erase(DirName);
+    return 0;
+  }
+
+  Listing.Validated = true;
+  ++NumDirectoriesRead;
+  if (llvm::sys::path::is_absolute(DirName))
+    Dirty = true;
+  return &Listing;
+}
+
+DirectoryListingStatCache::LookupResult
+DirectoryListingStatCache::getStat(const char *Path, struct stat &StatBuf,
+                                   bool isFile, int *FileDescriptor) {
+  StringRef PathRef(Path);
+  if (PathRef.empty() || llvm::sys::path::is_separator(PathRef.back()))
+    return statChained(Path, StatBuf, isFile, FileDescriptor);
+
+  StringRef Name = llvm::sys::path::filename(PathRef);
+  if (Name == "." || Name == "..")
+    return statChained(Path, StatBuf, isFile, FileDescriptor);
+
+  StringRef DirName = llvm::sys::path::parent_path(PathRef);
+  if (DirName.empty())
+    DirName = ".";
+
+  DirectoryListing *Listing = getListing(DirName);
+  if (!Listing)
+    return statChained(Path, StatBuf, isFile, FileDescriptor);
+
+  if (!Listing->Exists || !Listing->Names.count(Name.lower())) {
+    ++NumStatsAvoided;
+    return CacheMissing;
+  }
+
+  return statChained(Path, StatBuf, isFile, FileDescriptor);
+}
+
+void DirectoryListingStatCache::PrintStats() const {
+  llvm::errs() << NumDirectoriesRead << " directories listed, "
+               << NumListingsReused << " listings reused, "
+               << NumStatsAvoided << " stats avoided.\n";
+}
@@ -0,0 +1,36 @@
+//===--- FortranIntrinsics.cpp - Fortran intrinsic procedures -------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+//  This file implements the lookup of Fortran intrinsic procedures in the
+//  tables generated from FortranIntrinsics.td.
+//
+//===----------------------------------------------------------------------===//
+
+#include "lfort/Basic/FortranIntrinsics.h"
+#include <cassert>
+using namespace lfort;
+
+static const intrinsic::Info IntrinsicInfo[] = {
+  { "not an intrinsic procedure", "", "", 'v', 0, -1, false },
+#define GET_FORTRAN_INTRINSIC_INFO
+#include "lfort/Basic/FortranIntrinsics.inc"
+#undef GET_FORTRAN_INTRINSIC_INFO
+};
+
+intrinsic::ID intrinsic::lookup(StringRef Name) {
+#define GET_FORTRAN_INTRINSIC_LOOKUP
+#include "lfort/Basic/FortranIntrinsics.inc"
+#undef GET_FORTRAN_INTRINSIC_LOOKUP
+  return NotIntrinsic;
+}
+
+const intrinsic::Info &intrinsic::getInfo(ID IntrinsicID) {
+  assert(IntrinsicID < NumIntrinsics && "Invalid intrinsic ID!");
+  return IntrinsicInfo[IntrinsicID];
+}
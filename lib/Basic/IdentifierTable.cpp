@@ -22,6 +22,10 @@
 #include <cctype>
 #include <cstdio>
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 using namespace lfort;
 
 //===----------------------------------------------------------------------===//
@@ -74,7 +78,8 @@ ExternalIdentifierLookup::~ExternalIdentifierLookup() {}
 IdentifierTable::IdentifierTable(const LangOptions &LangOpts,
                                  IdentifierInfoLookup* externalLookup)
   : HashTable(8192), // Start with space for 8K identifiers.
-    ExternalLookup(externalLookup) {
+    ExternalLookup(externalLookup),
+    FoldCase(LangOpts.FoldIdentifierCase) {
 
   // Populate the identifier table with info about keywords for the current
   // language.
@@ -85,6 +90,46 @@ IdentifierTable::IdentifierTable(const LangOptions &LangOpts,
   get("import").setPCModulesImport(true);
 }
 
+bool IdentifierTable::foldCase(const char *Src, unsigned Len, char *Dst) {
+  bool Changed = false;
+  unsigned I = 0;
+
+#ifdef __SSE2__
+  // Lower a whole vector at a time: build a mask of the bytes in ['A', 'Z']
+  // and OR 0x20 into just those lanes.  Bytes >= 0x80 compare as negative and
+  // so are never part of the mask.
+  const __m128i BeforeA = _mm_set1_epi8('A' - 1);
+  const __m128i AfterZ = _mm_set1_epi8('Z' + 1);
+  const __m128i CaseBit = _mm_set1_epi8(0x20);
+  for (; I + 16 <= Len; I += 16) {
+    __m128i V = _mm_loadu_si128((const __m128i*)(Src + I));
+    __m128i Upper = _mm_and_si128(_mm_cmpgt_epi8(V, BeforeA),
+                                  _mm_cmplt_epi8(V, AfterZ));
+    Changed |= _mm_movemask_epi8(Upper) != 0;
+    _mm_storeu_si128((__m128i*)(Dst + I),
+                     _mm_or_si128(V, _mm_and_si128(Upper, CaseBit)));
+  }
+#endif
+
+  for (; I != Len; ++I) {
+    char C = Src[I];
+    if (C >= 'A' && C <= 'Z') {
+      C += 'a' - 'A';
+      Changed = true;
+    }
+    Dst[I] = C;
+  }
+  return Changed;
+}
+
+bool IdentifierTable::fold(StringRef Name, SmallVectorImpl<char> &Folded) {
+  Folded.resize(Name.size());
+  if (foldCase(Name.data(), Name.size(), Folded.data()))
+    return true;
+  Folded.clear();
+  return false;
+}
+
 //===----------------------------------------------------------------------===//
 // Language Keyword Implementation
 //===----------------------------------------------------------------------===//
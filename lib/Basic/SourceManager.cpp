@@ -373,7 +373,7 @@ LineTableInfo &SourceManager::getLineTable() {
 SourceManager::SourceManager(DiagnosticsEngine &Diag, FileManager &FileMgr,
                              bool UserFilesAreVolatile)
   : Diag(Diag), FileMgr(FileMgr), OverridenFilesKeepOriginalName(true),
-    UserFilesAreVolatile(UserFilesAreVolatile),
+    UserFilesAreVolatile(UserFilesAreVolatile), FixedFormColumns(false),
     ExternalSLocEntries(0), LineTable(0), NumLinearScans(0),
     NumBinaryProbes(0), FakeBufferForRecovery(0),
     FakeContentCacheForRecovery(0) {
@@ -1010,6 +1010,25 @@ const char *SourceManager::getCharacterData(SourceLocation SL,
 }
 
 
+/// \brief Return the card column of \p Pos in the fixed-form line starting at
+/// \p LineStart.  A tab in the label or continuation field advances to column
+/// 7, as in tab-format source, and any other tab to the next multiple of 8.
+static unsigned getFixedFormColumn(const char *LineStart, const char *Pos) {
+  if (!memchr(LineStart, '\t', Pos - LineStart))
+    return Pos - LineStart + 1;
+
+  unsigned Col = 0;
+  for (const char *P = LineStart; P != Pos; ++P) {
+    if (*P != '\t')
+      ++Col;
+    else if (Col < 6)
+      Col = 6;
+    else
+      Col = (Col / 8 + 1) * 8;
+  }
+  return Col + 1;
+}
+
 /// getColumnNumber - Return the column # for the specified file position.
 /// this is significantly cheaper to compute than the line number.
 unsigned SourceManager::getColumnNumber(FileID FID, unsigned FilePos,
@@ -1048,6 +1067,19 @@ unsigned SourceManager::getColumnNumber(FileID FID, unsigned FilePos,
   return FilePos-LineStart+1;
 }
 
+unsigned SourceManager::getCardColumnNumber(FileID FID, unsigned FilePos,
+                                            bool *Invalid) const {
+  bool MyInvalid = false;
+  unsigned ColNo = getColumnNumber(FID, FilePos, &MyInvalid);
+  if (Invalid)
+    *Invalid = MyInvalid;
+  if (MyInvalid)
+    return ColNo;
+
+  const char *Pos = getBuffer(FID)->getBufferStart() + FilePos;
+  return getFixedFormColumn(Pos - (ColNo - 1), Pos);
+}
+
 // isInvalid - Return the result of calling loc.isInvalid(), and
 // if Invalid is not null, set its value to same.
 static bool isInvalid(SourceLocation Loc, bool *Invalid) {
@@ -1081,29 +1113,72 @@ unsigned SourceManager::getPresumedColumnNumber(SourceLocation Loc,
 #include <emmintrin.h>
 #endif
 
+/// \brief The least number of bytes a line table is extended by at a time, so
+/// that a series of queries moving through a file does not start a scan for
+/// every line.
+static const unsigned LineTableChunkSize = 64 * 1024;
+
+/// \brief Append the start offset of a line to the line table of \p FI,
+/// growing the table if it is full.
+static inline void AddLineOffset(ContentCache *FI,
+                                 llvm::BumpPtrAllocator &Alloc,
+                                 unsigned Offs) {
+  if (FI->NumLines == FI->LineCacheCapacity) {
+    // The old table stays in the allocator, which at worst doubles the
+    // memory used by line tables.
+    unsigned NewCapacity = FI->LineCacheCapacity * 2;
+    unsigned *NewCache = Alloc.Allocate<unsigned>(NewCapacity);
+    std::copy(FI->SourceLineCache, FI->SourceLineCache + FI->NumLines,
+              NewCache);
+    FI->SourceLineCache = NewCache;
+    FI->LineCacheCapacity = NewCapacity;
+  }
+  FI->SourceLineCache[FI->NumLines++] = Offs;
+}
+
+/// \brief Extend the line table of \p FI until it holds the start of every
+/// line up to file offset \p UntilOffset and has more than \p UntilLine
+/// entries, or covers the whole buffer.
+///
+/// The table is extended by at least LineTableChunkSize bytes at a time.
 static LLVM_ATTRIBUTE_NOINLINE void
-ComputeLineNumbers(DiagnosticsEngine &Diag, ContentCache *FI,
-                   llvm::BumpPtrAllocator &Alloc,
-                   const SourceManager &SM, bool &Invalid);
-static void ComputeLineNumbers(DiagnosticsEngine &Diag, ContentCache *FI,
-                               llvm::BumpPtrAllocator &Alloc,
-                               const SourceManager &SM, bool &Invalid) {
+ExtendLineNumbers(DiagnosticsEngine &Diag, ContentCache *FI,
+                  llvm::BumpPtrAllocator &Alloc, const SourceManager &SM,
+                  unsigned UntilOffset, unsigned UntilLine, bool &Invalid);
+static void ExtendLineNumbers(DiagnosticsEngine &Diag, ContentCache *FI,
+                              llvm::BumpPtrAllocator &Alloc,
+                              const SourceManager &SM,
+                              unsigned UntilOffset, unsigned UntilLine,
+                              bool &Invalid) {
   // Note that calling 'getBuffer()' may lazily page in the file.
   const MemoryBuffer *Buffer = FI->getBuffer(Diag, SM, SourceLocation(),
                                              &Invalid);
   if (Invalid)
     return;
 
-  // Find the file offsets of all of the *physical* source lines.  This does
-  // not look at trigraphs, escaped newlines, or anything else tricky.
-  SmallVector<unsigned, 256> LineOffsets;
+  if (FI->SourceLineCache == 0) {
+    // Guess at the number of lines from the size of the buffer, assuming
+    // lines are about 32 characters long.
+    FI->LineCacheCapacity = std::max(Buffer->getBufferSize() / 32, (size_t)256);
+    FI->SourceLineCache = Alloc.Allocate<unsigned>(FI->LineCacheCapacity);
+    FI->NumLines = 0;
+    FI->LineScanOffset = 0;
 
-  // Line #1 starts at char 0.
-  LineOffsets.push_back(0);
+    // Line #1 starts at char 0.
+    AddLineOffset(FI, Alloc, 0);
+  }
 
-  const unsigned char *Buf = (const unsigned char *)Buffer->getBufferStart();
+  // Find the file offsets of the *physical* source lines from where the last
+  // scan stopped.  This does not look at trigraphs, escaped newlines, or
+  // anything else tricky.
+  unsigned Offs = FI->LineScanOffset;
+  unsigned ChunkEnd = Offs + LineTableChunkSize;
+  if (ChunkEnd > UntilOffset && ChunkEnd > Offs)
+    UntilOffset = ChunkEnd;
+
+  const unsigned char *Buf
+    = (const unsigned char *)Buffer->getBufferStart() + Offs;
   const unsigned char *End = (const unsigned char *)Buffer->getBufferEnd();
-  unsigned Offs = 0;
   while (1) {
     // Skip over the contents of the line.
     const unsigned char *NextBuf = (const unsigned char *)Buf;
@@ -1152,19 +1227,23 @@ FoundSpecialChar:
       if ((Buf[1] == '\n' || Buf[1] == '\r') && Buf[0] != Buf[1])
         ++Offs, ++Buf;
       ++Offs, ++Buf;
-      LineOffsets.push_back(Offs);
+      AddLineOffset(FI, Alloc, Offs);
+
+      // Every line starting at or before Offs is now known.
+      if (Offs >= UntilOffset && FI->NumLines > UntilLine)
+        break;
     } else {
       // Otherwise, this is a null.  If end of file, exit.
-      if (Buf == End) break;
+      if (Buf == End) {
+        FI->LineTableComplete = true;
+        break;
+      }
       // Otherwise, skip the null.
       ++Offs, ++Buf;
     }
   }
 
-  // Copy the offsets into the FileInfo structure.
-  FI->NumLines = LineOffsets.size();
-  FI->SourceLineCache = Alloc.Allocate<unsigned>(LineOffsets.size());
-  std::copy(LineOffsets.begin(), LineOffsets.end(), FI->SourceLineCache);
+  FI->LineScanOffset = Offs;
 }
 
 /// getLineNumber - Given a SourceLocation, return the spelling line number
@@ -1194,11 +1273,13 @@ unsigned SourceManager::getLineNumber(FileID FID, unsigned FilePos,
     Content = const_cast<ContentCache*>(Entry.getFile().getContentCache());
   }
   
-  // If this is the first use of line information for this buffer, compute the
-  /// SourceLineCache for it on demand.
-  if (Content->SourceLineCache == 0) {
+  // Compute the SourceLineCache on demand, as far as this position, if it
+  // does not cover it yet.
+  if (Content->SourceLineCache == 0 ||
+      (!Content->LineTableComplete && Content->LineScanOffset < FilePos)) {
     bool MyInvalid = false;
-    ComputeLineNumbers(Diag, Content, ContentCacheAlloc, *this, MyInvalid);
+    ExtendLineNumbers(Diag, Content, ContentCacheAlloc, *this, FilePos, 0,
+                      MyInvalid);
     if (Invalid)
       *Invalid = MyInvalid;
     if (MyInvalid)
@@ -1389,7 +1470,9 @@ PresumedLoc SourceManager::getPresumedLoc(SourceLocation Loc,
   unsigned LineNo = getLineNumber(LocInfo.first, LocInfo.second, &Invalid);
   if (Invalid)
     return PresumedLoc();
-  unsigned ColNo  = getColumnNumber(LocInfo.first, LocInfo.second, &Invalid);
+  unsigned ColNo  = FixedFormColumns
+    ? getCardColumnNumber(LocInfo.first, LocInfo.second, &Invalid)
+    : getColumnNumber(LocInfo.first, LocInfo.second, &Invalid);
   if (Invalid)
     return PresumedLoc();
   
@@ -1620,11 +1703,13 @@ SourceLocation SourceManager::translateLineCol(FileID FID,
   if (!Content)
     return SourceLocation();
     
-  // If this is the first use of line information for this buffer, compute the
-  // SourceLineCache for it on demand.
-  if (Content->SourceLineCache == 0) {
+  // Compute the SourceLineCache on demand, as far as the start of this line,
+  // if it does not cover it yet.
+  if (Content->SourceLineCache == 0 ||
+      (!Content->LineTableComplete && Content->NumLines < Line)) {
     bool MyInvalid = false;
-    ComputeLineNumbers(Diag, Content, ContentCacheAlloc, *this, MyInvalid);
+    ExtendLineNumbers(Diag, Content, ContentCacheAlloc, *this, 0, Line - 1,
+                      MyInvalid);
     if (MyInvalid)
       return SourceLocation();
   }
@@ -0,0 +1,409 @@
+//===--- CGArrayExpr.cpp - Emit LLVM Code for Fortran Array Expressions ---===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This contains code to emit Fortran array expressions: whole-array
+// assignments, and intrinsic operations and elemental intrinsic references
+// whose operands are arrays.  An array expression is lowered to a tree of
+// elementwise operations which is evaluated for all elements in a single
+// loop, so no array temporaries are needed unless the array being assigned
+// may overlap an operand.
+//
+//===----------------------------------------------------------------------===//
+
+#include "CodeGenSubprogram.h"
+#include "CodeGenModule.h"
+#include "lfort/AST/ASTContext.h"
+#include "lfort/AST/Attr.h"
+#include "lfort/AST/Decl.h"
+#include "lfort/AST/Expr.h"
+#include "lfort/Basic/FortranIntrinsics.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/IR/Constants.h"
+using namespace lfort;
+using namespace CodeGen;
+
+/// Determine whether \p E references an elemental intrinsic procedure.
+static bool isElementalIntrinsicCall(const CallExpr *E) {
+  const SubprogramDecl *FD =
+    dyn_cast_or_null<SubprogramDecl>(E->getCalleeDecl());
+  if (!FD)
+    return false;
+  const FortranIntrinsicAttr *IA = FD->getAttr<FortranIntrinsicAttr>();
+  return IA &&
+         intrinsic::getInfo(static_cast<intrinsic::ID>(IA->getIntrinsicID()))
+           .Elemental;
+}
+
+bool CodeGenSubprogram::isFortranElementalExpr(const Expr *E) {
+  ASTContext &Ctx = getContext();
+  if (!Ctx.isFortranArrayType(E->getType()))
+    return false;
+
+  E = E->IgnoreParens();
+  if (const BinaryOperator *BO = dyn_cast<BinaryOperator>(E))
+    return BO->getOpcode() != BO_Assign;
+  if (isa<UnaryOperator>(E))
+    return true;
+  if (const ImplicitCastExpr *ICE = dyn_cast<ImplicitCastExpr>(E))
+    return Ctx.isFortranArrayType(ICE->getSubExpr()->getType());
+  if (const CallExpr *CE = dyn_cast<CallExpr>(E))
+    return isElementalIntrinsicCall(CE);
+  return false;
+}
+
+namespace {
+/// ArrayExprNode - A node of the elementwise form of an array expression.
+struct ArrayExprNode {
+  enum NodeKind {
+    /// A scalar operand, evaluated once before the loop.
+    Invariant,
+    /// An array operand in memory, whose elements are loaded in the loop.
+    Element,
+    /// A conversion of the elements of the operand.
+    Conversion,
+    /// An intrinsic operation or elemental intrinsic reference applied to
+    /// the elements of the operands.
+    Operation
+  };
+
+  NodeKind Kind;
+
+  /// The expression that this node evaluates.
+  const Expr *E;
+
+  /// The type of the elements of E, or the type of E if it is a scalar.
+  QualType EltTy;
+
+  /// The operands of a Conversion or an Operation.
+  SmallVector<ArrayExprNode *, 2> Operands;
+
+  /// Stands for the value of one element of E in the scalar form of the
+  /// node that uses it.
+  OpaqueValueExpr *Value;
+
+  /// The scalar form of an Operation, whose operands are the Values of the
+  /// operand nodes.
+  const Expr *ScalarE;
+
+  /// The address of the first element of an Element.
+  llvm::Value *Base;
+
+  /// The value of an Invariant.
+  RValue InvariantValue;
+};
+
+/// ArrayExprLowering - Lowers an array expression to its elementwise form
+/// and emits the loop that evaluates it.
+class ArrayExprLowering {
+  CodeGenSubprogram &CGF;
+  ASTContext &Ctx;
+  SmallVector<ArrayExprNode *, 8> Nodes;
+  bool Unsupported;
+
+  RValue emitElement(ArrayExprNode *N, llvm::Value *Index);
+  RValue convertElement(RValue V, QualType SrcTy, QualType DstTy);
+
+public:
+  ArrayExprLowering(CodeGenSubprogram &CGF)
+    : CGF(CGF), Ctx(CGF.getContext()), Unsupported(false) {}
+  ~ArrayExprLowering() { llvm::DeleteContainerPointers(Nodes); }
+
+  /// Build the elementwise form of \p E, emitting its scalar operands and
+  /// the addresses of its array operands.
+  ArrayExprNode *lower(const Expr *E);
+
+  /// Whether some element type of the expression cannot be evaluated one
+  /// element at a time.
+  bool isUnsupported() const { return Unsupported; }
+
+  /// Whether storing the elements of \p Dest in array element order may
+  /// change an element of an operand before it is loaded.
+  bool mayOverlap(const Expr *Dest) const;
+
+  /// Emit a loop that stores each of the \p NumElements elements of
+  /// \p Root to the array at \p Dest.
+  void emitLoop(ArrayExprNode *Root, llvm::Value *Dest, uint64_t NumElements);
+};
+} // end anonymous namespace
+
+ArrayExprNode *ArrayExprLowering::lower(const Expr *E) {
+  ArrayExprNode *N = new ArrayExprNode();
+  Nodes.push_back(N);
+  N->E = E;
+  N->EltTy = Ctx.getFortranScalarType(E->getType()).getUnqualifiedType();
+  N->Value = new (Ctx) OpaqueValueExpr(E->getExprLoc(), N->EltTy, VK_RValue);
+  N->ScalarE = 0;
+  N->Base = 0;
+
+  if (CodeGenSubprogram::hasAggregateLLVMType(N->EltTy) &&
+      !N->EltTy->isAnyComplexType())
+    Unsupported = true;
+
+  // Scalars are the same for every element.
+  if (!Ctx.isFortranArrayType(E->getType())) {
+    N->Kind = ArrayExprNode::Invariant;
+    if (!Unsupported)
+      N->InvariantValue = CGF.EmitAnyExpr(E);
+    return N;
+  }
+
+  if (CGF.isFortranElementalExpr(E)) {
+    E = E->IgnoreParens();
+    if (const ImplicitCastExpr *ICE = dyn_cast<ImplicitCastExpr>(E)) {
+      N->Kind = ArrayExprNode::Conversion;
+      N->Operands.push_back(lower(ICE->getSubExpr()));
+      return N;
+    }
+
+    N->Kind = ArrayExprNode::Operation;
+    if (const BinaryOperator *BO = dyn_cast<BinaryOperator>(E)) {
+      ArrayExprNode *LHS = lower(BO->getLHS());
+      ArrayExprNode *RHS = lower(BO->getRHS());
+      N->Operands.push_back(LHS);
+      N->Operands.push_back(RHS);
+      N->ScalarE = new (Ctx) BinaryOperator(LHS->Value, RHS->Value,
+                                            BO->getOpcode(), N->EltTy,
+                                            VK_RValue, OK_Ordinary,
+                                            BO->getOperatorLoc(),
+                                            BO->isFPContractable());
+    } else if (const UnaryOperator *UO = dyn_cast<UnaryOperator>(E)) {
+      ArrayExprNode *Sub = lower(UO->getSubExpr());
+      N->Operands.push_back(Sub);
+      N->ScalarE = new (Ctx) UnaryOperator(Sub->Value, UO->getOpcode(),
+                                           N->EltTy, VK_RValue, OK_Ordinary,
+                                           UO->getOperatorLoc());
+    } else {
+      const CallExpr *CE = cast<CallExpr>(E);
+      SmallVector<Expr *, 4> Args;
+      for (unsigned I = 0, NumArgs = CE->getNumArgs(); I != NumArgs; ++I) {
+        ArrayExprNode *Arg = lower(CE->getArg(I));
+        N->Operands.push_back(Arg);
+        Args.push_back(Arg->Value);
+      }
+      N->ScalarE = new (Ctx) CallExpr(Ctx, const_cast<Expr *>(CE->getCallee()),
+                                      Args, N->EltTy, VK_RValue,
+                                      CE->getRParenLoc());
+    }
+    return N;
+  }
+
+  // Any other array is an operand in memory.  Arrays that are not variables
+  // are evaluated into a temporary first.
+  E = E->IgnoreParens();
+  N->E = E;
+  N->Kind = ArrayExprNode::Element;
+  if (Unsupported)
+    return N;
+
+  llvm::Value *Addr;
+  if (E->isGLValue()) {
+    Addr = CGF.EmitLValue(E).getAddress();
+  } else {
+    Addr = CGF.CreateMemTemp(E->getType(), "array.tmp");
+    CharUnits Align = Ctx.getTypeAlignInChars(E->getType());
+    CGF.EmitAggExpr(E, AggValueSlot::forAddr(Addr, Align, Qualifiers(),
+                                        AggValueSlot::IsNotDestructed,
+                                        AggValueSlot::DoesNotNeedGCBarriers,
+                                        AggValueSlot::IsNotAliased));
+  }
+  N->Base = CGF.Builder.CreateBitCast(Addr,
+    CGF.ConvertTypeForMem(N->EltTy)->getPointerTo(), "array.base");
+  return N;
+}
+
+bool ArrayExprLowering::mayOverlap(const Expr *Dest) const {
+  Dest = Dest->IgnoreParens();
+  for (unsigned I = 0, NumNodes = Nodes.size(); I != NumNodes; ++I) {
+    const ArrayExprNode *N = Nodes[I];
+    if (N->Kind != ArrayExprNode::Element)
+      continue;
+
+    // Operands that are not variables were copied into temporaries.
+    const Expr *Src = N->E;
+    if (!Src->isGLValue())
+      continue;
+
+    // Distinct variables do not share storage, and every element of the
+    // array being assigned is loaded before the element of the same index
+    // is stored, so a whole variable never conflicts with another.
+    if (isa<DeclRefExpr>(Src) && isa<DeclRefExpr>(Dest))
+      continue;
+
+    return true;
+  }
+  return false;
+}
+
+RValue ArrayExprLowering::convertElement(RValue V, QualType SrcTy,
+                                         QualType DstTy) {
+  const ComplexType *SrcCT = SrcTy->getAs<ComplexType>();
+  const ComplexType *DstCT = DstTy->getAs<ComplexType>();
+
+  if (!SrcCT && !DstCT)
+    return RValue::get(CGF.EmitScalarConversion(V.getScalarVal(), SrcTy,
+                                                 DstTy));
+  if (!DstCT)
+    return RValue::get(CGF.EmitComplexToScalarConversion(V.getComplexVal(),
+                                                         SrcTy, DstTy));
+
+  QualType DstEltTy = DstCT->getElementType();
+  if (!SrcCT) {
+    llvm::Value *Real = CGF.EmitScalarConversion(V.getScalarVal(), SrcTy,
+                                                 DstEltTy);
+    return RValue::getComplex(Real, llvm::Constant::getNullValue(
+                                      Real->getType()));
+  }
+
+  QualType SrcEltTy = SrcCT->getElementType();
+  CodeGenSubprogram::ComplexPairTy C = V.getComplexVal();
+  return RValue::getComplex(
+    CGF.EmitScalarConversion(C.first, SrcEltTy, DstEltTy),
+    CGF.EmitScalarConversion(C.second, SrcEltTy, DstEltTy));
+}
+
+RValue ArrayExprLowering::emitElement(ArrayExprNode *N, llvm::Value *Index) {
+  switch (N->Kind) {
+  case ArrayExprNode::Invariant:
+    return N->InvariantValue;
+
+  case ArrayExprNode::Element: {
+    llvm::Value *Addr =
+      CGF.Builder.CreateInBoundsGEP(N->Base, Index, "array.elt");
+    if (N->EltTy->isAnyComplexType())
+      return RValue::getComplex(CGF.LoadComplexFromAddr(Addr, false));
+    return RValue::get(CGF.EmitLoadOfScalar(CGF.MakeAddrLValue(Addr,
+                                                               N->EltTy)));
+  }
+
+  case ArrayExprNode::Conversion: {
+    ArrayExprNode *Sub = N->Operands[0];
+    return convertElement(emitElement(Sub, Index), Sub->EltTy, N->EltTy);
+  }
+
+  case ArrayExprNode::Operation: {
+    // Evaluate the scalar form of the operation with its operands bound to
+    // their elements.
+    SmallVector<CodeGenSubprogram::OpaqueValueMappingData, 4> Bindings;
+    for (unsigned I = 0, NumOps = N->Operands.size(); I != NumOps; ++I) {
+      ArrayExprNode *Op = N->Operands[I];
+      Bindings.push_back(CodeGenSubprogram::OpaqueValueMappingData::bind(
+        CGF, Op->Value, emitElement(Op, Index)));
+    }
+    RValue Result = CGF.EmitAnyExpr(N->ScalarE);
+    for (unsigned I = 0, NumOps = Bindings.size(); I != NumOps; ++I)
+      Bindings[I].unbind(CGF);
+    return Result;
+  }
+  }
+  llvm_unreachable("bad array expression node");
+}
+
+void ArrayExprLowering::emitLoop(ArrayExprNode *Root, llvm::Value *Dest,
+                                 uint64_t NumElements) {
+  // Zero-sized arrays have nothing to assign.
+  if (!NumElements)
+    return;
+
+  CGBuilderTy &Builder = CGF.Builder;
+  llvm::Value *DestBase = Builder.CreateBitCast(Dest,
+    CGF.ConvertTypeForMem(Root->EltTy)->getPointerTo(), "array.dest");
+  llvm::Value *Zero = llvm::ConstantInt::get(CGF.SizeTy, 0);
+  llvm::Value *One = llvm::ConstantInt::get(CGF.SizeTy, 1);
+  llvm::Value *End = llvm::ConstantInt::get(CGF.SizeTy, NumElements);
+
+  // The elements are visited in array element order, which is the order of
+  // the elements in memory for all of the operands.  This is basically
+  //   i = 0; do { dest[i] = root(operands[i]...); } while (++i != n);
+  llvm::BasicBlock *EntryBB = Builder.GetInsertBlock();
+  llvm::BasicBlock *BodyBB = CGF.createBasicBlock("array.body");
+  CGF.EmitBlock(BodyBB);
+  llvm::PHINode *Index = Builder.CreatePHI(CGF.SizeTy, 2, "array.idx");
+  Index->addIncoming(Zero, EntryBB);
+
+  RValue Value = emitElement(Root, Index);
+  llvm::Value *Addr = Builder.CreateInBoundsGEP(DestBase, Index,
+                                                "array.dest.elt");
+  if (Root->EltTy->isAnyComplexType())
+    CGF.StoreComplexToAddr(Value.getComplexVal(), Addr, false);
+  else
+    CGF.EmitStoreOfScalar(Value.getScalarVal(),
+                          CGF.MakeAddrLValue(Addr, Root->EltTy));
+
+  llvm::Value *Next = Builder.CreateNUWAdd(Index, One, "array.next");
+  llvm::Value *Done = Builder.CreateICmpEQ(Next, End, "array.done");
+  llvm::BasicBlock *EndBB = CGF.createBasicBlock("array.end");
+  Builder.CreateCondBr(Done, EndBB, BodyBB);
+  Index->addIncoming(Next, Builder.GetInsertBlock());
+
+  CGF.EmitBlock(EndBB);
+}
+
+/// Compute the number of elements of the Fortran array type \p T.  Returns
+/// false if it is not known at compile time.
+static bool getNumFortranArrayElements(ASTContext &Ctx, QualType T,
+                                       uint64_t &NumElements) {
+  NumElements = 1;
+  while (Ctx.isFortranArrayType(T)) {
+    const ConstantArrayType *CAT = Ctx.getAsConstantArrayType(T);
+    if (!CAT)
+      return false;
+    NumElements *= CAT->getSize().getZExtValue();
+    T = CAT->getElementType();
+  }
+  return true;
+}
+
+LValue CodeGenSubprogram::EmitFortranArrayAssignment(const BinaryOperator *E) {
+  LValue LHS = EmitLValue(E->getLHS());
+
+  uint64_t NumElements;
+  if (!getNumFortranArrayElements(getContext(), E->getType(), NumElements)) {
+    ErrorUnsupported(E, "assignment to an array of unknown size");
+    return LHS;
+  }
+
+  ArrayExprLowering Lowering(*this);
+  ArrayExprNode *RHS = Lowering.lower(E->getRHS());
+  if (Lowering.isUnsupported()) {
+    ErrorUnsupported(E, "array assignment");
+    return LHS;
+  }
+
+  // Only store straight into the array being assigned if that cannot change
+  // an operand before all of its elements are used.
+  if (Lowering.mayOverlap(E->getLHS())) {
+    llvm::Value *Tmp = CreateMemTemp(E->getType(), "array.tmp");
+    Lowering.emitLoop(RHS, Tmp, NumElements);
+    EmitAggregateCopy(LHS.getAddress(), Tmp, E->getType(),
+                      LHS.isVolatileQualified(), LHS.getAlignment(),
+                      /*isAssignment=*/true);
+  } else {
+    Lowering.emitLoop(RHS, LHS.getAddress(), NumElements);
+  }
+  return LHS;
+}
+
+void CodeGenSubprogram::EmitFortranArrayExpr(const Expr *E,
+                                             llvm::Value *DestAddr) {
+  assert(isFortranElementalExpr(E) && "not an elementwise array expression");
+
+  uint64_t NumElements;
+  if (!getNumFortranArrayElements(getContext(), E->getType(), NumElements)) {
+    ErrorUnsupported(E, "array expression of unknown size");
+    return;
+  }
+
+  ArrayExprLowering Lowering(*this);
+  ArrayExprNode *Root = Lowering.lower(E);
+  if (Lowering.isUnsupported()) {
+    ErrorUnsupported(E, "array expression");
+    return;
+  }
+  Lowering.emitLoop(Root, DestAddr, NumElements);
+}
@@ -17,6 +17,7 @@
 #include "TargetInfo.h"
 #include "lfort/AST/ASTContext.h"
 #include "lfort/AST/Decl.h"
+#include "lfort/Basic/FortranIntrinsics.h"
 #include "lfort/Basic/TargetBuiltins.h"
 #include "lfort/Basic/TargetInfo.h"
 #include "llvm/IR/DataLayout.h"
@@ -1412,6 +1413,68 @@ RValue CodeGenSubprogram::EmitBuiltinExpr(const SubprogramDecl *FD,
   return RValue::get(llvm::UndefValue::get(ConvertType(E->getType())));
 }
 
+/// \brief Return the LLVM intrinsic that references to the given Fortran
+/// intrinsic procedure map onto, or Intrinsic::not_intrinsic.
+static Intrinsic::ID getLLVMIntrinsicForFortranIntrinsic(unsigned IntrinsicID) {
+  switch (IntrinsicID) {
+#define GET_FORTRAN_INTRINSIC_LLVM_IDS
+#include "lfort/Basic/FortranIntrinsics.inc"
+#undef GET_FORTRAN_INTRINSIC_LLVM_IDS
+  default:
+    return Intrinsic::not_intrinsic;
+  }
+}
+
+RValue CodeGenSubprogram::EmitFortranIntrinsicExpr(unsigned IntrinsicID,
+                                                   const CallExpr *E) {
+  Intrinsic::ID LLVMIntrinsicID =
+    getLLVMIntrinsicForFortranIntrinsic(IntrinsicID);
+  bool IsBitIntrinsic = LLVMIntrinsicID == Intrinsic::ctpop ||
+                        LLVMIntrinsicID == Intrinsic::ctlz ||
+                        LLVMIntrinsicID == Intrinsic::cttz;
+
+  // The LLVM intrinsics are overloaded on a scalar integer or floating-point
+  // type; elemental references to arrays, and complex arguments, are not
+  // lowered here.
+  QualType ArgType = E->getNumArgs() ? E->getArg(0)->getType() : QualType();
+  if (LLVMIntrinsicID != Intrinsic::not_intrinsic &&
+      !E->getType()->isArrayType() &&
+      (IsBitIntrinsic ? ArgType->isIntegerType()
+                      : ArgType->isRealFloatingType())) {
+    // Only the required arguments are operands; the KIND argument just
+    // selects the type of the result.
+    const intrinsic::Info &Info =
+      intrinsic::getInfo(static_cast<intrinsic::ID>(IntrinsicID));
+    SmallVector<Value *, 2> Args;
+    for (unsigned I = 0; I != Info.NumRequired; ++I)
+      Args.push_back(EmitScalarExpr(E->getArg(I)));
+
+    Value *F = CGM.getIntrinsic(LLVMIntrinsicID, Args[0]->getType());
+    // LEADZ and TRAILZ are defined for zero.
+    if (LLVMIntrinsicID == Intrinsic::ctlz || LLVMIntrinsicID == Intrinsic::cttz)
+      Args.push_back(Builder.getFalse());
+    Value *Result = Builder.CreateCall(F, Args);
+
+    llvm::Type *ResultType = ConvertType(E->getType());
+    if (Result->getType() != ResultType) {
+      if (IsBitIntrinsic)
+        Result = Builder.CreateIntCast(Result, ResultType, /*isSigned*/true,
+                                       "cast");
+      else
+        Result = Builder.CreateFPCast(Result, ResultType, "cast");
+    }
+    return RValue::get(Result);
+  }
+
+  ErrorUnsupported(E, "intrinsic procedure");
+
+  if (E->getType()->isVoidType())
+    return RValue::get(0);
+  if (hasAggregateLLVMType(E->getType()))
+    return RValue::getAggregate(CreateMemTemp(E->getType()));
+  return RValue::get(llvm::UndefValue::get(ConvertType(E->getType())));
+}
+
 Value *CodeGenSubprogram::EmitTargetBuiltinExpr(unsigned BuiltinID,
                                               const CallExpr *E) {
   switch (Target.getTriple().getArch()) {
@@ -1165,6 +1165,19 @@ static llvm::Value *emitArgumentDemotion(CodeGenSubprogram &CGF,
   return CGF.Builder.CreateFPCast(value, varType, "arg.unpromote");
 }
 
+/// Whether a parameter is a Fortran dummy argument passed by reference that
+/// may be marked 'noalias'.  While the procedure runs, storage that such a
+/// dummy argument modifies must not be reached through any other name, and
+/// storage reached through another name must not be modified through the
+/// dummy argument (F2008 12.5.2.13).  Volatile dummy arguments are exempt.
+static bool isNoAliasDummyArgument(CodeGenSubprogram &CGF,
+                                   const VarDecl *Arg) {
+  if (!CGF.getLangOpts().F90 || !isa<ParmVarDecl>(Arg))
+    return false;
+  const ReferenceType *RefTy = Arg->getType()->getAs<ReferenceType>();
+  return RefTy && !RefTy->getPointeeType().isVolatileQualified();
+}
+
 void CodeGenSubprogram::EmitSubprogramProlog(const CGSubprogramInfo &FI,
                                          llvm::Function *Fn,
                                          const SubprogramArgList &Args) {
@@ -1261,7 +1274,8 @@ void CodeGenSubprogram::EmitSubprogramProlog(const CGSubprogramInfo &FI,
         assert(AI != Fn->arg_end() && "Argument mismatch!");
         llvm::Value *V = AI;
 
-        if (Arg->getType().isRestrictQualified())
+        if (Arg->getType().isRestrictQualified() ||
+            isNoAliasDummyArgument(*this, Arg))
           AI->addAttr(llvm::Attribute::get(getLLVMContext(),
                                             llvm::Attribute::NoAlias));
 
@@ -0,0 +1,460 @@
+//===--- CGDoConcurrent.cpp - Emit LLVM Code for DO CONCURRENT ------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This contains code to emit DO CONCURRENT constructs.  The iterations of a
+// construct are independent, so its innermost loop is annotated as parallel,
+// which lets the loop vectorizer ignore the dependences it cannot disprove.
+// With -fparallel-do-concurrent the outermost loop is outlined and its
+// iterations are divided among the threads of the concurrent runtime
+// library.
+//
+//===----------------------------------------------------------------------===//
+
+#include "CodeGenSubprogram.h"
+#include "CodeGenModule.h"
+#include "lfort/AST/ASTContext.h"
+#include "lfort/AST/Decl.h"
+#include "lfort/AST/Stmt.h"
+#include "llvm/ADT/SetVector.h"
+#include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/DerivedTypes.h"
+#include "llvm/IR/Metadata.h"
+using namespace lfort;
+using namespace CodeGen;
+
+namespace {
+/// ConcurrentBounds - The iteration space of one index-name, as 64-bit
+/// integers.  The index takes the values Lower + k * Step for k in
+/// [0, Count).
+struct ConcurrentBounds {
+  llvm::Value *Lower;
+  llvm::Value *Step;
+  llvm::Value *Count;
+};
+
+/// ConcurrentLoopEmitter - Emits the loop nest that runs the iterations of
+/// a DO CONCURRENT construct.  The loop over the last index is outermost, so
+/// that the innermost loop walks the first dimension of arrays subscripted
+/// in index order.
+class ConcurrentLoopEmitter {
+  CodeGenSubprogram &CGF;
+  const DoConcurrentStmt &S;
+  ArrayRef<ConcurrentBounds> Bounds;
+  ArrayRef<llvm::Value *> Invariant;
+
+  void emitLevel(unsigned Level, llvm::Value *Begin, llvm::Value *End);
+  void emitBody(llvm::BasicBlock *NextBB);
+  void markParallel(llvm::BasicBlock *LoopBB, llvm::BranchInst *Latch);
+
+public:
+  /// \p Invariant holds the addresses of the variables that the construct
+  /// only loads.
+  ConcurrentLoopEmitter(CodeGenSubprogram &CGF, const DoConcurrentStmt &S,
+                        ArrayRef<ConcurrentBounds> Bounds,
+                        ArrayRef<llvm::Value *> Invariant)
+    : CGF(CGF), S(S), Bounds(Bounds), Invariant(Invariant) {}
+
+  /// Emit the loop nest, running the outermost loop over the iterations
+  /// [Begin, End) only.
+  void emit(llvm::Value *Begin, llvm::Value *End) {
+    emitLevel(Bounds.size() - 1, Begin, End);
+  }
+};
+} // end anonymous namespace
+
+/// Evaluate the limits of each index of \p S, in order, and compute its trip
+/// count max((upper - lower + step) / step, 0).
+static void EmitConcurrentBounds(CodeGenSubprogram &CGF,
+                                 const DoConcurrentStmt &S,
+                                 SmallVectorImpl<ConcurrentBounds> &Bounds) {
+  CGBuilderTy &Builder = CGF.Builder;
+  llvm::Value *Zero = llvm::ConstantInt::get(CGF.Int64Ty, 0);
+  for (unsigned I = 0, N = S.getNumIndices(); I != N; ++I) {
+    bool Signed = S.getIndexVar(I)->getType()->isSignedIntegerType();
+    ConcurrentBounds B;
+    B.Lower = Builder.CreateIntCast(CGF.EmitScalarExpr(S.getLower(I)),
+                                    CGF.Int64Ty, Signed, "concurrent.lower");
+    llvm::Value *Upper =
+      Builder.CreateIntCast(CGF.EmitScalarExpr(S.getUpper(I)), CGF.Int64Ty,
+                            Signed, "concurrent.upper");
+    if (const Expr *Step = S.getStep(I))
+      B.Step = Builder.CreateIntCast(CGF.EmitScalarExpr(Step), CGF.Int64Ty,
+                                     Signed, "concurrent.step");
+    else
+      B.Step = llvm::ConstantInt::get(CGF.Int64Ty, 1);
+
+    llvm::Value *Count = Builder.CreateSub(Upper, B.Lower);
+    Count = Builder.CreateSDiv(Builder.CreateAdd(Count, B.Step), B.Step);
+    B.Count = Builder.CreateSelect(Builder.CreateICmpSGT(Count, Zero), Count,
+                                   Zero, "concurrent.count");
+    Bounds.push_back(B);
+  }
+}
+
+void ConcurrentLoopEmitter::emitLevel(unsigned Level, llvm::Value *Begin,
+                                      llvm::Value *End) {
+  CGBuilderTy &Builder = CGF.Builder;
+  const ConcurrentBounds &B = Bounds[Level];
+
+  // This is basically
+  //   if (begin < end) {
+  //     k = begin;
+  //     do { index = lower + k * step; ... } while (++k != end);
+  //   }
+  llvm::BasicBlock *LoopBB = CGF.createBasicBlock("concurrent.body");
+  llvm::BasicBlock *NextBB = CGF.createBasicBlock("concurrent.next");
+  llvm::BasicBlock *EndBB = CGF.createBasicBlock("concurrent.end");
+  Builder.CreateCondBr(Builder.CreateICmpSLT(Begin, End), LoopBB, EndBB);
+
+  llvm::BasicBlock *EntryBB = Builder.GetInsertBlock();
+  CGF.EmitBlock(LoopBB);
+  llvm::PHINode *K = Builder.CreatePHI(CGF.Int64Ty, 2, "concurrent.iv");
+  K->addIncoming(Begin, EntryBB);
+
+  const VarDecl *Index = S.getIndexVar(Level);
+  QualType IndexTy = Index->getType();
+  llvm::Value *Value = Builder.CreateAdd(B.Lower, Builder.CreateMul(K, B.Step));
+  Value = Builder.CreateIntCast(Value, CGF.ConvertType(IndexTy),
+                                IndexTy->isSignedIntegerType(),
+                                Index->getName());
+  CGF.EmitStoreOfScalar(Value, CGF.MakeAddrLValue(CGF.GetAddrOfLocalVar(Index),
+                                                  IndexTy));
+
+  if (Level == 0)
+    emitBody(NextBB);
+  else
+    emitLevel(Level - 1, llvm::ConstantInt::get(CGF.Int64Ty, 0),
+              Bounds[Level - 1].Count);
+
+  CGF.EmitBlock(NextBB);
+  llvm::Value *Next = Builder.CreateNSWAdd(K, llvm::ConstantInt::get(
+                                                CGF.Int64Ty, 1),
+                                           "concurrent.iv.next");
+  llvm::BranchInst *Latch =
+    Builder.CreateCondBr(Builder.CreateICmpEQ(Next, End), EndBB, LoopBB);
+  K->addIncoming(Next, Builder.GetInsertBlock());
+
+  if (Level == 0)
+    markParallel(LoopBB, Latch);
+
+  CGF.EmitBlock(EndBB);
+}
+
+void ConcurrentLoopEmitter::emitBody(llvm::BasicBlock *NextBB) {
+  // Iterations for which the mask is false are skipped.
+  if (const Expr *Mask = S.getMask()) {
+    llvm::BasicBlock *ActiveBB = CGF.createBasicBlock("concurrent.active");
+    CGF.EmitBranchOnBoolExpr(Mask, ActiveBB, NextBB);
+    CGF.EmitBlock(ActiveBB);
+  }
+
+  CodeGenSubprogram::RunCleanupsScope BodyScope(CGF);
+  CGF.EmitStmt(S.getBody());
+}
+
+/// Annotate the loop whose header is \p LoopBB and whose latch ends with
+/// \p Latch as one whose iterations do not depend on each other, and ask
+/// for it to be vectorized.
+void ConcurrentLoopEmitter::markParallel(llvm::BasicBlock *LoopBB,
+                                         llvm::BranchInst *Latch) {
+  llvm::LLVMContext &Ctx = CGF.getLLVMContext();
+
+  // The loop ID is a distinct node whose first operand refers to itself.
+  llvm::Value *EnableOps[] = {
+    llvm::MDString::get(Ctx, "llvm.vectorizer.enable"),
+    llvm::ConstantInt::get(llvm::Type::getInt1Ty(Ctx), 1)
+  };
+  llvm::MDNode *Temp = llvm::MDNode::getTemporary(Ctx,
+                                                  ArrayRef<llvm::Value *>());
+  llvm::Value *LoopOps[] = { Temp, llvm::MDNode::get(Ctx, EnableOps) };
+  llvm::MDNode *LoopID = llvm::MDNode::get(Ctx, LoopOps);
+  LoopID->replaceOperandWith(0, LoopID);
+  llvm::MDNode::deleteTemporary(Temp);
+
+  Latch->setMetadata("llvm.loop", LoopID);
+  Latch->setMetadata("llvm.loop.parallel", LoopID);
+
+  // Each iteration has index-names of its own.  The values loaded from them
+  // and those computed from these are collected in Indexed.
+  llvm::SmallPtrSet<llvm::Value *, 4> IndexAddrs;
+  for (unsigned I = 0, N = S.getNumIndices(); I != N; ++I)
+    IndexAddrs.insert(CGF.GetAddrOfLocalVar(S.getIndexVar(I)));
+  llvm::SmallPtrSet<llvm::Value *, 4> InvariantAddrs(Invariant.begin(),
+                                                     Invariant.end());
+  llvm::SmallPtrSet<llvm::Value *, 16> Indexed;
+
+  // Only the accesses that cannot conflict with another iteration carry the
+  // annotation: those of the index-names, loads of variables the construct
+  // never modifies, and those of array elements whose subscripts depend on
+  // the index-names, which a conforming construct does not define in one
+  // iteration and reference in another.  Any other access, and any access
+  // already annotated by a nested construct, keeps this loop from being
+  // treated as parallel.
+  for (llvm::Function::iterator BB = LoopBB, E = CGF.CurFn->end(); BB != E;
+       ++BB)
+    for (llvm::BasicBlock::iterator I = BB->begin(), IE = BB->end(); I != IE;
+         ++I) {
+      if (!I->mayReadOrWriteMemory()) {
+        if (isa<llvm::PHINode>(I))
+          continue;
+        for (unsigned Op = 0, NumOps = I->getNumOperands(); Op != NumOps;
+             ++Op)
+          if (Indexed.count(I->getOperand(Op))) {
+            Indexed.insert(I);
+            break;
+          }
+        continue;
+      }
+      if (I->getMetadata("llvm.mem.parallel_loop_access"))
+        continue;
+
+      llvm::Value *Addr;
+      bool IsLoad = false;
+      if (llvm::LoadInst *Load = dyn_cast<llvm::LoadInst>(I)) {
+        Addr = Load->getPointerOperand();
+        IsLoad = true;
+      } else if (llvm::StoreInst *Store = dyn_cast<llvm::StoreInst>(I)) {
+        Addr = Store->getPointerOperand();
+      } else {
+        continue;
+      }
+
+      if (IndexAddrs.count(Addr)) {
+        if (IsLoad)
+          Indexed.insert(I);
+      } else if (!(IsLoad && InvariantAddrs.count(Addr)) &&
+                 !Indexed.count(Addr)) {
+        continue;
+      }
+      I->setMetadata("llvm.mem.parallel_loop_access", LoopID);
+    }
+}
+
+/// Collect the variables referenced in \p S, and in \p Modified those of
+/// them that \p S may modify: every one referenced other than to load its
+/// value.
+static void
+FindReferencedVars(const Stmt *S, llvm::SetVector<const VarDecl *> &Vars,
+                   llvm::SmallPtrSet<const VarDecl *, 8> &Modified) {
+  if (!S)
+    return;
+  // The index-names of a nested construct are defined by each of its
+  // iterations.
+  if (const DoConcurrentStmt *DC = dyn_cast<DoConcurrentStmt>(S))
+    for (unsigned I = 0, N = DC->getNumIndices(); I != N; ++I)
+      Modified.insert(DC->getIndexVar(I));
+  if (const ImplicitCastExpr *ICE = dyn_cast<ImplicitCastExpr>(S))
+    if (ICE->getCastKind() == CK_LValueToRValue)
+      if (const DeclRefExpr *DRE =
+            dyn_cast<DeclRefExpr>(ICE->getSubExpr()->IgnoreParens())) {
+        if (const VarDecl *VD = dyn_cast<VarDecl>(DRE->getDecl()))
+          Vars.insert(VD);
+        return;
+      }
+  if (const DeclRefExpr *DRE = dyn_cast<DeclRefExpr>(S))
+    if (const VarDecl *VD = dyn_cast<VarDecl>(DRE->getDecl())) {
+      Vars.insert(VD);
+      Modified.insert(VD);
+    }
+  for (Stmt::const_child_range C = S->children(); C; ++C)
+    FindReferencedVars(*C, Vars, Modified);
+}
+
+/// Determine whether \p VD is a scalar that the construct only loads, so
+/// that it has the same value in every iteration.
+static bool
+IsInvariantScalar(ASTContext &Ctx, const VarDecl *VD,
+                  const llvm::SmallPtrSet<const VarDecl *, 8> &Modified) {
+  QualType Ty = VD->getType();
+  return !Modified.count(VD) && !Ctx.isFortranArrayType(Ty) &&
+         Ty->isConstantSizeType();
+}
+
+void CodeGenSubprogram::EmitDoConcurrentStmt(const DoConcurrentStmt &S) {
+  if (CGM.getCodeGenOpts().ParallelDoConcurrent &&
+      !InDoConcurrentSubprogram && EmitOutlinedDoConcurrentStmt(S))
+    return;
+
+  llvm::SetVector<const VarDecl *> Referenced;
+  llvm::SmallPtrSet<const VarDecl *, 8> Modified;
+  FindReferencedVars(S.getMask(), Referenced, Modified);
+  FindReferencedVars(S.getBody(), Referenced, Modified);
+  SmallVector<llvm::Value *, 8> Invariant;
+  for (unsigned I = 0, N = Referenced.size(); I != N; ++I) {
+    const VarDecl *VD = Referenced[I];
+    if (VD->hasLocalStorage() && LocalDeclMap.count(VD) &&
+        IsInvariantScalar(getContext(), VD, Modified))
+      Invariant.push_back(LocalDeclMap[VD]);
+  }
+
+  SmallVector<ConcurrentBounds, 4> Bounds;
+  EmitConcurrentBounds(*this, S, Bounds);
+  for (unsigned I = 0, N = S.getNumIndices(); I != N; ++I)
+    EmitAutoVarDecl(*S.getIndexVar(I));
+  ConcurrentLoopEmitter(*this, S, Bounds, Invariant)
+    .emit(llvm::ConstantInt::get(Int64Ty, 0), Bounds.back().Count);
+}
+
+bool CodeGenSubprogram::EmitOutlinedDoConcurrentStmt(const DoConcurrentStmt &S) {
+  // The local variables of this function that the construct uses are passed
+  // by address.  The index-names of this construct and of nested ones are
+  // declared by the outlined function itself.
+  llvm::SetVector<const VarDecl *> Referenced;
+  llvm::SmallPtrSet<const VarDecl *, 8> Modified;
+  FindReferencedVars(S.getMask(), Referenced, Modified);
+  FindReferencedVars(S.getBody(), Referenced, Modified);
+  SmallVector<const VarDecl *, 8> Captures;
+  SmallVector<bool, 8> Private;
+  for (unsigned I = 0, N = Referenced.size(); I != N; ++I) {
+    const VarDecl *VD = Referenced[I];
+    if (!VD->hasLocalStorage() || !LocalDeclMap.count(VD))
+      continue;
+    if (VD->getType()->isVariablyModifiedType())
+      return false;
+    Captures.push_back(VD);
+    Private.push_back(IsInvariantScalar(getContext(), VD, Modified));
+  }
+
+  SmallVector<ConcurrentBounds, 4> Bounds;
+  EmitConcurrentBounds(*this, S, Bounds);
+
+  SmallVector<llvm::Type *, 16> Fields(Bounds.size() * 3, Int64Ty);
+  for (unsigned I = 0, N = Captures.size(); I != N; ++I)
+    Fields.push_back(LocalDeclMap[Captures[I]]->getType());
+  llvm::StructType *ContextTy =
+    llvm::StructType::get(getLLVMContext(), Fields);
+
+  llvm::Value *Context = CreateTempAlloca(ContextTy, "concurrent.ctx");
+  unsigned Field = 0;
+  for (unsigned I = 0, N = Bounds.size(); I != N; ++I) {
+    Builder.CreateStore(Bounds[I].Lower,
+                        Builder.CreateStructGEP(Context, Field++));
+    Builder.CreateStore(Bounds[I].Step,
+                        Builder.CreateStructGEP(Context, Field++));
+    Builder.CreateStore(Bounds[I].Count,
+                        Builder.CreateStructGEP(Context, Field++));
+  }
+  for (unsigned I = 0, N = Captures.size(); I != N; ++I)
+    Builder.CreateStore(LocalDeclMap[Captures[I]],
+                        Builder.CreateStructGEP(Context, Field++));
+
+  llvm::Function *Fn = CodeGenSubprogram(CGM, true)
+    .GenerateDoConcurrentSubprogram(S, ContextTy, Captures, Private,
+                                    LocalDeclMap, CurFn->getName());
+
+  // void __lfort_do_concurrent(void (*fn)(void *, i64, i64), void *ctx,
+  //                            i64 n);
+  llvm::Type *ArgTys[] = { Fn->getType(), Int8PtrTy, Int64Ty };
+  llvm::Constant *Runtime = CGM.CreateRuntimeSubprogram(
+    llvm::FunctionType::get(VoidTy, ArgTys, false), "__lfort_do_concurrent");
+  llvm::Value *Args[] = {
+    Fn, Builder.CreateBitCast(Context, Int8PtrTy), Bounds.back().Count
+  };
+  EmitCallOrInvoke(Runtime, Args);
+  return true;
+}
+
+llvm::Function *
+CodeGenSubprogram::GenerateDoConcurrentSubprogram(
+    const DoConcurrentStmt &S, llvm::StructType *ContextTy,
+    ArrayRef<const VarDecl *> Captures, ArrayRef<bool> Private,
+    const DeclMapTy &ParentDecls, StringRef ParentName) {
+  ASTContext &C = getContext();
+  InDoConcurrentSubprogram = true;
+
+  SubprogramArgList Args;
+  ImplicitParamDecl ContextDecl(0, SourceLocation(), 0, C.VoidPtrTy);
+  Args.push_back(&ContextDecl);
+  ImplicitParamDecl BeginDecl(0, SourceLocation(), 0, C.LongLongTy);
+  Args.push_back(&BeginDecl);
+  ImplicitParamDecl EndDecl(0, SourceLocation(), 0, C.LongLongTy);
+  Args.push_back(&EndDecl);
+
+  const CGSubprogramInfo &FI =
+    CGM.getTypes().arrangeSubprogramDeclaration(C.VoidTy, Args,
+                                                SubprogramType::ExtInfo(),
+                                                /*variadic*/ false);
+  llvm::FunctionType *LTy = CGM.getTypes().GetSubprogramType(FI);
+  llvm::Function *Fn =
+    llvm::Function::Create(LTy, llvm::GlobalValue::InternalLinkage,
+                           ParentName + ".do_concurrent", &CGM.getModule());
+
+  // Check if we should generate debug info for this function.
+  maybeInitializeDebugInfo();
+
+  IdentifierInfo *II = &C.Idents.get("do_concurrent");
+  SubprogramDecl *FD = SubprogramDecl::Create(C, C.getProgramDecl(),
+                                              S.getLocStart(),
+                                              S.getLocStart(), II, C.VoidTy,
+                                              0, SC_Static, SC_None,
+                                              false, false);
+  StartSubprogram(FD, C.VoidTy, Fn, FI, Args, S.getLocStart());
+
+  // Local statics and module variables are referenced directly, as in the
+  // parent.
+  for (DeclMapTy::const_iterator I = ParentDecls.begin(),
+         E = ParentDecls.end(); I != E; ++I) {
+    const VarDecl *Var = dyn_cast<VarDecl>(I->first);
+    if (Var && !Var->hasLocalStorage())
+      LocalDeclMap[Var] = I->second;
+  }
+
+  llvm::Value *Context = Builder.CreateLoad(GetAddrOfLocalVar(&ContextDecl));
+  Context = Builder.CreateBitCast(Context, ContextTy->getPointerTo(),
+                                  "concurrent.ctx");
+
+  SmallVector<ConcurrentBounds, 4> Bounds;
+  unsigned Field = 0;
+  for (unsigned I = 0, N = S.getNumIndices(); I != N; ++I) {
+    ConcurrentBounds B;
+    B.Lower = Builder.CreateLoad(Builder.CreateStructGEP(Context, Field++),
+                                 "concurrent.lower");
+    B.Step = Builder.CreateLoad(Builder.CreateStructGEP(Context, Field++),
+                                "concurrent.step");
+    B.Count = Builder.CreateLoad(Builder.CreateStructGEP(Context, Field++),
+                                 "concurrent.count");
+    Bounds.push_back(B);
+  }
+
+  // Variables are shared between the threads, so that the value a single
+  // iteration defines survives the construct.  Scalars that the construct
+  // only loads get a copy of their own, which does not alias anything.
+  SmallVector<llvm::Value *, 8> Invariant;
+  for (unsigned I = 0, N = Captures.size(); I != N; ++I) {
+    const VarDecl *VD = Captures[I];
+    QualType Ty = VD->getType();
+    llvm::Value *Addr =
+      Builder.CreateLoad(Builder.CreateStructGEP(Context, Field++),
+                         VD->getName() + ".shared");
+    if (Private[I]) {
+      llvm::Value *Copy = CreateMemTemp(Ty, VD->getName());
+      if (hasAggregateLLVMType(Ty))
+        EmitAggregateCopy(Copy, Addr, Ty);
+      else
+        EmitStoreOfScalar(EmitLoadOfScalar(MakeAddrLValue(Addr, Ty)),
+                          MakeAddrLValue(Copy, Ty));
+      Addr = Copy;
+      Invariant.push_back(Copy);
+    }
+    LocalDeclMap[VD] = Addr;
+  }
+
+  for (unsigned I = 0, N = S.getNumIndices(); I != N; ++I)
+    EmitAutoVarDecl(*S.getIndexVar(I));
+
+  llvm::Value *Begin = Builder.CreateLoad(GetAddrOfLocalVar(&BeginDecl),
+                                          "concurrent.begin");
+  llvm::Value *End = Builder.CreateLoad(GetAddrOfLocalVar(&EndDecl),
+                                        "concurrent.end");
+  ConcurrentLoopEmitter(*this, S, Bounds, Invariant).emit(Begin, End);
+
+  FinishSubprogram();
+  return Fn;
+}
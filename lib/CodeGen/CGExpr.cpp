@@ -1598,6 +1598,8 @@ static LValue EmitGlobalVarDeclLValue(CodeGenSubprogram &CGF,
     LV = CGF.MakeNaturalAlignAddrLValue(V, T);
   } else {
     LV = CGF.MakeAddrLValue(V, E->getType(), Alignment);
+    if (CGF.getLangOpts().F90 && LV.getTBAAInfo())
+      LV.setTBAAInfo(CGF.CGM.getTBAAInfoForVariable(VD));
   }
   setObjCGCLValueClass(CGF.getContext(), E, LV);
   return LV;
@@ -1697,6 +1699,8 @@ LValue CodeGenSubprogram::EmitDeclRefLValue(const DeclRefExpr *E) {
       LV = MakeNaturalAlignAddrLValue(V, T);
     } else {
       LV = MakeAddrLValue(V, T, Alignment);
+      if (getLangOpts().F90 && LV.getTBAAInfo())
+        LV.setTBAAInfo(CGM.getTBAAInfoForVariable(VD));
     }
 
     if (NonGCable) {
@@ -2106,6 +2110,7 @@ LValue CodeGenSubprogram::EmitArraySubscriptExpr(const ArraySubscriptExpr *E) {
   // size is a VLA or Objective-C interface.
   llvm::Value *Address = 0;
   CharUnits ArrayAlignment;
+  llvm::MDNode *ArrayTBAAInfo = 0;
   if (const VariableArrayType *vla =
         getContext().getAsVariableArrayType(E->getType())) {
     // The base must be a pointer, which is not an aggregate.  Emit
@@ -2155,6 +2160,12 @@ LValue CodeGenSubprogram::EmitArraySubscriptExpr(const ArraySubscriptExpr *E) {
     // Propagate the alignment from the array itself to the result.
     ArrayAlignment = ArrayLV.getAlignment();
 
+    // Elements of a Fortran array share the TBAA node of the variable or
+    // component that the array is, if it has one of its own.
+    if (getLangOpts().F90 &&
+        ArrayLV.getTBAAInfo() != CGM.getTBAAInfo(Array->getType()))
+      ArrayTBAAInfo = ArrayLV.getTBAAInfo();
+
     if (getLangOpts().isSignedOverflowDefined())
       Address = Builder.CreateGEP(ArrayPtr, Args, "arrayidx");
     else
@@ -2185,6 +2196,9 @@ LValue CodeGenSubprogram::EmitArraySubscriptExpr(const ArraySubscriptExpr *E) {
 
   LV.getQuals().setAddressSpace(E->getBase()->getType().getAddressSpace());
 
+  if (ArrayTBAAInfo && LV.getTBAAInfo())
+    LV.setTBAAInfo(ArrayTBAAInfo);
+
   if (getLangOpts().ObjC1 &&
       getLangOpts().getGC() != LangOptions::NonGC) {
     LV.setNonGC(!E->isOBJCGCCandidate(getContext()));
@@ -2379,6 +2393,8 @@ LValue CodeGenSubprogram::EmitLValueForField(LValue base,
   // and unions.
   if (mayAlias && LV.getTBAAInfo())
     LV.setTBAAInfo(CGM.getTBAAInfo(getContext().CharTy));
+  else if (getLangOpts().F90 && LV.getTBAAInfo())
+    LV.setTBAAInfo(CGM.getTBAAInfoForField(field));
 
   return LV;
 }
@@ -2701,6 +2717,8 @@ RValue CodeGenSubprogram::EmitCallExpr(const CallExpr *E,
   if (const SubprogramDecl *FD = dyn_cast_or_null<SubprogramDecl>(TargetDecl)) {
     if (unsigned builtinID = FD->getBuiltinID())
       return EmitBuiltinExpr(FD, builtinID, E);
+    if (const FortranIntrinsicAttr *IA = FD->getAttr<FortranIntrinsicAttr>())
+      return EmitFortranIntrinsicExpr(IA->getIntrinsicID(), E);
   }
 
   if (const CXXOperatorCallExpr *CE = dyn_cast<CXXOperatorCallExpr>(E))
@@ -2807,6 +2825,9 @@ LValue CodeGenSubprogram::EmitBinaryOperatorLValue(const BinaryOperator *E) {
   if (E->getType()->isAnyComplexType())
     return EmitComplexAssignmentLValue(E);
 
+  if (getContext().isFortranArrayType(E->getType()))
+    return EmitFortranArrayAssignment(E);
+
   return EmitAggExprToLValue(E);
 }
 
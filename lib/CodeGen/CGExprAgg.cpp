@@ -148,6 +148,13 @@ public:
   void VisitBinaryOperator(const BinaryOperator *BO);
   void VisitPointerToDataMemberBinaryOperator(const BinaryOperator *BO);
   void VisitBinAssign(const BinaryOperator *E);
+  void VisitUnaryOperator(UnaryOperator *E) {
+    if (CGF.isFortranElementalExpr(E))
+      VisitFortranElementalExpr(E);
+    else
+      VisitStmt(E);
+  }
+  void VisitFortranElementalExpr(const Expr *E);
   void VisitBinComma(const BinaryOperator *E);
 
   void VisitObjCMessageExpr(ObjCMessageExpr *E);
@@ -653,6 +660,11 @@ void AggExprEmitter::VisitCastExpr(CastExpr *E) {
 }
 
 void AggExprEmitter::VisitCallExpr(const CallExpr *E) {
+  if (CGF.isFortranElementalExpr(E)) {
+    VisitFortranElementalExpr(E);
+    return;
+  }
+
   if (E->getCallReturnType()->isReferenceType()) {
     EmitAggLoadOfLValue(E);
     return;
@@ -678,7 +690,9 @@ void AggExprEmitter::VisitStmtExpr(const StmtExpr *E) {
 }
 
 void AggExprEmitter::VisitBinaryOperator(const BinaryOperator *E) {
-  if (E->getOpcode() == BO_PtrMemD || E->getOpcode() == BO_PtrMemI)
+  if (CGF.isFortranElementalExpr(E))
+    VisitFortranElementalExpr(E);
+  else if (E->getOpcode() == BO_PtrMemD || E->getOpcode() == BO_PtrMemI)
     VisitPointerToDataMemberBinaryOperator(E);
   else
     CGF.ErrorUnsupported(E, "aggregate binary expression");
@@ -756,7 +770,18 @@ static bool isBlockVarRef(const Expr *E) {
   return false;
 }
 
+void AggExprEmitter::VisitFortranElementalExpr(const Expr *E) {
+  EnsureDest(E->getType());
+  CGF.EmitFortranArrayExpr(E, Dest.getAddr());
+}
+
 void AggExprEmitter::VisitBinAssign(const BinaryOperator *E) {
+  if (CGF.getContext().isFortranArrayType(E->getType())) {
+    LValue LHS = CGF.EmitFortranArrayAssignment(E);
+    EmitFinalDestCopy(E->getType(), LHS);
+    return;
+  }
+
   // For an assignment to work, the value on the right has
   // to be compatible with the value on the left.
   assert(CGF.getContext().hasSameUnqualifiedType(E->getLHS()->getType(),
@@ -18,6 +18,7 @@
 #include "llvm/ADT/SmallString.h"
 #include "llvm/IR/Constants.h"
 #include "llvm/IR/Function.h"
+#include "llvm/IR/Intrinsics.h"
 using namespace lfort;
 using namespace CodeGen;
 
@@ -508,11 +509,34 @@ ComplexPairTy ComplexExprEmitter::EmitBinSub(const BinOpInfo &Op) {
 }
 
 
+/// hasZeroImag - Whether the imaginary part of \p Val is known to be zero, as
+/// it is for a real operand converted to complex.
+static bool hasZeroImag(const ComplexPairTy &Val) {
+  llvm::Constant *Imag = dyn_cast<llvm::Constant>(Val.second);
+  return Imag && Imag->isNullValue();
+}
+
 ComplexPairTy ComplexExprEmitter::EmitBinMul(const BinOpInfo &Op) {
   using llvm::Value;
   Value *ResR, *ResI;
 
+  // Fortran has no counterpart of C99 Annex G, so the product is always
+  // computed inline, without recovering infinite results from NaNs.
   if (Op.LHS.first->getType()->isFloatingPointTy()) {
+    // A real operand multiplies each part of the other operand, which is
+    // mathematically equivalent to the product with its complex conversion
+    // (F2008 7.1.5.2.4).
+    if (hasZeroImag(Op.RHS)) {
+      ResR = Builder.CreateFMul(Op.LHS.first, Op.RHS.first, "mul.r");
+      ResI = Builder.CreateFMul(Op.LHS.second, Op.RHS.first, "mul.i");
+      return ComplexPairTy(ResR, ResI);
+    }
+    if (hasZeroImag(Op.LHS)) {
+      ResR = Builder.CreateFMul(Op.LHS.first, Op.RHS.first, "mul.r");
+      ResI = Builder.CreateFMul(Op.LHS.first, Op.RHS.second, "mul.i");
+      return ComplexPairTy(ResR, ResI);
+    }
+
     Value *ResRl = Builder.CreateFMul(Op.LHS.first, Op.RHS.first, "mul.rl");
     Value *ResRr = Builder.CreateFMul(Op.LHS.second, Op.RHS.second,"mul.rr");
     ResR  = Builder.CreateFSub(ResRl, ResRr, "mul.r");
@@ -538,7 +562,12 @@ ComplexPairTy ComplexExprEmitter::EmitBinDiv(const BinOpInfo &Op) {
 
 
   llvm::Value *DSTr, *DSTi;
-  if (Op.LHS.first->getType()->isFloatingPointTy()) {
+  if (Op.LHS.first->getType()->isFloatingPointTy() && hasZeroImag(Op.RHS)) {
+    // A real divisor divides each part.
+    DSTr = Builder.CreateFDiv(LHSr, RHSr, "div.r");
+    DSTi = Builder.CreateFDiv(LHSi, RHSr, "div.i");
+  } else if (Op.LHS.first->getType()->isFloatingPointTy() &&
+             CGF.getLangOpts().FastMath) {
     // (a+ib) / (c+id) = ((ac+bd)/(cc+dd)) + i((bc-ad)/(cc+dd))
     llvm::Value *Tmp1 = Builder.CreateFMul(LHSr, RHSr); // a*c
     llvm::Value *Tmp2 = Builder.CreateFMul(LHSi, RHSi); // b*d
@@ -552,8 +581,35 @@ ComplexPairTy ComplexExprEmitter::EmitBinDiv(const BinOpInfo &Op) {
     llvm::Value *Tmp8 = Builder.CreateFMul(LHSr, RHSi); // a*d
     llvm::Value *Tmp9 = Builder.CreateFSub(Tmp7, Tmp8); // bc-ad
 
-    DSTr = Builder.CreateFDiv(Tmp3, Tmp6);
-    DSTi = Builder.CreateFDiv(Tmp9, Tmp6);
+    DSTr = Builder.CreateFDiv(Tmp3, Tmp6, "div.r");
+    DSTi = Builder.CreateFDiv(Tmp9, Tmp6, "div.i");
+  } else if (Op.LHS.first->getType()->isFloatingPointTy()) {
+    // Smith's algorithm scales by the larger part of the divisor, so unlike
+    // cc+dd above nothing overflows or underflows before the result does.
+    // The two cases are selected between rather than branched to, which
+    // keeps loops over complex arrays vectorizable:
+    //   |c| >= |d|: r = d/c, e = c+dr, (a+br)/e + i((b-ar)/e)
+    //   |c| <  |d|: r = c/d, e = d+cr, (b+ar)/e + i(-(a-br)/e)
+    llvm::Value *Fabs = CGF.CGM.getIntrinsic(llvm::Intrinsic::fabs,
+                                             RHSr->getType());
+    llvm::Value *AbsC = Builder.CreateCall(Fabs, RHSr);
+    llvm::Value *AbsD = Builder.CreateCall(Fabs, RHSi);
+    llvm::Value *RealLarger = Builder.CreateFCmpOGE(AbsC, AbsD, "div.cmp");
+
+    llvm::Value *P = Builder.CreateSelect(RealLarger, RHSr, RHSi);
+    llvm::Value *Q = Builder.CreateSelect(RealLarger, RHSi, RHSr);
+    llvm::Value *X = Builder.CreateSelect(RealLarger, LHSr, LHSi);
+    llvm::Value *Y = Builder.CreateSelect(RealLarger, LHSi, LHSr);
+
+    llvm::Value *R = Builder.CreateFDiv(Q, P);
+    llvm::Value *Den = Builder.CreateFAdd(P, Builder.CreateFMul(Q, R));
+    llvm::Value *Tmp1 = Builder.CreateFAdd(X, Builder.CreateFMul(Y, R));
+    llvm::Value *Tmp2 = Builder.CreateFSub(Y, Builder.CreateFMul(X, R));
+
+    DSTr = Builder.CreateFDiv(Tmp1, Den, "div.r");
+    llvm::Value *Imag = Builder.CreateFDiv(Tmp2, Den);
+    DSTi = Builder.CreateSelect(RealLarger, Imag, Builder.CreateFNeg(Imag),
+                                "div.i");
   } else {
     // (a+ib) / (c+id) = ((ac+bd)/(cc+dd)) + i((bc-ad)/(cc+dd))
     llvm::Value *Tmp1 = Builder.CreateMul(LHSr, RHSr); // a*c
@@ -128,6 +128,9 @@ void CodeGenSubprogram::EmitStmt(const Stmt *S) {
   case Stmt::WhileStmtClass:    EmitWhileStmt(cast<WhileStmt>(*S));       break;
   case Stmt::DoStmtClass:       EmitDoStmt(cast<DoStmt>(*S));             break;
   case Stmt::ForStmtClass:      EmitForStmt(cast<ForStmt>(*S));           break;
+  case Stmt::DoConcurrentStmtClass:
+    EmitDoConcurrentStmt(cast<DoConcurrentStmt>(*S));
+    break;
 
   case Stmt::ReturnStmtClass:   EmitReturnStmt(cast<ReturnStmt>(*S));     break;
 
@@ -110,6 +110,10 @@ namespace lfort {
       return true;
     }
 
+    virtual bool needsSkippedSubprogramBodies() {
+      return Gen->needsSkippedSubprogramBodies();
+    }
+
     virtual void HandleProgram(ASTContext &C) {
       {
         PrettyStackTraceString CrashInfo("Per-file LLVM IR generation");
@@ -196,6 +196,18 @@ llvm::MDNode *CodeGenModule::getTBAAInfo(QualType QTy) {
   return TBAA->getTBAAInfo(QTy);
 }
 
+llvm::MDNode *CodeGenModule::getTBAAInfoForVariable(const VarDecl *VD) {
+  if (!TBAA)
+    return 0;
+  return TBAA->getTBAAInfoForVariable(VD);
+}
+
+llvm::MDNode *CodeGenModule::getTBAAInfoForField(const FieldDecl *FD) {
+  if (!TBAA)
+    return 0;
+  return TBAA->getTBAAInfoForField(FD);
+}
+
 llvm::MDNode *CodeGenModule::getTBAAInfoForVTablePtr() {
   if (!TBAA)
     return 0;
@@ -33,6 +33,7 @@ CodeGenSubprogram::CodeGenSubprogram(CodeGenModule &cgm, bool suppressNewContext
   : CodeGenTypeCache(cgm), CGM(cgm),
     Target(CGM.getContext().getTargetInfo()),
     Builder(cgm.getModule().getContext()),
+    InDoConcurrentSubprogram(false),
     SanitizePerformTypeCheck(CGM.getLangOpts().SanitizeNull |
                              CGM.getLangOpts().SanitizeAlignment |
                              CGM.getLangOpts().SanitizeObjectSize |
@@ -590,6 +590,11 @@ public:
   /// we prefer to insert allocas.
   llvm::AssertingVH<llvm::Instruction> AllocaInsertPt;
 
+  /// InDoConcurrentSubprogram - Whether the current function runs the
+  /// iterations of an outlined DO CONCURRENT construct.  Constructs nested
+  /// in it are emitted inline.
+  bool InDoConcurrentSubprogram;
+
   /// BoundsChecking - Emit run-time bounds checks. Higher values mean
   /// potentially higher performance penalties.
   unsigned char BoundsChecking;
@@ -2013,6 +2018,7 @@ public:
   void EmitWhileStmt(const WhileStmt &S);
   void EmitDoStmt(const DoStmt &S);
   void EmitForStmt(const ForStmt &S);
+  void EmitDoConcurrentStmt(const DoConcurrentStmt &S);
   void EmitReturnStmt(const ReturnStmt &S);
   void EmitDeclStmt(const DeclStmt &S);
   void EmitBreakStmt(const BreakStmt &S);
@@ -2296,6 +2302,10 @@ public:
   RValue EmitBuiltinExpr(const SubprogramDecl *FD,
                          unsigned BuiltinID, const CallExpr *E);
 
+  /// EmitFortranIntrinsicExpr - Emit a reference to a Fortran intrinsic
+  /// procedure, mapping it onto an LLVM intrinsic where there is one.
+  RValue EmitFortranIntrinsicExpr(unsigned IntrinsicID, const CallExpr *E);
+
   RValue EmitBlockCallExpr(const CallExpr *E, ReturnValueSlot ReturnValue);
 
   /// EmitTargetBuiltinExpr - Emit the given builtin call. Returns 0 if the call
@@ -2511,6 +2521,49 @@ public:
 
   RValue EmitAtomicExpr(AtomicExpr *E, llvm::Value *Dest = 0);
 
+  //===--------------------------------------------------------------------===//
+  //                       Array Expression Emission
+  //===--------------------------------------------------------------------===//
+
+  /// isFortranElementalExpr - Return true if \arg E is an intrinsic
+  /// operation or an elemental intrinsic reference that yields an array,
+  /// which is evaluated one element at a time.
+  bool isFortranElementalExpr(const Expr *E);
+
+  /// EmitFortranArrayAssignment - Emit an assignment to a whole Fortran
+  /// array.  The right-hand side is evaluated and stored one element at a
+  /// time in a single loop, through a temporary only if the array being
+  /// assigned may overlap one of its operands.
+  LValue EmitFortranArrayAssignment(const BinaryOperator *E);
+
+  /// EmitFortranArrayExpr - Evaluate the elementwise array expression
+  /// \arg E into the array at \arg DestAddr.
+  void EmitFortranArrayExpr(const Expr *E, llvm::Value *DestAddr);
+
+  //===--------------------------------------------------------------------===//
+  //                         DO CONCURRENT Emission
+  //===--------------------------------------------------------------------===//
+
+  /// EmitOutlinedDoConcurrentStmt - Emit \arg S as a call to the concurrent
+  /// runtime library, which runs the iterations of its outermost loop on a
+  /// thread pool.  Returns false, having emitted nothing, if the body uses
+  /// a variable that cannot be passed to another function.
+  bool EmitOutlinedDoConcurrentStmt(const DoConcurrentStmt &S);
+
+  /// GenerateDoConcurrentSubprogram - Generate the function that runs the
+  /// iterations [begin, end) of the outermost loop of \arg S.  Its first
+  /// argument points to a structure of type \arg ContextTy which holds the
+  /// first value, step and trip count of each index followed by the
+  /// addresses of the \arg Captures.  The captures for which \arg Private is
+  /// true are only loaded, and are copied on entry.
+  llvm::Function *
+  GenerateDoConcurrentSubprogram(const DoConcurrentStmt &S,
+                                 llvm::StructType *ContextTy,
+                                 ArrayRef<const VarDecl *> Captures,
+                                 ArrayRef<bool> Private,
+                                 const DeclMapTy &ParentDecls,
+                                 StringRef ParentName);
+
   //===--------------------------------------------------------------------===//
   //                         Annotations Emission
   //===--------------------------------------------------------------------===//
@@ -12,6 +12,7 @@
 //
 //   C99 6.5p7
 //   C++ [basic.lval] (p10 in n3126, p15 in some earlier versions)
+//   Fortran 2008 12.5.2.13, 16.5.3
 //
 //===----------------------------------------------------------------------===//
 
@@ -166,6 +167,58 @@ CodeGenTBAA::getTBAAInfo(QualType QTy) {
   return MetadataCache[Ty] = getChar();
 }
 
+llvm::MDNode *
+CodeGenTBAA::getTBAAInfoForStorage(const Decl *D, StringRef Name,
+                                   QualType QTy) {
+  if (llvm::MDNode *N = DeclMetadataCache[D])
+    return N;
+
+  // Storage of a type that aliases anything, such as a derived type or
+  // character storage, is described by its type alone.
+  llvm::MDNode *TypeNode = getTBAAInfo(Context.getBaseElementType(QTy));
+  if (!TypeNode || TypeNode == getChar() || Name.empty())
+    return getTBAAInfo(QTy);
+
+  return DeclMetadataCache[D] = MDHelper.createTBAANode(Name, TypeNode);
+}
+
+llvm::MDNode *CodeGenTBAA::getTBAAInfoForVariable(const VarDecl *VD) {
+  // A Fortran variable can only be reached through its name, or through a
+  // dummy argument associated with it.  Accesses through the dummy argument
+  // use the node for the type, which is the parent of the variable's node,
+  // so they still alias the variable; two different variables do not.
+  // Variables passed by reference are dummy arguments themselves.
+  // FIXME: TARGET and EQUIVALENCE variables will need the type node once
+  // they are supported.
+  if (!Features.F90 || VD->getType()->isReferenceType())
+    return getTBAAInfo(VD->getType());
+
+  // Same-named variables of different procedures share a node, which is
+  // merely conservative.  Module variables are reached under the same
+  // name from every program unit that uses the module.
+  SmallString<64> Name;
+  if (const NamespaceDecl *Module =
+        dyn_cast<NamespaceDecl>(VD->getDeclContext())) {
+    Name = Module->getName();
+    Name += "::";
+  }
+  Name += VD->getName();
+  return getTBAAInfoForStorage(VD, Name, VD->getType());
+}
+
+llvm::MDNode *CodeGenTBAA::getTBAAInfoForField(const FieldDecl *FD) {
+  // The components of a derived type never overlap one another.
+  const RecordDecl *RD = FD->getParent();
+  if (!Features.F90 || RD->isUnion() || !RD->getIdentifier() ||
+      !FD->getIdentifier())
+    return getTBAAInfo(FD->getType());
+
+  SmallString<64> Name(RD->getName());
+  Name += "%";
+  Name += FD->getName();
+  return getTBAAInfoForStorage(FD, Name, FD->getType());
+}
+
 llvm::MDNode *CodeGenTBAA::getTBAAInfoForVTablePtr() {
   return MDHelper.createTBAANode("vtable pointer", getRoot());
 }
@@ -27,10 +27,13 @@ namespace llvm {
 namespace lfort {
   class ASTContext;
   class CodeGenOptions;
+  class Decl;
+  class FieldDecl;
   class LangOptions;
   class MangleContext;
   class QualType;
   class Type;
+  class VarDecl;
 
 namespace CodeGen {
   class CGRecordLayout;
@@ -53,6 +56,10 @@ class CodeGenTBAA {
   /// them for struct assignments.
   llvm::DenseMap<const Type *, llvm::MDNode *> StructMetadataCache;
 
+  /// DeclMetadataCache - This maps Fortran variables and components to the
+  /// llvm::MDNodes that separate them from other storage of the same type.
+  llvm::DenseMap<const Decl *, llvm::MDNode *> DeclMetadataCache;
+
   llvm::MDNode *Root;
   llvm::MDNode *Char;
 
@@ -64,6 +71,12 @@ class CodeGenTBAA {
   /// considered to be equivalent to it.
   llvm::MDNode *getChar();
 
+  /// getTBAAInfoForStorage - Get a node, below the node for the scalar type
+  /// of \p QTy, for storage that only the named entity can reach.  Fall
+  /// back to the node for \p QTy when it has no scalar type node.
+  llvm::MDNode *getTBAAInfoForStorage(const Decl *D, StringRef Name,
+                                      QualType QTy);
+
   /// CollectFields - Collect information about the fields of a type for
   /// !tbaa.struct metadata formation. Return false for an unsupported type.
   bool CollectFields(uint64_t BaseOffset,
@@ -82,6 +95,14 @@ public:
   /// of the given type.
   llvm::MDNode *getTBAAInfo(QualType QTy);
 
+  /// getTBAAInfoForVariable - Get the TBAA MDNode to be used for a
+  /// dereference of the Fortran variable \p VD, or of an element of it.
+  llvm::MDNode *getTBAAInfoForVariable(const VarDecl *VD);
+
+  /// getTBAAInfoForField - Get the TBAA MDNode to be used for a dereference
+  /// of the derived-type component \p FD, or of an element of it.
+  llvm::MDNode *getTBAAInfoForField(const FieldDecl *FD);
+
   /// getTBAAInfoForVTablePtr - Get the TBAA MDNode to be used for a
   /// dereference of a vtable pointer.
   llvm::MDNode *getTBAAInfoForVTablePtr();
@@ -70,6 +70,12 @@ namespace {
       return true;
     }
 
+    /// Every program unit that is defined has to be emitted, so bodies that
+    /// were skipped are needed after all.
+    virtual bool needsSkippedSubprogramBodies() {
+      return true;
+    }
+
     /// HandleTagDeclDefinition - This callback is invoked each time a TagDecl
     /// to (e.g. struct, union, enum, class) is completed. This allows the
     /// client hack on the type, which can occur at any point in the file
@@ -220,6 +220,21 @@ static void addProfileRT(const ToolChain &TC, const ArgList &Args,
   CmdArgs.push_back(Args.MakeArgString(ProfileRT));
 }
 
+static void addDoConcurrentRT(const ToolChain &TC, const ArgList &Args,
+                              ArgStringList &CmdArgs) {
+  if (!Args.hasFlag(options::OPT_fparallel_do_concurrent,
+                    options::OPT_fno_parallel_do_concurrent, false))
+    return;
+
+  // The runtime library is installed next to libprofile_rt.a and runs the
+  // outlined iterations on POSIX threads.
+  std::string DoConcurrentRT =
+    std::string(TC.getDriver().Dir) + "/../lib/libconcurrent_rt.a";
+
+  CmdArgs.push_back(Args.MakeArgString(DoConcurrentRT));
+  CmdArgs.push_back("-lpthread");
+}
+
 static bool forwardToGCC(const Option &O) {
   return !O.hasFlag(options::NoForward) &&
          !O.hasFlag(options::DriverOption) &&
@@ -389,6 +404,7 @@ void LFort::AddPreprocessingOptions(Compilation &C,
   Args.AddAllArgs(CmdArgs, options::OPT_D, options::OPT_U);
   Args.AddAllArgs(CmdArgs, options::OPT_I_Group, options::OPT_F,
                   options::OPT_index_header_map);
+  Args.AddLastArg(CmdArgs, options::OPT_J);
 
   // Add -Wp, and -Xassembler if using the preprocessor.
 
@@ -1826,6 +1842,9 @@ void LFort::ConstructJob(Compilation &C, const JobAction &JA,
   if (Args.hasFlag(options::OPT_fstrict_enums, options::OPT_fno_strict_enums,
                    false))
     CmdArgs.push_back("-fstrict-enums");
+  if (Args.hasFlag(options::OPT_fparallel_do_concurrent,
+                   options::OPT_fno_parallel_do_concurrent, false))
+    CmdArgs.push_back("-fparallel-do-concurrent");
   if (!Args.hasFlag(options::OPT_foptimize_sibling_calls,
                     options::OPT_fno_optimize_sibling_calls))
     CmdArgs.push_back("-mdisable-tail-calls");
@@ -2131,6 +2150,9 @@ void LFort::ConstructJob(Compilation &C, const JobAction &JA,
   CmdArgs.push_back(D.ResourceDir.c_str());
 
   Args.AddLastArg(CmdArgs, options::OPT_working_directory);
+  Args.AddLastArg(CmdArgs, options::OPT_fdirectory_listing_cache);
+  Args.AddLastArg(CmdArgs, options::OPT_fdirectory_listing_cache_path);
+  Args.AddLastArg(CmdArgs, options::OPT_fmap_source_files);
 
   bool ARCMTEnabled = false;
   if (!Args.hasArg(options::OPT_fno_objc_arc)) {
@@ -2846,6 +2868,24 @@ void LFort::ConstructJob(Compilation &C, const JobAction &JA,
       CmdArgs.push_back("-ffree-form");
   }
 
+  // -ffold-identifier-case/-fno-fold-identifier-case.
+  if (Arg *A = Args.getLastArg(options::OPT_ffold_identifier_case,
+                               options::OPT_fno_fold_identifier_case)) {
+    if (A->getOption().matches(options::OPT_ffold_identifier_case))
+      CmdArgs.push_back("-ffold-identifier-case");
+    else
+      CmdArgs.push_back("-fno-fold-identifier-case");
+  }
+
+  // -fjoin-continuation-lines/-fno-join-continuation-lines.
+  if (Arg *A = Args.getLastArg(options::OPT_fjoin_continuation_lines,
+                               options::OPT_fno_join_continuation_lines)) {
+    if (A->getOption().matches(options::OPT_fjoin_continuation_lines))
+      CmdArgs.push_back("-fjoin-continuation-lines");
+    else
+      CmdArgs.push_back("-fno-join-continuation-lines");
+  }
+
   // -funit-at-a-time is default, and we don't support -fno-unit-at-a-time for
   // practical purposes.
   if (Arg *A = Args.getLastArg(options::OPT_funit_at_a_time,
@@ -4170,6 +4210,8 @@ void darwin::Link::ConstructJob(Compilation &C, const JobAction &JA,
   if (Args.hasArg(options::OPT_fnested_functions))
     CmdArgs.push_back("-allow_stack_execute");
 
+  addDoConcurrentRT(getToolChain(), Args, CmdArgs);
+
   if (!Args.hasArg(options::OPT_nostdlib) &&
       !Args.hasArg(options::OPT_nodefaultlibs)) {
     getToolChain().AddFortRTLibArgs(Args, CmdArgs);
@@ -4382,6 +4424,7 @@ void solaris::Link::ConstructJob(Compilation &C, const JobAction &JA,
   CmdArgs.push_back(Args.MakeArgString(LibPath + "crtn.o"));
 
   addProfileRT(getToolChain(), Args, CmdArgs, getToolChain().getTriple());
+  addDoConcurrentRT(getToolChain(), Args, CmdArgs);
 
   const char *Exec =
     Args.MakeArgString(getToolChain().GetProgramPath("ld"));
@@ -4494,6 +4537,7 @@ void auroraux::Link::ConstructJob(Compilation &C, const JobAction &JA,
   }
 
   addProfileRT(getToolChain(), Args, CmdArgs, getToolChain().getTriple());
+  addDoConcurrentRT(getToolChain(), Args, CmdArgs);
 
   const char *Exec =
     Args.MakeArgString(getToolChain().GetProgramPath("ld"));
@@ -4641,6 +4685,8 @@ void openbsd::Link::ConstructJob(Compilation &C, const JobAction &JA,
                               getToolChain().GetFilePath("crtendS.o")));
   }
 
+  addDoConcurrentRT(getToolChain(), Args, CmdArgs);
+
   const char *Exec =
     Args.MakeArgString(getToolChain().GetProgramPath("ld"));
   C.addCommand(new Command(JA, *this, Exec, CmdArgs));
@@ -4781,6 +4827,8 @@ void bitrig::Link::ConstructJob(Compilation &C, const JobAction &JA,
                               getToolChain().GetFilePath("crtendS.o")));
   }
 
+  addDoConcurrentRT(getToolChain(), Args, CmdArgs);
+
   const char *Exec =
     Args.MakeArgString(getToolChain().GetProgramPath("ld"));
   C.addCommand(new Command(JA, *this, Exec, CmdArgs));
@@ -5034,6 +5082,7 @@ void freebsd::Link::ConstructJob(Compilation &C, const JobAction &JA,
   }
 
   addProfileRT(ToolChain, Args, CmdArgs, ToolChain.getTriple());
+  addDoConcurrentRT(ToolChain, Args, CmdArgs);
 
   const char *Exec =
     Args.MakeArgString(ToolChain.GetProgramPath("ld"));
@@ -5182,6 +5231,7 @@ void netbsd::Link::ConstructJob(Compilation &C, const JobAction &JA,
   }
 
   addProfileRT(getToolChain(), Args, CmdArgs, getToolChain().getTriple());
+  addDoConcurrentRT(getToolChain(), Args, CmdArgs);
 
   const char *Exec = Args.MakeArgString(getToolChain().GetProgramPath("ld"));
   C.addCommand(new Command(JA, *this, Exec, CmdArgs));
@@ -5539,6 +5589,7 @@ void linuxtools::Link::ConstructJob(Compilation &C, const JobAction &JA,
   }
 
   addProfileRT(getToolChain(), Args, CmdArgs, getToolChain().getTriple());
+  addDoConcurrentRT(getToolChain(), Args, CmdArgs);
 
   C.addCommand(new Command(JA, *this, ToolChain.Linker.c_str(), CmdArgs));
 }
@@ -5597,6 +5648,7 @@ void minix::Link::ConstructJob(Compilation &C, const JobAction &JA,
   AddLinkerInputs(getToolChain(), Inputs, Args, CmdArgs);
 
   addProfileRT(getToolChain(), Args, CmdArgs, getToolChain().getTriple());
+  addDoConcurrentRT(getToolChain(), Args, CmdArgs);
 
   if (!Args.hasArg(options::OPT_nostdlib) &&
       !Args.hasArg(options::OPT_nodefaultlibs)) {
@@ -5768,6 +5820,7 @@ void dragonfly::Link::ConstructJob(Compilation &C, const JobAction &JA,
   }
 
   addProfileRT(getToolChain(), Args, CmdArgs, getToolChain().getTriple());
+  addDoConcurrentRT(getToolChain(), Args, CmdArgs);
 
   const char *Exec =
     Args.MakeArgString(getToolChain().GetProgramPath("ld"));
@@ -57,9 +57,11 @@ public:
 
 class PTHEntryKeyVariant {
   union { const FileEntry* FE; const char* Path; };
-  enum { IsFE = 0x1, IsDE = 0x2, IsNoExist = 0x0 } Kind;
+  enum { IsFE = 0x1, IsDE = 0x2, IsContent = 0x3, IsNoExist = 0x0 } Kind;
   struct stat *StatBuf;
 public:
+  enum ContentKeyTag { ContentKey };
+
   PTHEntryKeyVariant(const FileEntry *fe)
     : FE(fe), Kind(IsFE), StatBuf(0) {}
 
@@ -69,8 +71,15 @@ public:
   explicit PTHEntryKeyVariant(const char* path)
     : Path(path), Kind(IsNoExist), StatBuf(0) {}
 
+  /// A key naming a file by its contents (see PTHManager::getContentKey)
+  /// rather than by its path.
+  PTHEntryKeyVariant(ContentKeyTag, const char* key)
+    : Path(key), Kind(IsContent), StatBuf(0) {}
+
   bool isFile() const { return Kind == IsFE; }
 
+  bool hasTokenData() const { return Kind == IsFE || Kind == IsContent; }
+
   StringRef getString() const {
     return Kind == IsFE ? FE->getName() : Path;
   }
@@ -102,7 +111,7 @@ public:
   }
 
   unsigned getRepresentationLength() const {
-    return Kind == IsNoExist ? 0 : 4 + 4 + 2 + 8 + 8;
+    return Kind == IsNoExist || Kind == IsContent ? 0 : 4 + 4 + 2 + 8 + 8;
   }
 };
 
@@ -125,7 +134,7 @@ public:
     unsigned n = V.getString().size() + 1 + 1;
     ::Emit16(Out, n);
 
-    unsigned m = V.getRepresentationLength() + (V.isFile() ? 4 + 4 : 0);
+    unsigned m = V.getRepresentationLength() + (V.hasTokenData() ? 4 + 4 : 0);
     ::Emit8(Out, m);
 
     return std::make_pair(n, m);
@@ -142,9 +151,9 @@ public:
                        const PTHEntry& E, unsigned) {
 
 
-    // For file entries emit the offsets into the PTH file for token data
-    // and the preprocessor blocks table.
-    if (V.isFile()) {
+    // For file and content entries emit the offsets into the PTH file for
+    // token data and the preprocessor blocks table.
+    if (V.hasTokenData()) {
       ::Emit32(Out, E.getTokenOffset());
       ::Emit32(Out, E.getPPCondTableOffset());
     }
@@ -180,6 +189,7 @@ class PTHWriter {
   CachedStrsTy CachedStrs;
   Offset CurStrOffset;
   std::vector<llvm::StringMapEntry<OffsetOpt>*> StrEntries;
+  llvm::StringMap<char, llvm::BumpPtrAllocator> ContentKeys;
 
   //// Get the persistent id for the given IdentifierInfo*.
   uint32_t ResolveID(const IdentifierInfo* II);
@@ -238,9 +248,12 @@ uint32_t PTHWriter::ResolveID(const IdentifierInfo* II) {
 }
 
 void PTHWriter::EmitToken(const Token& T) {
-  // Emit the token kind, flags, and length.
-  Emit32(((uint32_t) T.getKind()) | ((((uint32_t) T.getFlags())) << 8)|
-         (((uint32_t) T.getLength()) << 16));
+  assert(T.getKind() < 0x10000 && T.getFlags() < 0x100 &&
+         "Token kind or flags do not fit in the PTH token format");
+  // Emit the token kind and flags, then the length.  The Fortran keywords
+  // take the kind well past 8 bits, so it gets a full 16.
+  Emit32(((uint32_t) T.getKind()) | (((uint32_t) T.getFlags()) << 16));
+  Emit32(T.getLength());
 
   if (!T.isLiteral()) {
     Emit32(ResolveID(T.getIdentifierInfo()));
@@ -279,6 +292,7 @@ PTHEntry PTHWriter::LexTokens(Lexer& L) {
   PPCondTable PPCond;
   std::vector<unsigned> PPStartCond;
   bool ParsingPreprocessorDirective = false;
+  bool AfterStmtLabel = false;
   Token Tok;
 
   do {
@@ -299,9 +313,41 @@ PTHEntry PTHWriter::LexTokens(Lexer& L) {
       ParsingPreprocessorDirective = false;
     }
 
+    // The raw lexer leaves statement labels alone.  Cache them as tokens of
+    // their own, in the form PTHLexer turns back into a label: a numeric
+    // constant of at most five digits at the start of a line.
+    if (Tok.hasStmtLabel()) {
+      // A fixed-form label is read from columns 1-5 by the lexer and never
+      // forms a token.
+      SmallString<8> Spelling;
+      Spelling += llvm::utostr_32(Tok.getStmtLabel());
+
+      Token Label;
+      Label.startToken();
+      Label.setKind(tok::numeric_constant);
+      Label.setFlag(Token::StartOfLine);
+      Label.setLocation(Tok.getLocation());
+      Label.setLiteralData(Spelling.data());
+      Label.setLength(Spelling.size());
+      EmitToken(Label);
+    } else if (AfterStmtLabel) {
+      // A free-form label leaves the statement at the start of its line.
+      Tok.setFlag(Token::StartOfLine);
+    }
+    AfterStmtLabel = Tok.is(tok::numeric_constant) && Tok.isAtStartOfLine() &&
+                     Tok.getLength() <= 5;
+
     if (Tok.is(tok::raw_identifier)) {
-      PP.LookUpIdentifierInfo(Tok);
+      IdentifierInfo *II = PP.LookUpIdentifierInfo(Tok);
       EmitToken(Tok);
+
+      // A Fortran INCLUDE line is terminated with an eod token, just like a
+      // '#include' directive, so that PTHLexer can hand it to
+      // Preprocessor::HandleDirective.
+      if (!ParsingPreprocessorDirective && Tok.isAtStartOfLine() &&
+          (II->getTokenID() == tok::kw_include ||
+           II->getName().equals_lower("include")))
+        ParsingPreprocessorDirective = true;
       continue;
     }
 
@@ -484,7 +530,19 @@ void PTHWriter::GeneratePTH(const std::string &MainFile) {
     FileID FID = SM.createFileID(FE, SourceLocation(), SrcMgr::C_User);
     const llvm::MemoryBuffer *FromFile = SM.getBuffer(FID);
     Lexer L(FID, FromFile, SM, LOpts);
-    PM.insert(FE, LexTokens(L));
+    PTHEntry Entry = LexTokens(L);
+    PM.insert(FE, Entry);
+
+    // Also file the tokens under the contents of the file, so that the same
+    // INCLUDE file reached through a different path can use them.
+    SmallString<64> Key;
+    PTHManager::getContentKey(FromFile->getBuffer(), LOpts.FreeForm, Key);
+    llvm::StringMapEntry<char> &KE = ContentKeys.GetOrCreateValue(Key);
+    if (!KE.getValue()) {
+      KE.setValue(1);
+      PM.insert(PTHEntryKeyVariant(PTHEntryKeyVariant::ContentKey,
+                                   KE.getKeyData()), Entry);
+    }
   }
 
   // Write out the identifier table.
@@ -259,6 +259,9 @@ void CompilerInstance::createPreprocessor() {
     PP->setPTHManager(PTHMgr);
   }
 
+  // Report columns of fixed-form source as card columns.
+  getSourceManager().setFixedFormColumns(!getLangOpts().FreeForm);
+
   if (PPOpts.DetailedRecord)
     PP->createPreprocessingRecord();
 
@@ -771,6 +774,11 @@ static void compilePCModule(CompilerInstance &ImportingInstance,
                           SourceLocation ImportLoc,
                           PCModule *PCModule,
                           StringRef PCModuleFileName) {
+  // Whether we build the module or someone else does, the module file will
+  // appear in a directory whose listing may already be cached.
+  ImportingInstance.getFileManager().invalidateDirectoryListing(
+    PCModuleFileName);
+
   llvm::LockFileManager Locked(PCModuleFileName);
   switch (Locked) {
   case llvm::LockFileManager::LFS_Error:
@@ -895,6 +903,33 @@ static void compilePCModule(CompilerInstance &ImportingInstance,
     llvm::sys::Path(TempPCModuleMapFileName).eraseFromDisk();
 }
 
+void CompilerInstance::createPCModuleManager() {
+  assert(!PCModuleManager && "Already have an ASTReader for modules");
+  if (!hasASTContext())
+    createASTContext();
+
+  std::string Sysroot = getHeaderSearchOpts().Sysroot;
+  const PreprocessorOptions &PPOpts = getPreprocessorOpts();
+  PCModuleManager = new ASTReader(getPreprocessor(), *Context,
+                                Sysroot.empty() ? "" : Sysroot.c_str(),
+                                PPOpts.DisablePCHValidation);
+  if (hasASTConsumer()) {
+    PCModuleManager->setDeserializationListener(
+      getASTConsumer().GetASTDeserializationListener());
+    getASTContext().setASTMutationListener(
+      getASTConsumer().GetASTMutationListener());
+    getPreprocessor().setPPMutationListener(
+      getASTConsumer().GetPPMutationListener());
+  }
+  OwningPtr<ExternalASTSource> Source;
+  Source.reset(PCModuleManager);
+  getASTContext().setExternalSource(Source);
+  if (hasSema())
+    PCModuleManager->InitializeSema(getSema());
+  if (hasASTConsumer())
+    PCModuleManager->StartProgram(&getASTConsumer());
+}
+
 PCModuleLoadResult
 CompilerInstance::loadPCModule(SourceLocation ImportLoc,
                              PCModuleIdPath Path,
@@ -1002,31 +1037,8 @@ CompilerInstance::loadPCModule(SourceLocation ImportLoc,
     }
 
     // If we don't already have an ASTReader, create one now.
-    if (!PCModuleManager) {
-      if (!hasASTContext())
-        createASTContext();
-
-      std::string Sysroot = getHeaderSearchOpts().Sysroot;
-      const PreprocessorOptions &PPOpts = getPreprocessorOpts();
-      PCModuleManager = new ASTReader(getPreprocessor(), *Context,
-                                    Sysroot.empty() ? "" : Sysroot.c_str(),
-                                    PPOpts.DisablePCHValidation);
-      if (hasASTConsumer()) {
-        PCModuleManager->setDeserializationListener(
-          getASTConsumer().GetASTDeserializationListener());
-        getASTContext().setASTMutationListener(
-          getASTConsumer().GetASTMutationListener());
-        getPreprocessor().setPPMutationListener(
-          getASTConsumer().GetPPMutationListener());
-      }
-      OwningPtr<ExternalASTSource> Source;
-      Source.reset(PCModuleManager);
-      getASTContext().setExternalSource(Source);
-      if (hasSema())
-        PCModuleManager->InitializeSema(getSema());
-      if (hasASTConsumer())
-        PCModuleManager->StartProgram(&getASTConsumer());
-    }
+    if (!PCModuleManager)
+      createPCModuleManager();
 
     // Try to load the module we found.
     unsigned ARRFlags = ASTReader::ARR_None;
@@ -1206,3 +1218,62 @@ CompilerInstance::loadPCModule(SourceLocation ImportLoc,
   LastPCModuleImportResult = PCModuleLoadResult(PCModule, false);
   return LastPCModuleImportResult;
 }
+
+bool CompilerInstance::readFortranModuleFile(const FileEntry *File,
+                                             SourceLocation Loc,
+                                             StringRef Name) {
+  if (!PCModuleManager)
+    createPCModuleManager();
+
+  // Only the module file's control block and indexes are read here; the
+  // declarations in it are read as lookups find them.
+  switch (PCModuleManager->ReadAST(File->getName(),
+                                   serialization::MK_PCModule, Loc,
+                                   ASTReader::ARR_OutOfDate)) {
+  case ASTReader::Success:
+    return true;
+
+  case ASTReader::OutOfDate:
+    getDiagnostics().Report(Loc, diag::err_fortran_module_file_out_of_date)
+      << File->getName() << Name;
+    return false;
+
+  case ASTReader::VersionMismatch:
+  case ASTReader::ConfigurationMismatch:
+  case ASTReader::HadErrors:
+  case ASTReader::Failure:
+    // The ASTReader has already diagnosed the problem.
+    return false;
+  }
+  llvm_unreachable("Invalid ASTReader result");
+}
+
+bool CompilerInstance::loadFortranModule(SourceLocation UseLoc,
+                                         IdentifierInfo *Name) {
+  const FileEntry *PCModuleFile
+    = getPreprocessor().getHeaderSearchInfo()
+        .lookupFortranModuleFile(Name->getName());
+  if (!PCModuleFile)
+    return false;
+
+  if (readFortranModuleFile(PCModuleFile, UseLoc, Name->getName())) {
+    uint64_t InterfaceHash;
+    if (PPCallbacks *Callbacks = getPreprocessor().getPPCallbacks())
+      if (PCModuleManager->getFortranModuleInterfaceHash(Name->getName(),
+                                                         InterfaceHash))
+        Callbacks->FortranModuleInterface(UseLoc, Name->getName(),
+                                          PCModuleFile, InterfaceHash);
+  }
+  return true;
+}
+
+bool CompilerInstance::loadFortranSubmoduleFile(SourceLocation Loc,
+                                                StringRef Name) {
+  const FileEntry *SubmoduleFile
+    = getPreprocessor().getHeaderSearchInfo().lookupFortranSubmoduleFile(Name);
+  if (!SubmoduleFile)
+    return false;
+
+  readFortranModuleFile(SubmoduleFile, Loc, Name);
+  return true;
+}
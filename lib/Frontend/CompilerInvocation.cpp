@@ -376,6 +376,7 @@ static bool ParseCodeGenArgs(CodeGenOptions &Opts, ArgList &Args, InputKind IK,
   Opts.NoDwarfDirectoryAsm = Args.hasArg(OPT_fno_dwarf_directory_asm);
   Opts.SoftFloat = Args.hasArg(OPT_msoft_float);
   Opts.StrictEnums = Args.hasArg(OPT_fstrict_enums);
+  Opts.ParallelDoConcurrent = Args.hasArg(OPT_fparallel_do_concurrent);
   Opts.UnsafeFPMath = Args.hasArg(OPT_menable_unsafe_fp_math) ||
                       Args.hasArg(OPT_cl_unsafe_math_optimizations) ||
                       Args.hasArg(OPT_cl_fast_relaxed_math);
@@ -581,6 +582,11 @@ bool lfort::ParseDiagnosticArgs(DiagnosticOptions &Opts, ArgList &Args,
 
 static void ParseFileSystemArgs(FileSystemOptions &Opts, ArgList &Args) {
   Opts.WorkingDir = Args.getLastArgValue(OPT_working_directory);
+  Opts.DirectoryListingCachePath
+    = Args.getLastArgValue(OPT_fdirectory_listing_cache_path);
+  Opts.CacheDirectoryListings = Args.hasArg(OPT_fdirectory_listing_cache) ||
+                                !Opts.DirectoryListingCachePath.empty();
+  Opts.MapSourceFiles = Args.hasArg(OPT_fmap_source_files);
 }
 
 static InputKind ParseFrontendArgs(FrontendOptions &Opts, ArgList &Args,
@@ -648,6 +654,8 @@ static InputKind ParseFrontendArgs(FrontendOptions &Opts, ArgList &Args,
       Opts.ProgramAction = frontend::RewriteTest; break;
     case OPT_analyze:
       Opts.ProgramAction = frontend::RunAnalysis; break;
+    case OPT_scan_module_deps:
+      Opts.ProgramAction = frontend::ScanModuleDeps; break;
     case OPT_migrate:
       Opts.ProgramAction = frontend::MigrateSource; break;
     case OPT_Eonly:
@@ -691,6 +699,7 @@ static InputKind ParseFrontendArgs(FrontendOptions &Opts, ArgList &Args,
   Opts.RelocatablePCH = Args.hasArg(OPT_relocatable_pch);
   Opts.ShowHelp = Args.hasArg(OPT_help);
   Opts.ShowStats = Args.hasArg(OPT_print_stats);
+  Opts.SkipSubprogramBodies = Args.hasArg(OPT_skip_subprogram_bodies);
   Opts.ShowTimers = Args.hasArg(OPT_ftime_report);
   Opts.ShowVersion = Args.hasArg(OPT_version);
   Opts.ASTMergeFiles = Args.getAllArgValues(OPT_ast_merge);
@@ -816,6 +825,7 @@ static void ParseHeaderSearchArgs(HeaderSearchOptions &Opts, ArgList &Args) {
   Opts.ResourceDir = Args.getLastArgValue(OPT_resource_dir);
   Opts.PCModuleCachePath = Args.getLastArgValue(OPT_fmodule_cache_path);
   Opts.DisablePCModuleHash = Args.hasArg(OPT_fdisable_module_hash);
+  Opts.FortranModulePath = Args.getLastArgValue(OPT_J);
   
   // Add -I..., -F..., and -index-header-map options in order.
   bool IsIndexHeaderMap = false;
@@ -985,6 +995,7 @@ void CompilerInvocation::setLangDefaults(LangOptions &Opts, InputKind IK,
 
   Opts.DollarIdents = !Opts.AsmPreprocessor;
 
+  Opts.F77 = Std.isF77();
   Opts.F90 = Std.isF90();
   Opts.F95 = Std.isF95();
   Opts.F03 = Std.isF03();
@@ -1103,6 +1114,12 @@ static void ParseLangArgs(LangOptions &Opts, ArgList &Args, InputKind IK,
                                    Opts.DollarIdents);
   Opts.FreeForm = Args.hasFlag(OPT_ffree_form, OPT_ffixed_form,
                                    Opts.FreeForm);
+  Opts.FoldIdentifierCase = Args.hasFlag(OPT_ffold_identifier_case,
+                                         OPT_fno_fold_identifier_case,
+                                         Opts.FoldIdentifierCase);
+  Opts.JoinContinuationLines = Args.hasFlag(OPT_fjoin_continuation_lines,
+                                            OPT_fno_join_continuation_lines,
+                                            Opts.JoinContinuationLines);
 
   Opts.PascalStrings = Args.hasArg(OPT_fpascal_strings);
   Opts.MicrosoftExt
@@ -21,6 +21,7 @@
 #include "lfort/Lex/PPCallbacks.h"
 #include "lfort/Lex/Preprocessor.h"
 #include "llvm/ADT/StringSet.h"
+#include "llvm/Support/Format.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/raw_ostream.h"
 
@@ -37,6 +38,15 @@ class DependencyFileCallback : public PPCallbacks {
   bool PhonyTarget;
   bool AddMissingHeaderDeps;
   bool SeenMissingHeader;
+
+  /// \brief A Fortran module the main file defines or uses, and the hash of
+  /// its public interface.
+  struct FortranModuleInfo {
+    std::string Name;
+    uint64_t InterfaceHash;
+    bool IsDefinition;
+  };
+  std::vector<FortranModuleInfo> FortranModules;
 private:
   bool FileMatchesDepCriteria(const char *Filename,
                               SrcMgr::CharacteristicKind FileType);
@@ -64,6 +74,9 @@ public:
                                   StringRef SearchPath,
                                   StringRef RelativePath,
                                   const PCModule *Imported);
+  virtual void FortranModuleInterface(SourceLocation Loc, StringRef Name,
+                                      const FileEntry *File,
+                                      uint64_t InterfaceHash);
 
   virtual void EndOfMainFile() {
     OutputDependencyFile();
@@ -146,6 +159,22 @@ void DependencyFileCallback::InclusionDirective(SourceLocation HashLoc,
   }
 }
 
+void DependencyFileCallback::FortranModuleInterface(SourceLocation Loc,
+                                                    StringRef Name,
+                                                    const FileEntry *File,
+                                                    uint64_t InterfaceHash) {
+  // The module file of a used module is a prerequisite like any included
+  // file.
+  if (File)
+    AddFilename(File->getName());
+
+  FortranModuleInfo Info;
+  Info.Name = Name;
+  Info.InterfaceHash = InterfaceHash;
+  Info.IsDefinition = File == 0;
+  FortranModules.push_back(Info);
+}
+
 void DependencyFileCallback::AddFilename(StringRef Filename) {
   if (FilesSet.insert(Filename))
     Files.push_back(Filename);
@@ -219,6 +248,17 @@ void DependencyFileCallback::OutputDependencyFile() {
   }
   OS << '\n';
 
+  // Report the interface hash of each Fortran module as a comment, which
+  // make ignores.  A build tool can compare the hashes of the modules a
+  // program uses against those it last saw, and skip recompiling the program
+  // when none of them changed, even though the module files were rewritten.
+  for (std::vector<FortranModuleInfo>::iterator I = FortranModules.begin(),
+         E = FortranModules.end(); I != E; ++I)
+    OS << "#fortran-module " << (I->IsDefinition ? "provides " : "uses ")
+       << I->Name << ' '
+       << llvm::format("%016llx", (unsigned long long)I->InterfaceHash)
+       << '\n';
+
   // Create phony targets if requested.
   if (PhonyTarget && !Files.empty()) {
     // Skip the first entry, this is always the input file itself.
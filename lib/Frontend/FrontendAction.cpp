@@ -23,6 +23,7 @@
 #include "lfort/Parse/ParseAST.h"
 #include "lfort/Serialization/ASTDeserializationListener.h"
 #include "lfort/Serialization/ASTReader.h"
+#include "lfort/Serialization/ASTWriter.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/MemoryBuffer.h"
@@ -130,13 +131,30 @@ ASTConsumer* FrontendAction::CreateWrappedASTConsumer(CompilerInstance &CI,
   if (!Consumer)
     return 0;
 
-  if (CI.getFrontendOpts().AddPluginActions.size() == 0)
+  // Fortran modules defined by the program are written out as module files
+  // alongside whatever the action itself produces, except when the action
+  // is already writing an AST file.
+  frontend::ActionKind Action = CI.getFrontendOpts().ProgramAction;
+  bool WriteFortranModules = CI.getLangOpts().F90 &&
+                             Action != frontend::GeneratePCH &&
+                             Action != frontend::GeneratePCModule;
+
+  if (CI.getFrontendOpts().AddPluginActions.size() == 0 &&
+      !WriteFortranModules)
     return Consumer;
 
   // Make sure the non-plugin consumer is first, so that plugins can't
   // modifiy the AST.
   std::vector<ASTConsumer*> Consumers(1, Consumer);
 
+  if (WriteFortranModules) {
+    const std::string &ModuleDir = CI.getHeaderSearchOpts().FortranModulePath;
+    Consumers.push_back(new FortranModuleFileGenerator(
+        CI.getPreprocessor(), ModuleDir, /*SubmoduleFiles=*/false));
+    Consumers.push_back(new FortranModuleFileGenerator(
+        CI.getPreprocessor(), ModuleDir, /*SubmoduleFiles=*/true));
+  }
+
   for (size_t i = 0, e = CI.getFrontendOpts().AddPluginActions.size();
        i != e; ++i) { 
     // This is O(|plugins| * |add_plugins|), but since both numbers are
@@ -427,6 +445,11 @@ void FrontendAction::EndSourceFile() {
   // an error.
   CI.clearOutputFiles(/*EraseFiles=*/CI.getDiagnostics().hasErrorOccurred());
 
+  // Persist the directory listings read while processing this file, so the
+  // next compilation does not have to read them again.
+  if (CI.hasFileManager())
+    CI.getFileManager().writeDirectoryListingCache();
+
   if (isCurrentFileAST()) {
     CI.takeSema();
     CI.resetAndLeakASTContext();
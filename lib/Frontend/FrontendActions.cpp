@@ -16,11 +16,13 @@
 #include "lfort/Frontend/FrontendDiagnostic.h"
 #include "lfort/Frontend/Utils.h"
 #include "lfort/Lex/HeaderSearch.h"
+#include "lfort/Lex/PPCallbacks.h"
 #include "lfort/Lex/Pragma.h"
 #include "lfort/Lex/Preprocessor.h"
 #include "lfort/Parse/Parser.h"
 #include "lfort/Serialization/ASTWriter.h"
 #include "llvm/ADT/OwningPtr.h"
+#include "llvm/ADT/SetVector.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/raw_ostream.h"
@@ -429,6 +431,151 @@ void PrintPreprocessedAction::ExecuteAction() {
                            CI.getPreprocessorOutputOpts());
 }
 
+namespace {
+/// \brief Records the files entered through INCLUDE lines and \#include
+/// directives while scanning for module dependencies.
+class ScanIncludesCallbacks : public PPCallbacks {
+  llvm::SetVector<std::string> &Includes;
+
+public:
+  explicit ScanIncludesCallbacks(llvm::SetVector<std::string> &Includes)
+    : Includes(Includes) { }
+
+  virtual void InclusionDirective(SourceLocation HashLoc,
+                                  const Token &IncludeTok,
+                                  StringRef FileName,
+                                  bool IsAngled,
+                                  CharSourceRange FilenameRange,
+                                  const FileEntry *File,
+                                  StringRef SearchPath,
+                                  StringRef RelativePath,
+                                  const PCModule *Imported) {
+    if (File)
+      Includes.insert(File->getName());
+  }
+};
+}
+
+/// \brief Module files are named after the lowercase module name.
+static std::string getModuleFileStem(const Token &Tok) {
+  return Tok.getIdentifierInfo()->getName().lower();
+}
+
+/// \brief Records the module files provided or required by a MODULE,
+/// SUBMODULE or USE statement.
+static void ScanModuleDepsStmt(ArrayRef<Token> Stmt,
+                               llvm::SetVector<std::string> &Provides,
+                               llvm::SetVector<std::string> &Requires) {
+  unsigned N = Stmt.size();
+  switch (Stmt[0].getKind()) {
+  case tok::kw_module:
+    // MODULE module-name.  MODULE PROCEDURE statements and the MODULE prefix
+    // of a subprogram have more tokens.
+    if (N == 2 && Stmt[1].is(tok::identifier)) {
+      std::string Name = getModuleFileStem(Stmt[1]);
+      Provides.insert(Name + ".mod");
+      Provides.insert(Name + ".smod");
+    }
+    break;
+
+  case tok::kw_submodule: {
+    // SUBMODULE ( ancestor-module-name [ : parent-submodule-name ] )
+    //   submodule-name
+    if (N < 5 || Stmt[1].isNot(tok::l_paren) || Stmt[2].isNot(tok::identifier))
+      break;
+    std::string Ancestor = getModuleFileStem(Stmt[2]);
+    std::string Parent = Ancestor;
+    unsigned I = 3;
+    if (Stmt[I].is(tok::colon)) {
+      if (Stmt[4].isNot(tok::identifier))
+        break;
+      Parent += "@" + getModuleFileStem(Stmt[4]);
+      I = 5;
+    }
+    if (N != I + 2 || Stmt[I].isNot(tok::r_paren) ||
+        Stmt[I + 1].isNot(tok::identifier))
+      break;
+    Provides.insert(Ancestor + "@" + getModuleFileStem(Stmt[I + 1]) + ".smod");
+    Requires.insert(Parent + ".smod");
+    break;
+  }
+
+  case tok::kw_use: {
+    // USE [ [ , module-nature ] :: ] module-name [ , ... ]
+    unsigned I = 1;
+    if (I < N && Stmt[I].is(tok::comma)) {
+      // Intrinsic modules are provided by the compiler, not by a file.
+      if (I + 1 < N && Stmt[I + 1].is(tok::kw_intrinsic))
+        break;
+      I += 2;
+    }
+    if (I < N && Stmt[I].is(tok::coloncolon))
+      ++I;
+    if (I < N && Stmt[I].is(tok::identifier))
+      Requires.insert(getModuleFileStem(Stmt[I]) + ".mod");
+    break;
+  }
+
+  default:
+    break;
+  }
+}
+
+void ScanModuleDepsAction::ExecuteAction() {
+  CompilerInstance &CI = getCompilerInstance();
+  Preprocessor &PP = CI.getPreprocessor();
+
+  // Ignore unknown pragmas.
+  PP.AddPragmaHandler(new EmptyPragmaHandler());
+
+  llvm::SetVector<std::string> Provides, Requires, Includes;
+  PP.addPPCallbacks(new ScanIncludesCallbacks(Includes));
+
+  // Only the statements that name modules are kept; every other statement
+  // is lexed and dropped, which the token cache makes cheap when it is
+  // available.
+  SmallVector<Token, 16> Stmt;
+  bool AtStmtStart = true;
+  Token Tok;
+  PP.EnterMainSourceFile();
+  do {
+    PP.Lex(Tok);
+    if (Tok.isAtStartOfNonContinuationLine() || Tok.is(tok::semi) ||
+        Tok.is(tok::eof)) {
+      if (!Stmt.empty()) {
+        ScanModuleDepsStmt(Stmt, Provides, Requires);
+        Stmt.clear();
+      }
+      AtStmtStart = true;
+      if (Tok.is(tok::semi))
+        continue;
+    }
+
+    if (AtStmtStart) {
+      // Skip the statement label.
+      if (Tok.is(tok::numeric_constant))
+        continue;
+      AtStmtStart = false;
+      if (Tok.is(tok::kw_module) || Tok.is(tok::kw_submodule) ||
+          Tok.is(tok::kw_use))
+        Stmt.push_back(Tok);
+    } else if (!Stmt.empty())
+      Stmt.push_back(Tok);
+  } while (Tok.isNot(tok::eof));
+
+  raw_ostream *OS = CI.createDefaultOutputFile(false, getCurrentFile());
+  if (!OS) return;
+
+  for (unsigned I = 0, N = Provides.size(); I != N; ++I)
+    *OS << "provides " << Provides[I] << '\n';
+  // A module used by the file that defines it is not a dependency.
+  for (unsigned I = 0, N = Requires.size(); I != N; ++I)
+    if (!Provides.count(Requires[I]))
+      *OS << "requires " << Requires[I] << '\n';
+  for (unsigned I = 0, N = Includes.size(); I != N; ++I)
+    *OS << "includes " << Includes[I] << '\n';
+}
+
 void PrintPreambleAction::ExecuteAction() {
   switch (getCurrentFileKind()) {
   case IK_Fortran77:
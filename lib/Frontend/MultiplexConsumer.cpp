@@ -249,6 +249,13 @@ void MultiplexConsumer::HandleVTable(
     Consumers[i]->HandleVTable(RD, DefinitionRequired);
 }
 
+bool MultiplexConsumer::needsSkippedSubprogramBodies() {
+  for (size_t i = 0, e = Consumers.size(); i != e; ++i)
+    if (Consumers[i]->needsSkippedSubprogramBodies())
+      return true;
+  return false;
+}
+
 ASTMutationListener *MultiplexConsumer::GetASTMutationListener() {
   return MutationListener.get();
 }
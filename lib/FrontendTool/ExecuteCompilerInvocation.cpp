@@ -113,6 +113,7 @@ static FrontendAction *CreateFrontendBaseAction(CompilerInstance &CI) {
   case RunAnalysis:            Action = "RunAnalysis"; break;
 #endif
   case RunPreprocessorOnly:    return new PreprocessOnlyAction();
+  case ScanModuleDeps:         return new ScanModuleDepsAction();
   }
 
 #if !defined(LFORT_ENABLE_ARCMT) || !defined(LFORT_ENABLE_STATIC_ANALYZER) \
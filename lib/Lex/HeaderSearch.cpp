@@ -21,8 +21,11 @@
 #include "llvm/ADT/SmallString.h"
 #include "llvm/Support/Capacity.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/ManagedStatic.h"
+#include "llvm/Support/Mutex.h"
 #include "llvm/Support/Path.h"
 #include <cstdio>
+#include <ctime>
 using namespace lfort;
 
 const IdentifierInfo *
@@ -55,6 +58,7 @@ HeaderSearch::HeaderSearch(llvm::IntrusiveRefCntPtr<HeaderSearchOptions> HSOpts,
   NumIncluded = 0;
   NumMultiIncludeFileOptzn = 0;
   NumFrameworkLookups = NumSubFrameworkLookups = 0;
+  NumFortranModuleLookups = 0;
 }
 
 HeaderSearch::~HeaderSearch() {
@@ -83,6 +87,8 @@ void HeaderSearch::PrintStats() {
 
   fprintf(stderr, "%d framework lookups.\n", NumFrameworkLookups);
   fprintf(stderr, "%d subframework lookups.\n", NumSubFrameworkLookups);
+  fprintf(stderr, "%d Fortran module file lookups.\n",
+          NumFortranModuleLookups);
 }
 
 /// CreateHeaderMap - This method returns a HeaderMap for the specified
@@ -698,6 +704,161 @@ HeaderSearch::NormalizeDashIncludePath(StringRef File, FileManager &FileMgr) {
   return Lexer::Stringify(Path.str());
 }
 
+//===----------------------------------------------------------------------===//
+// Fortran Module File Lookup.
+//===----------------------------------------------------------------------===//
+
+namespace {
+/// \brief The module and submodule files in one directory, keyed by
+/// lowercase file name.
+struct ModuleFileDirIndex {
+  ModuleFileDirIndex() : ModTime(0), IndexedAt(0) { }
+
+  /// \brief The modification time of the directory when it was read.
+  uint64_t ModTime;
+
+  /// \brief The time at which the directory was read.
+  uint64_t IndexedAt;
+
+  /// \brief The name of each module file within the directory.
+  llvm::StringMap<std::string> Files;
+};
+
+/// \brief The module file indexes of every directory searched for module
+/// files in this process, keyed by absolute directory path.  Shared by all
+/// HeaderSearch objects, which may live on different threads.
+class ModuleFileIndexCache {
+  llvm::sys::Mutex Lock;
+  llvm::StringMap<ModuleFileDirIndex> Indexes;
+
+public:
+  /// \brief Make sure the index of the given directory matches the
+  /// directory's contents, reading the directory if it changed.
+  ///
+  /// \returns false if the directory could not be read.
+  bool validate(StringRef DirPath);
+
+  /// \brief Find the file named \p LowerName, ignoring case, in an indexed
+  /// directory.
+  bool lookup(StringRef DirPath, StringRef LowerName, std::string &FileName);
+};
+} // end anonymous namespace
+
+static llvm::ManagedStatic<ModuleFileIndexCache> ModuleFileIndexes;
+
+bool ModuleFileIndexCache::validate(StringRef DirPath) {
+  llvm::sys::ScopedLock Guard(Lock);
+
+  llvm::sys::fs::file_status Status;
+  if (llvm::sys::fs::status(DirPath, Status) ||
+      !llvm::sys::fs::is_directory(Status)) {
+    Indexes.erase(DirPath);
+    return false;
+  }
+
+  // A directory modified within the second it was read keeps its time stamp,
+  // so such an index is rebuilt regardless.
+  uint64_t ModTime = Status.getLastModificationTime().toEpochTime();
+  ModuleFileDirIndex &Index = Indexes.GetOrCreateValue(DirPath).getValue();
+  if (Index.IndexedAt && Index.ModTime == ModTime && ModTime < Index.IndexedAt)
+    return true;
+
+  Index.ModTime = ModTime;
+  Index.IndexedAt = ::time(0);
+  Index.Files.clear();
+
+  llvm::error_code EC;
+  for (llvm::sys::fs::directory_iterator Dir(DirPath, EC), DirEnd;
+       Dir != DirEnd && !EC; Dir.increment(EC)) {
+    StringRef FileName = llvm::sys::path::filename(Dir->path());
+    StringRef Extension = llvm::sys::path::extension(FileName);
+    if (!Extension.equals_lower(".mod") && !Extension.equals_lower(".smod"))
+      continue;
+
+    if (llvm::sys::path::stem(FileName).empty())
+      continue;
+
+    // If several files only differ in case, keep the first one read.
+    Index.Files.GetOrCreateValue(FileName.lower(), FileName.str());
+  }
+
+  if (EC) {
+    Indexes.erase(DirPath);
+    return false;
+  }
+  return true;
+}
+
+bool ModuleFileIndexCache::lookup(StringRef DirPath, StringRef LowerName,
+                                  std::string &FileName) {
+  llvm::sys::ScopedLock Guard(Lock);
+
+  llvm::StringMap<ModuleFileDirIndex>::iterator Index = Indexes.find(DirPath);
+  if (Index == Indexes.end())
+    return false;
+
+  llvm::StringMap<std::string>::iterator File
+    = Index->second.Files.find(LowerName);
+  if (File == Index->second.Files.end())
+    return false;
+
+  FileName = File->second;
+  return true;
+}
+
+const FileEntry *
+HeaderSearch::lookupFortranModuleFileNamed(StringRef LowerName) {
+  llvm::StringMap<const FileEntry *, llvm::BumpPtrAllocator>::iterator Known
+    = FortranModuleFiles.find(LowerName);
+  if (Known != FortranModuleFiles.end())
+    return Known->second;
+
+  ++NumFortranModuleLookups;
+
+  SmallVector<const DirectoryEntry *, 16> Dirs;
+  if (!NoCurDirSearch)
+    if (const DirectoryEntry *CurDir = FileMgr.getDirectory("."))
+      Dirs.push_back(CurDir);
+  for (unsigned Idx = 0, N = SearchDirs.size(); Idx != N; ++Idx)
+    if (SearchDirs[Idx].isNormalDir())
+      Dirs.push_back(SearchDirs[Idx].getDir());
+  if (!HSOpts->FortranModulePath.empty())
+    if (const DirectoryEntry *ModDir
+          = FileMgr.getDirectory(HSOpts->FortranModulePath))
+      Dirs.push_back(ModDir);
+
+  const FileEntry *Result = 0;
+  for (unsigned Idx = 0, N = Dirs.size(); Idx != N && !Result; ++Idx) {
+    const DirectoryEntry *Dir = Dirs[Idx];
+
+    // Check each directory against its modification time once per
+    // HeaderSearch; afterwards its index is trusted.
+    llvm::DenseMap<const DirectoryEntry *, std::string>::iterator IndexedDir
+      = FortranModuleDirs.find(Dir);
+    if (IndexedDir == FortranModuleDirs.end()) {
+      SmallString<128> DirPath(Dir->getName());
+      llvm::sys::fs::make_absolute(DirPath);
+      if (!ModuleFileIndexes->validate(DirPath.str()))
+        DirPath.clear();
+      IndexedDir = FortranModuleDirs.insert(
+                     std::make_pair(Dir, DirPath.str().str())).first;
+    }
+    if (IndexedDir->second.empty())
+      continue;
+
+    std::string FileName;
+    if (!ModuleFileIndexes->lookup(IndexedDir->second, LowerName, FileName))
+      continue;
+
+    SmallString<128> FilePath(Dir->getName());
+    llvm::sys::path::append(FilePath, FileName);
+    Result = FileMgr.getFile(FilePath.str());
+  }
+
+  FortranModuleFiles[LowerName] = Result;
+  return Result;
+}
+
 //===----------------------------------------------------------------------===//
 // File Info Management.
 //===----------------------------------------------------------------------===//
@@ -90,6 +90,12 @@ void Lexer::InitLexer(const char *BufStart, const char *BufPtr,
 
   Is_PragmaLexer = false;
   CurrentConflictMarkerState = CMK_None;
+  FixedFormBodyEnd = 0;
+  InLogicalLine = false;
+  NextLogicalLineSegment = 0;
+  FileBufferStart = FileBufferEnd = 0;
+  LogicalLineResumePtr = LogicalLineResumeBodyEnd = 0;
+  LogicalLineCheckedUpTo = BufferStart;
 
   // Start of the file is a start of line.
   IsAtStartOfLine = true;
@@ -1140,6 +1146,16 @@ static inline bool isNumberBody(unsigned char c) {
     true : false;
 }
 
+/// isDecimalDigit - Return true if this is a decimal digit, which is [0-9].
+static inline bool isDecimalDigit(unsigned char c) {
+  return (CharInfo[c] & CHAR_NUMBER) ? true : false;
+}
+
+/// isLetter - Return true if this is a letter, which is [a-zA-Z].
+static inline bool isLetter(unsigned char c) {
+  return (CharInfo[c] & CHAR_LETTER) ? true : false;
+}
+
 /// isRawStringDelimBody - Return true if this is the body character of a
 /// raw string delimiter.
 static inline bool isRawStringDelimBody(unsigned char c) {
@@ -1197,6 +1213,21 @@ SourceLocation Lexer::getSourceLocation(const char *Loc,
   // In the normal case, we're just lexing from a simple file buffer, return
   // the file id from FileLoc with the offset specified.
   unsigned CharNo = Loc-BufferStart;
+  if (InLogicalLine) {
+    // Map the offset in the logical line back to the file through the segment
+    // it was copied from: binary search for the last segment that starts at
+    // or before it, so long statements don't go quadratic.
+    unsigned Lo = 0, Hi = LogicalLineSegments.size();
+    while (Hi - Lo > 1) {
+      unsigned Mid = Lo + (Hi - Lo) / 2;
+      if (LogicalLineSegments[Mid].ViewOffset <= CharNo)
+        Lo = Mid;
+      else
+        Hi = Mid;
+    }
+    CharNo += LogicalLineSegments[Lo].FileOffset -
+              LogicalLineSegments[Lo].ViewOffset;
+  }
   if (FileLoc.isFileID())
     return FileLoc.getLocWithOffset(CharNo);
 
@@ -1534,7 +1565,25 @@ FinishIdentifier:
     // looking up the identifier in the identifier table.
     // Note: If the name starts with a '.' then this will set
     // the default token type to tok::dots_identifier.
-    IdentifierInfo *II = PP->LookUpIdentifierInfo(Result);
+    IdentifierInfo *II;
+    if (LangOpts.FoldIdentifierCase) {
+      // Fortran names are case-insensitive.  Fold the spelling straight out
+      // of the buffer so the table only ever hashes one form of each name;
+      // the token still refers to the original spelling for diagnostics.
+      // A token that needs cleaning (e.g. split by an escaped newline) is
+      // folded from its cleaned spelling instead.
+      SmallString<64> Spelling, Folded;
+      StringRef Name(IdStart, Result.getLength());
+      if (Result.needsCleaning())
+        Name = PP->getSpelling(Result, Spelling);
+      Folded.resize(Name.size());
+      IdentifierTable::foldCase(Name.data(), Name.size(), Folded.data());
+      II = &PP->getIdentifierTable().getFolded(Folded);
+      Result.setIdentifierInfo(II);
+      Result.setKind(II->getTokenID());
+    } else {
+      II = PP->LookUpIdentifierInfo(Result);
+    }
 
     // Finally, now that we know we have an identifier, pass this off to the
     // preprocessor, which may macro expand it or something.
@@ -1631,27 +1680,136 @@ void Lexer::LexNumericConstant(Token &Result, const char *CurPtr) {
   Result.setLiteralData(TokStart);
 }
 
-/// LexFortranIntConstant - Lex the remainder of a Fortran integer
-/// constant. From[-1] is the first character lexed (the 'b', 'o' or 'z').
+/// LexFortranNumericConstant - Lex the Fortran integer or real constant that
+/// starts at BufferPtr in a single pass over the buffer, classifying it on the
+/// way.  Returns false without consuming anything if the constant runs into
+/// an escaped newline or a trigraph, which only LexNumericConstant handles.
+bool Lexer::LexFortranNumericConstant(Token &Result) {
+  const char *TokStart = BufferPtr;
+  const char *Limit = FixedFormBodyEnd ? FixedFormBodyEnd : BufferEnd;
+  const char *CurPtr = TokStart;
+
+  NumericLiteralScan Scan;
+  Scan.TokStart = TokStart;
+  Scan.Kind = NumericLiteralScan::Integer;
+  Scan.Radix = 10;
+  Scan.DigitsBegin = 0;
+  Scan.ExponentLetter = 0;
+  Scan.HasPeriod = false;
+
+  // R409-F08 digit-string.  The value is accumulated as we go; it is only
+  // used if there are few enough digits that it cannot have overflowed.
+  uint64_t Value = 0;
+  while (CurPtr != Limit && isDecimalDigit(*CurPtr))
+    Value = Value*10 + (*CurPtr++ - '0');
+  unsigned NumDigits = CurPtr - TokStart;
+
+  // R417-F08 significand.  A period followed by letters and another period
+  // starts an operator or a logical constant instead, as in "1.eq.n".
+  if (CurPtr != Limit && *CurPtr == '.') {
+    const char *Letters = CurPtr + 1;
+    while (Letters != Limit && isLetter(*Letters))
+      ++Letters;
+    if (Letters == CurPtr + 1 || Letters == Limit || *Letters != '.') {
+      Scan.Kind = NumericLiteralScan::Real;
+      Scan.HasPeriod = true;
+      ++CurPtr;
+      while (CurPtr != Limit && isDecimalDigit(*CurPtr))
+        ++CurPtr;
+    }
+  }
+
+  // R418-F08 exponent-letter, plus the common 'q' for quad precision.
+  if (CurPtr != Limit) {
+    char Letter = *CurPtr | 0x20;
+    if (Letter == 'e' || Letter == 'd' || Letter == 'q') {
+      const char *Exponent = CurPtr + 1;
+      if (Exponent != Limit && (*Exponent == '+' || *Exponent == '-'))
+        ++Exponent;
+      if (Exponent != Limit && isDecimalDigit(*Exponent)) {
+        Scan.Kind = NumericLiteralScan::Real;
+        Scan.ExponentLetter = Letter;
+        CurPtr = Exponent;
+        while (CurPtr != Limit && isDecimalDigit(*CurPtr))
+          ++CurPtr;
+      }
+    }
+  }
+  Scan.DigitsEnd = CurPtr - TokStart;
+
+  // R407-F08 kind-param: a digit-string or a scalar-int-constant-name.
+  Scan.KindBegin = Scan.DigitsEnd;
+  if (CurPtr != Limit && *CurPtr == '_' && CurPtr + 1 != Limit &&
+      isIdentifierBody(CurPtr[1])) {
+    CurPtr += 2;
+    while (CurPtr != Limit && isIdentifierBody(*CurPtr))
+      ++CurPtr;
+  }
+
+  if (CurPtr != Limit && (*CurPtr == '\\' || *CurPtr == '?'))
+    return false;
+
+  Scan.Length = CurPtr - TokStart;
+  Scan.HasValue = Scan.Kind == NumericLiteralScan::Integer && NumDigits <= 19;
+  Scan.Value = Value;
+
+  FormTokenWithChars(Result, CurPtr, tok::numeric_constant);
+  Result.setLiteralData(TokStart);
+  if (!isLexingRawMode())
+    PP->cacheNumericLiteral(Scan);
+  return true;
+}
+
+/// LexFortranIntConstant - Lex the remainder of a Fortran binary, octal or
+/// hexadecimal constant. From[-1] is the first character lexed (the 'b', 'o'
+/// or 'z').
 void Lexer::LexFortranIntConstant(Token &Result, const char *CurPtr) {
-  unsigned Size;
-  char C = getCharAndSize(CurPtr, Size);
+  const char *TokStart = BufferPtr;
+  const char *Limit = FixedFormBodyEnd ? FixedFormBodyEnd : BufferEnd;
+
+  NumericLiteralScan Scan;
+  Scan.TokStart = TokStart;
+  Scan.Kind = NumericLiteralScan::BOZ;
+  switch (*TokStart | 0x20) {
+  case 'b': Scan.Radix = 2; break;
+  case 'o': Scan.Radix = 8; break;
+  default:  Scan.Radix = 16; break;
+  }
+  Scan.ExponentLetter = 0;
+  Scan.HasPeriod = false;
 
   // This function is called only if the next character is a single or
   // double quote.
-  char DelimC = C;
-  C = getCharAndSize(CurPtr, Size);
-
-  unsigned Digits = 0;
-  while (C != DelimC) {
-    CurPtr = ConsumeChar(CurPtr, Size, Result);
-    C = getCharAndSize(CurPtr, Size);
-    ++Digits;
+  char DelimC = *CurPtr++;
+  Scan.DigitsBegin = CurPtr - TokStart;
+
+  uint64_t Value = 0;
+  bool ValidDigits = true;
+  while (CurPtr != Limit && *CurPtr != DelimC && *CurPtr != 0 &&
+         !isVerticalWhitespace(*CurPtr)) {
+    unsigned char C = *CurPtr++;
+    unsigned Digit = Scan.Radix;
+    if (isDecimalDigit(C))
+      Digit = C - '0';
+    else if ((C | 0x20) >= 'a' && (C | 0x20) <= 'f')
+      Digit = (C | 0x20) - 'a' + 10;
+    ValidDigits &= Digit < Scan.Radix;
+    Value = Value*Scan.Radix + Digit;
+  }
+  Scan.DigitsEnd = CurPtr - TokStart;
+
+  if (CurPtr == Limit || *CurPtr != DelimC) {
+    if (!isLexingRawMode())
+      Diag(BufferPtr, DelimC == '"' ? diag::ext_unterminated_string
+                                    : diag::ext_unterminated_char);
+    FormTokenWithChars(Result, CurPtr, tok::unknown);
+    return;
   }
 
   // Consume the ending delimiter as well.
-  CurPtr = ConsumeChar(CurPtr, Size, Result);
+  ++CurPtr;
 
+  unsigned Digits = Scan.DigitsEnd - Scan.DigitsBegin;
   if (Digits == 0) {
     Diag(BufferPtr, diag::err_numeric_constant_has_no_digits);
     FormTokenWithChars(Result, CurPtr, tok::unknown);
@@ -1659,9 +1817,18 @@ void Lexer::LexFortranIntConstant(Token &Result, const char *CurPtr) {
   }
 
   // Update the location of token as well as BufferPtr.
-  const char *TokStart = BufferPtr;
   FormTokenWithChars(Result, CurPtr, tok::numeric_constant);
   Result.setLiteralData(TokStart);
+
+  // Leave invalid digits to NumericLiteralParser to diagnose.
+  if (ValidDigits && !isLexingRawMode()) {
+    Scan.Length = CurPtr - TokStart;
+    Scan.KindBegin = Scan.Length;
+    Scan.HasValue = Digits * (Scan.Radix == 2 ? 1 : Scan.Radix == 8 ? 3 : 4)
+                      <= 64;
+    Scan.Value = Value;
+    PP->cacheNumericLiteral(Scan);
+  }
 }
 
 /// LexUDSuffix - Lex the ud-suffix production for user-defined literal suffixes
@@ -1979,6 +2146,7 @@ bool Lexer::SkipWhitespace(Token &Result, const char *CurPtr) {
     Result.setFlag(Token::StartOfLine);
     // No leading whitespace seen so far.
     Result.clearFlag(Token::LeadingSpace);
+    FixedFormBodyEnd = 0;
     Char = *++CurPtr;
 
     if (!LangOpts.FreeForm)
@@ -2510,6 +2678,11 @@ unsigned Lexer::isNextPPTokenLParen() {
   // Save state that can be changed while lexing so that we can restore it.
   const char *TmpBufferPtr = BufferPtr;
   bool inPPDirectiveMode = ParsingPreprocessorDirective;
+  const char *TmpFixedFormBodyEnd = FixedFormBodyEnd;
+  const char *TmpBufferStart = BufferStart;
+  const char *TmpBufferEnd = BufferEnd;
+  bool TmpInLogicalLine = InLogicalLine;
+  unsigned TmpNextLogicalLineSegment = NextLogicalLineSegment;
 
   Token Tok;
   Tok.startToken();
@@ -2518,6 +2691,11 @@ unsigned Lexer::isNextPPTokenLParen() {
   // Restore state that may have changed.
   BufferPtr = TmpBufferPtr;
   ParsingPreprocessorDirective = inPPDirectiveMode;
+  FixedFormBodyEnd = TmpFixedFormBodyEnd;
+  BufferStart = TmpBufferStart;
+  BufferEnd = TmpBufferEnd;
+  InLogicalLine = TmpInLogicalLine;
+  NextLogicalLineSegment = TmpNextLogicalLineSegment;
 
   // Restore the lexer back to non-skipping mode.
   LexingRawMode = false;
@@ -2643,6 +2821,338 @@ bool Lexer::isCodeCompletionPoint(const char *CurPtr) const {
 }
 
 
+#ifdef __SSE2__
+/// MatchVector - Return a mask with bit I set if byte I of V equals C.
+static inline unsigned MatchVector(__m128i V, char C) {
+  return _mm_movemask_epi8(_mm_cmpeq_epi8(V, _mm_set1_epi8(C)));
+}
+#endif
+
+/// isEndOfLineOrBuffer - Return true if C ends a source line.  This includes
+/// the null at the end of the buffer.
+static inline bool isEndOfLineOrBuffer(char C) {
+  return C == '\n' || C == '\r' || C == 0;
+}
+
+/// ScanFixedFormCard - Classify the fixed-form line starting at Line without
+/// consuming anything.  Columns 1 to 6 are examined together, as bit masks, so
+/// that a card is classified with a handful of vector compares instead of a
+/// branch per column.  The end of the line is then looked for in the same way,
+/// up to column 72.
+FixedFormCard Lexer::ScanFixedFormCard(const char *Line,
+                                       const char *BufferEnd) {
+  // Bit I of each mask describes column I+1.  Only the first Scanned columns
+  // have been checked for the end of the line.
+  unsigned EOLMask = 0, SpaceMask = 0, BangMask = 0, HashMask = 0;
+  unsigned Scanned;
+#ifdef __SSE2__
+  if (BufferEnd - Line >= 16) {
+    __m128i V = _mm_loadu_si128((const __m128i*)Line);
+    EOLMask = MatchVector(V, '\n') | MatchVector(V, '\r') | MatchVector(V, 0);
+    SpaceMask = MatchVector(V, ' ');
+    BangMask = MatchVector(V, '!');
+    HashMask = MatchVector(V, '#');
+    Scanned = 16;
+  } else
+#endif
+  {
+    for (Scanned = 0; Scanned != 6; ++Scanned) {
+      char C = Line[Scanned];
+      if (isEndOfLineOrBuffer(C)) {
+        EOLMask = 1U << Scanned;
+        break;
+      }
+      SpaceMask |= (C == ' ') << Scanned;
+      BangMask |= (C == '!') << Scanned;
+      HashMask |= (C == '#') << Scanned;
+    }
+  }
+
+  // Only the columns of the label and continuation fields before the end of
+  // the line take part in the classification.
+  unsigned LineLen = EOLMask ? llvm::CountTrailingZeros_32(EOLMask) : Scanned;
+  unsigned Cols = LineLen < 6 ? LineLen : 6;
+  unsigned ColMask = (1U << Cols) - 1;
+
+  FixedFormCard Card;
+  Card.HasLabel = false;
+  Card.Label = 0;
+  Card.BodyStart = Line + Cols;
+  Card.BodyEnd = 0;
+
+  // A 'C', 'c' or '*' in column 1, or a '!' anywhere but in column 6, makes
+  // this a comment line.  A '#' preceded only by blanks makes it a directive.
+  // Whichever comes first wins.
+  unsigned CommentMask = BangMask & ColMask & 0x1F;
+  if (Cols && (Line[0] == 'C' || Line[0] == 'c' || Line[0] == '*'))
+    CommentMask |= 1;
+  HashMask &= ColMask;
+  unsigned FirstComment = CommentMask ?
+    llvm::CountTrailingZeros_32(CommentMask) : 32;
+  if (HashMask) {
+    unsigned FirstHash = llvm::CountTrailingZeros_32(HashMask);
+    unsigned Before = (1U << FirstHash) - 1;
+    if (FirstHash < FirstComment && (SpaceMask & Before) == Before) {
+      Card.Kind = FixedFormCard::Directive;
+      Card.BodyStart = Line;
+      return Card;
+    }
+  }
+  if (CommentMask) {
+    Card.Kind = FixedFormCard::Comment;
+    Card.BodyStart = Line + FirstComment;
+    return Card;
+  }
+
+  // Any character other than blank or zero in column 6 marks a continuation.
+  Card.Kind = Cols == 6 && Line[5] != ' ' && Line[5] != '0' ?
+    FixedFormCard::Continuation : FixedFormCard::Statement;
+
+  // The characters in columns 1 through 5 may be a numeric statement label.
+  unsigned LabelCols = Cols < 5 ? Cols : 5;
+  if (~SpaceMask & ((1U << LabelCols) - 1)) {
+    Card.HasLabel = true;
+    for (unsigned i = 0; i != LabelCols; ++i)
+      if (Line[i] != ' ')
+        Card.Label = Card.Label*10 + (Line[i]-'0');
+  }
+
+  // Look for the end of the line before column 73.  If there is none, the
+  // rest of the line will be skipped once the lexer gets there.
+  if (EOLMask)
+    return Card;
+  const char *CurPtr = Line + Scanned, *ColEnd = Line + 72;
+#ifdef __SSE2__
+  while (CurPtr + 16 <= ColEnd && CurPtr + 16 <= BufferEnd) {
+    __m128i V = _mm_loadu_si128((const __m128i*)CurPtr);
+    if (MatchVector(V, '\n') | MatchVector(V, '\r') | MatchVector(V, 0))
+      return Card;
+    CurPtr += 16;
+  }
+#endif
+  for (; CurPtr != ColEnd; ++CurPtr)
+    if (isEndOfLineOrBuffer(*CurPtr))
+      return Card;
+
+  Card.BodyEnd = ColEnd;
+  return Card;
+}
+
+namespace {
+/// StatementLineEnd - How one line of a statement ends, as far as joining it
+/// into a logical line is concerned.
+enum StatementLineEnd {
+  /// The statement ends on this line, or is continued on the next card (which
+  /// only the caller can tell in fixed form).
+  SLE_End,
+  /// A free-form '&' continues the statement on a later line.
+  SLE_Continued,
+  /// The line can't be joined: it ends inside a character context or a
+  /// block comment, or it has a comment which must be seen by the
+  /// preprocessor's comment handlers before the statement ends.
+  SLE_Unsupported
+};
+}
+
+/// ScanStatementLine - Scan the statement text from Ptr to the end of its
+/// line.  CodeEnd is set to the end of the code on the line: the continuation
+/// '&', the start of a trailing comment, Limit (column 73 in fixed form), or
+/// the end of the line.  LineEnd is set to the end of the line itself.
+static StatementLineEnd ScanStatementLine(const char *Ptr, const char *Limit,
+                                          bool FreeForm, const char *&CodeEnd,
+                                          const char *&LineEnd) {
+  const char *LastNonBlank = 0, *Comment = 0;
+  char Quote = 0;
+  CodeEnd = 0;
+  for (; !isEndOfLineOrBuffer(*Ptr); ++Ptr) {
+    if (Ptr == Limit && !CodeEnd)
+      CodeEnd = Ptr;
+    if (CodeEnd)
+      continue;
+
+    char C = *Ptr;
+    if (Quote) {
+      if (C == Quote)
+        Quote = 0;
+      LastNonBlank = Ptr;
+      continue;
+    }
+
+    if (C == '!') {
+      CodeEnd = Comment = Ptr;
+      continue;
+    }
+    if (C == '/' && Ptr[1] == '*')
+      return SLE_Unsupported;
+    if (C == '\'' || C == '"')
+      Quote = C;
+    if (!isHorizontalWhitespace(C))
+      LastNonBlank = Ptr;
+  }
+
+  LineEnd = Ptr;
+  if (!CodeEnd)
+    CodeEnd = Ptr;
+  if (Quote)
+    return SLE_Unsupported;
+  if (FreeForm && LastNonBlank && *LastNonBlank == '&') {
+    if (Comment)
+      return SLE_Unsupported;
+    CodeEnd = LastNonBlank;
+    return SLE_Continued;
+  }
+  return SLE_End;
+}
+
+/// SkipNewLine - Given a pointer to the end of a line, return the start of
+/// the next one.
+static const char *SkipNewLine(const char *Ptr) {
+  if (Ptr[0] == '\n' || Ptr[0] == '\r') {
+    // Consume a \r\n or \n\r pair as one newline.
+    if ((Ptr[1] == '\n' || Ptr[1] == '\r') && Ptr[0] != Ptr[1])
+      return Ptr+2;
+    return Ptr+1;
+  }
+  return Ptr;
+}
+
+/// EnterLogicalLine - CurPtr points at the first token of a line.  If that
+/// line starts a continued statement, copy the statement into a logical line
+/// with the continuations removed, and start lexing from that instead of from
+/// the file.  A remap table records where each run of the logical line came
+/// from, so that tokens still get locations in the file.
+///
+/// Statements are only joined when doing so cannot change how they are
+/// lexed: no token may be split across a continuation, and there may be no
+/// comments or directives between the continued lines.  Otherwise this
+/// returns false and the statement is lexed from the file as usual.
+bool Lexer::EnterLogicalLine(const char *CurPtr) {
+  if (!PP || LexingRawMode || ExtendedTokenMode || !FileLoc.isFileID() ||
+      ParsingPreprocessorDirective || *CurPtr == '#')
+    return false;
+
+  const char *CodeEnd, *LineEnd;
+  const char *Limit = LangOpts.FreeForm ? 0 : FixedFormBodyEnd;
+  StatementLineEnd End = ScanStatementLine(CurPtr, Limit, LangOpts.FreeForm,
+                                           CodeEnd, LineEnd);
+  LogicalLineCheckedUpTo = LineEnd;
+  if (End != SLE_Continued && (LangOpts.FreeForm || End != SLE_End))
+    return false;
+
+  // Collect the runs of the statement, one per line.
+  LogicalLineSegments.clear();
+  SmallVector<std::pair<const char *, const char *>, 8> Runs;
+  Runs.push_back(std::make_pair(CurPtr, CodeEnd));
+  const char *ResumeBodyEnd = Limit;
+  while (true) {
+    const char *PrevCodeEnd = CodeEnd;
+    const char *Line = SkipNewLine(LineEnd);
+    if (Line == LineEnd)
+      return false; // End of file in the middle of the statement.
+
+    const char *SegStart;
+    if (LangOpts.FreeForm) {
+      // Blank lines may come between continued lines.
+      SegStart = Line;
+      while (isHorizontalWhitespace(*SegStart))
+        ++SegStart;
+      if (isEndOfLineOrBuffer(*SegStart)) {
+        LineEnd = SegStart;
+        continue;
+      }
+
+      // A leading '&' means that the statement carries on right after it,
+      // possibly in the middle of a token.  Don't try to join such tokens.
+      if (*SegStart == '&') {
+        ++SegStart;
+        if (PrevCodeEnd != Runs.back().first &&
+            !isHorizontalWhitespace(PrevCodeEnd[-1]) &&
+            !isHorizontalWhitespace(*SegStart) &&
+            !isEndOfLineOrBuffer(*SegStart))
+          return false;
+      } else if (*SegStart == '!' || *SegStart == '#') {
+        return false;
+      }
+      Limit = 0;
+    } else {
+      FixedFormCard Card = ScanFixedFormCard(Line, BufferEnd);
+      if (Card.Kind == FixedFormCard::Comment ||
+          Card.Kind == FixedFormCard::Directive)
+        return false;
+      if (Card.Kind == FixedFormCard::Statement) {
+        // The previous line ended the statement.
+        if (Runs.size() == 1)
+          return false;
+        break;
+      }
+      // A comment on the previous line has to be seen before this one.
+      if (*PrevCodeEnd == '!')
+        return false;
+      SegStart = Card.BodyStart;
+      Limit = Card.BodyEnd;
+    }
+
+    End = ScanStatementLine(SegStart, Limit, LangOpts.FreeForm, CodeEnd,
+                            LineEnd);
+    if (End == SLE_Unsupported)
+      return false;
+    Runs.push_back(std::make_pair(SegStart, CodeEnd));
+    ResumeBodyEnd = Limit;
+    if (LangOpts.FreeForm && End == SLE_End)
+      break;
+  }
+
+  // Trailing comments on the last line are left for the file lexer.
+  LogicalLineResumePtr = Runs.back().second;
+  LogicalLineResumeBodyEnd = ResumeBodyEnd;
+  if (!LangOpts.FreeForm && LogicalLineResumePtr == LineEnd)
+    LogicalLineResumeBodyEnd = 0;
+
+  // Lay the runs out one after the other.  Every run but the last is followed
+  // by a blank which stands in for the continuation: it is mapped to the '&'
+  // (free form) or to the end of the line (fixed form).  The logical line is
+  // preceded by a blank and followed by a null, like a file buffer.
+  unsigned Size = 0;
+  for (unsigned I = 0, E = Runs.size(); I != E; ++I)
+    Size += Runs[I].second - Runs[I].first + 1;
+  char *View = static_cast<char*>(
+    PP->getPreprocessorAllocator().Allocate(Size+1, 1));
+  *View++ = ' ';
+  char *Out = View;
+  for (unsigned I = 0, E = Runs.size(); I != E; ++I) {
+    LogicalLineSegment Seg;
+    Seg.ViewOffset = Out - View;
+    Seg.FileOffset = Runs[I].first - BufferStart;
+    LogicalLineSegments.push_back(Seg);
+
+    unsigned Len = Runs[I].second - Runs[I].first;
+    memcpy(Out, Runs[I].first, Len);
+    Out += Len;
+    *Out++ = I+1 != E ? ' ' : 0;
+  }
+
+  FileBufferStart = BufferStart;
+  FileBufferEnd = BufferEnd;
+  BufferStart = BufferPtr = View;
+  BufferEnd = Out-1;
+  FixedFormBodyEnd = 0;
+  NextLogicalLineSegment = 1;
+  InLogicalLine = true;
+  return true;
+}
+
+/// ExitLogicalLine - The whole logical line has been lexed; carry on in the
+/// file, just after the last run of the statement.
+void Lexer::ExitLogicalLine() {
+  assert(InLogicalLine && "Not lexing a logical line!");
+  BufferStart = FileBufferStart;
+  BufferEnd = FileBufferEnd;
+  BufferPtr = LogicalLineResumePtr;
+  FixedFormBodyEnd = LogicalLineResumeBodyEnd;
+  LogicalLineCheckedUpTo = LogicalLineResumePtr;
+  InLogicalLine = false;
+}
+
 /// LexTokenInternal - This implements a simple C family lexer.  It is an
 /// extremely performance critical piece of code.  This assumes that the buffer
 /// has a null character at the end of the file.  This returns a preprocessing
@@ -2659,68 +3169,43 @@ LexNextToken:
 
   // Handle the first 6 characters in fixed-form mode.
   if (!LangOpts.FreeForm && Result.isAtStartOfLine() &&
-        !ParsingPreprocessorDirective) {
-    unsigned Col = 1;
-    do {
-      if ((*CurPtr == '!' && Col != 6) ||
-          (Col == 1 && (*CurPtr == 'C' || *CurPtr == 'c' || *CurPtr == '*'))) {
-        // This is a Fortran "BCPL comment"
-        if (SkipLineComment(Result, CurPtr))
-          return; // There is a token to return.
-
-        goto LexNextToken;
-      } else if (Col == 6 && *CurPtr != ' ' && *CurPtr != '0') {
-        // This is a continuation.
-        Result.setFlag(Token::HadContinuation);
-      } else if (Col == 5) {
-        // The characters in columns 1 through 5 may be a numeric statement label.
-        unsigned Val = 0;
-        bool HasVal = false;
-        for (unsigned i = 0; i < 5; ++i) {
-          if (BufferPtr[i] == ' ')
-            continue;
-
-          HasVal = true;
-          Val = Val*10+(BufferPtr[i]-'0');
-        }
+        !ParsingPreprocessorDirective && !InLogicalLine) {
+    FixedFormCard Card = ScanFixedFormCard(CurPtr, BufferEnd);
+    switch (Card.Kind) {
+    case FixedFormCard::Comment:
+      // This is a Fortran "BCPL comment"
+      if (SkipLineComment(Result, Card.BodyStart))
+        return; // There is a token to return.
 
-        if (HasVal)
-          Result.setStmtLabel(Val);
-      }
+      goto LexNextToken;
 
-      if (*CurPtr == '#') {
-        // If there has been nothing but spaces before this # character, then
-        // break into the regular loop for PP directive handling.
-        bool HasNonSpace = false;
-        for (unsigned i = 0; i < Col-1; ++i)
-          if (BufferPtr[i] != ' ') {
-            HasNonSpace = true;
-            break;
-          }
+    case FixedFormCard::Directive:
+      // Break into the regular loop for PP directive handling.
+      FixedFormBodyEnd = 0;
+      break;
 
-        if (!HasNonSpace) {
-          CurPtr = BufferPtr;
-          break;
+    case FixedFormCard::Continuation:
+      Result.setFlag(Token::HadContinuation);
+      // FALL THROUGH.
+    case FixedFormCard::Statement:
+      if (Card.HasLabel)
+        Result.setStmtLabel(Card.Label);
+
+      FixedFormBodyEnd = Card.BodyEnd;
+      CurPtr = Card.BodyStart;
+      if (CurPtr != BufferPtr) {
+        // If we are keeping whitespace and other tokens, just return what we
+        // just skipped.  The next lexer invocation will return the token after
+        // the whitespace.
+        if (isKeepWhitespaceMode()) {
+          FormTokenWithChars(Result, CurPtr, tok::unknown);
+          return;
         }
-      }
 
-      if (*CurPtr != 0)
-        ++CurPtr;
-
-      ++Col;
-    } while (*CurPtr != 0 && Col < 7);
-
-    if (CurPtr != BufferPtr) {
-      // If we are keeping whitespace and other tokens, just return what we just
-      // skipped.  The next lexer invocation will return the token after the
-      // whitespace.
-      if (isKeepWhitespaceMode()) {
-        FormTokenWithChars(Result, CurPtr, tok::unknown);
-        return;
+        BufferPtr = CurPtr;
+        Result.setFlag(Token::LeadingSpace);
       }
-
-      BufferPtr = CurPtr;
-      Result.setFlag(Token::LeadingSpace);
+      break;
     }
   }
 
@@ -2742,6 +3227,43 @@ LexNextToken:
     Result.setFlag(Token::LeadingSpace);
   }
 
+  // In fixed form, anything past column 72 is ignored.  (A token which
+  // straddles column 72 is still lexed whole.)
+  if (FixedFormBodyEnd && CurPtr >= FixedFormBodyEnd) {
+    while (*CurPtr != '\n' && *CurPtr != '\r' && CurPtr != BufferEnd)
+      ++CurPtr;
+    FixedFormBodyEnd = 0;
+
+    if (CurPtr != BufferPtr) {
+      if (isKeepWhitespaceMode()) {
+        FormTokenWithChars(Result, CurPtr, tok::unknown);
+        return;
+      }
+
+      BufferPtr = CurPtr;
+    }
+  }
+
+  if (InLogicalLine) {
+    // The first token from each continuation line is flagged just as it would
+    // have been had it been lexed from the file.
+    if (NextLogicalLineSegment != LogicalLineSegments.size() &&
+        CurPtr != BufferEnd &&
+        unsigned(CurPtr-BufferStart) >=
+          LogicalLineSegments[NextLogicalLineSegment].ViewOffset) {
+      Result.setFlag(Token::StartOfLine);
+      Result.setFlag(Token::HadContinuation);
+      do
+        ++NextLogicalLineSegment;
+      while (NextLogicalLineSegment != LogicalLineSegments.size() &&
+             unsigned(CurPtr-BufferStart) >=
+               LogicalLineSegments[NextLogicalLineSegment].ViewOffset);
+    }
+  } else if (LangOpts.JoinContinuationLines && Result.isAtStartOfLine() &&
+             CurPtr >= LogicalLineCheckedUpTo && EnterLogicalLine(CurPtr)) {
+    CurPtr = BufferPtr;
+  }
+
   unsigned SizeTmp, SizeTmp2;   // Temporaries for use in cases below.
 
   // Read a character, advancing over it.
@@ -2750,6 +3272,12 @@ LexNextToken:
 
   switch (Char) {
   case 0:  // Null.
+    // Found the end of a logical line?  Carry on in the file.
+    if (InLogicalLine && CurPtr-1 == BufferEnd) {
+      ExitLogicalLine();
+      goto LexNextToken;
+    }
+
     // Found end of file?
     if (CurPtr-1 == BufferEnd) {
       // Read the PP instance variable into an automatic variable, because
@@ -2814,6 +3342,7 @@ LexNextToken:
     Result.setFlag(Token::StartOfLine);
     // No leading whitespace seen so far.
     Result.clearFlag(Token::LeadingSpace);
+    FixedFormBodyEnd = 0;
 
     if (!LangOpts.FreeForm)
       BufferPtr = CurPtr;
@@ -2854,7 +3383,9 @@ LexNextToken:
   case '5': case '6': case '7': case '8': case '9':
     // Notify MIOpt that we read a non-whitespace/non-comment token.
     MIOpt.ReadToken();
-    LexNumericConstant(Result, CurPtr);
+    // Preprocessor directives keep the C pp-number rules that #if relies on.
+    if (ParsingPreprocessorDirective || !LexFortranNumericConstant(Result))
+      LexNumericConstant(Result, CurPtr);
 
     // R312-F08 label
     //   is  digit [digit [digit [digit [digit ]]]]
@@ -2900,6 +3431,7 @@ LexNextToken:
     if (!ParsingPreprocessorDirective && !LexingRawMode &&
         Result.isAtStartOfLine() &&
         (Result.is(tok::kw_include) || (Result.is(tok::identifier) &&
+         !LangOpts.FoldIdentifierCase &&
          Result.getIdentifierInfo()->getName().equals_lower("include")))) {
       PP->HandleDirective(Result);
 
@@ -3138,6 +3670,8 @@ LexNextToken:
       // Notify MIOpt that we read a non-whitespace/non-comment token.
       MIOpt.ReadToken();
 
+      if (!ParsingPreprocessorDirective && LexFortranNumericConstant(Result))
+        return;
       return LexNumericConstant(Result, ConsumeChar(CurPtr, SizeTmp, Result));
     } else if (LangOpts.CPlusPlus && Char == '*') {
       Kind = tok::periodstar;
@@ -460,7 +460,8 @@ static void EncodeUCNEscape(const char *ThisTokBegin, const char *&ThisTokBuf,
 ///
 NumericLiteralParser::NumericLiteralParser(StringRef TokSpelling,
                                            SourceLocation TokLoc,
-                                           Preprocessor &PP)
+                                           Preprocessor &PP,
+                                           bool InPPDirective)
   : PP(PP), ThisTokBegin(TokSpelling.begin()), ThisTokEnd(TokSpelling.end()) {
 
   // This routine assumes that the range begin/end matches the regex for integer
@@ -481,17 +482,50 @@ NumericLiteralParser::NumericLiteralParser(StringRef TokSpelling,
   isImaginary = false;
   isMicrosoftInteger = false;
   hadError = false;
+  ExponentLetter = 0;
+  KindParamBegin = ThisTokEnd;
+  HasCachedValue = false;
+
+  // The lexer has usually just classified this constant.
+  if (const NumericLiteralScan *Scan =
+        PP.getCachedNumericLiteral(TokSpelling)) {
+    radix = Scan->Radix;
+    DigitsBegin = ThisTokBegin + Scan->DigitsBegin;
+    SuffixBegin = ThisTokBegin + Scan->DigitsEnd;
+    s = ThisTokEnd;
+    saw_period = Scan->HasPeriod;
+    saw_exponent = Scan->ExponentLetter != 0;
+    ExponentLetter = Scan->ExponentLetter;
+    isLong = ExponentLetter == 'q';
+    if (Scan->KindBegin != Scan->Length)
+      KindParamBegin = ThisTokBegin + Scan->KindBegin;
+    HasCachedValue = Scan->HasValue;
+    CachedValue = Scan->Value;
+    return;
+  }
+
+  // Fortran binary, octal and hexadecimal constants: B'0101', O'17', Z'ff'.
+  if ((*s == 'b' || *s == 'B' || *s == 'o' || *s == 'O' ||
+       *s == 'z' || *s == 'Z') && (s[1] == '\'' || s[1] == '"')) {
+    ParseBOZConstant(TokLoc);
+    return;
+  }
 
-  if (*s == '0') { // parse radix
+  // Fortran has no octal constants with a leading zero, so only the C hex
+  // and binary prefixes take the radix path.  Preprocessor expressions keep
+  // the C meaning, as they do in cpp and fpp.
+  if (*s == '0' && (InPPDirective || s[1] == 'x' || s[1] == 'X' ||
+                    s[1] == 'b' || s[1] == 'B')) {
     ParseNumberStartingWithZero(TokLoc);
     if (hadError)
       return;
-  } else { // the first digit is non-zero
+  } else { // a decimal number
     radix = 10;
     s = SkipDigits(s);
     if (s == ThisTokEnd) {
       // Done.
-    } else if (isxdigit(*s) && !(*s == 'e' || *s == 'E')) {
+    } else if (isxdigit(*s) && !(*s == 'e' || *s == 'E' ||
+                                 *s == 'd' || *s == 'D')) {
       PP.Diag(PP.AdvanceToTokenCharacter(TokLoc, s - ThisTokBegin),
               diag::err_invalid_decimal_digit) << StringRef(s, 1);
       hadError = true;
@@ -501,8 +535,11 @@ NumericLiteralParser::NumericLiteralParser(StringRef TokSpelling,
       saw_period = true;
       s = SkipDigits(s);
     }
-    if ((*s == 'e' || *s == 'E')) { // exponent
+    if (*s == 'e' || *s == 'E' || *s == 'd' || *s == 'D' ||
+        *s == 'q' || *s == 'Q') { // exponent
       const char *Exponent = s;
+      ExponentLetter = tolower(*s);
+      isLong = ExponentLetter == 'q';
       s++;
       saw_exponent = true;
       if (*s == '+' || *s == '-')  s++; // sign
@@ -520,6 +557,18 @@ NumericLiteralParser::NumericLiteralParser(StringRef TokSpelling,
 
   SuffixBegin = s;
 
+  // R407-F08 kind-param: a digit-string or a scalar-int-constant-name.
+  if (*s == '_' && s + 1 != ThisTokEnd && !PP.getLangOpts().CPlusPlus11) {
+    const char *KindEnd = s + 1;
+    while (KindEnd != ThisTokEnd && (isalnum(*KindEnd) || *KindEnd == '_'))
+      ++KindEnd;
+    if (KindEnd == ThisTokEnd) {
+      KindParamBegin = s;
+      s = ThisTokEnd;
+      return;
+    }
+  }
+
   // Parse the suffix.  At this point we can classify whether we have an FP or
   // integer constant.
   bool isFPConstant = isFloatingLiteral();
@@ -763,6 +812,33 @@ void NumericLiteralParser::ParseNumberStartingWithZero(SourceLocation TokLoc) {
   }
 }
 
+/// ParseBOZConstant - This method is called when the number is a Fortran
+/// binary, octal or hexadecimal constant, like B'0101' or Z"ff".
+void NumericLiteralParser::ParseBOZConstant(SourceLocation TokLoc) {
+  switch (*s) {
+  case 'b': case 'B': radix = 2; break;
+  case 'o': case 'O': radix = 8; break;
+  default:            radix = 16; break;
+  }
+  char Delim = s[1];
+  s += 2;
+  DigitsBegin = s;
+  for (; s != ThisTokEnd && *s != Delim; ++s) {
+    int Digit = HexDigitValue(*s);
+    if (Digit < 0 || Digit >= (int) radix) {
+      PP.Diag(PP.AdvanceToTokenCharacter(TokLoc, s - ThisTokBegin),
+              radix == 2 ? diag::err_invalid_binary_digit :
+              radix == 8 ? diag::err_invalid_octal_digit :
+                           diag::err_invalid_hex_digit) << StringRef(s, 1);
+      hadError = true;
+      return;
+    }
+  }
+  // The lexer has checked for the closing delimiter.
+  SuffixBegin = s;
+  s = ThisTokEnd;
+}
+
 static bool alwaysFitsInto64Bits(unsigned Radix, unsigned NumDigits) {
   switch (Radix) {
   case 2:
@@ -782,6 +858,12 @@ static bool alwaysFitsInto64Bits(unsigned Radix, unsigned NumDigits) {
 /// matches Val's input width.  If there is an overflow, set Val to the low bits
 /// of the result and return true.  Otherwise, return false.
 bool NumericLiteralParser::GetIntegerValue(llvm::APInt &Val) {
+  // Fastest path: the lexer worked out the value while scanning the digits.
+  if (HasCachedValue) {
+    Val = CachedValue;
+    return Val.getZExtValue() != CachedValue;
+  }
+
   // Fast path: Compute a conservative bound on the maximum number of
   // bits per digit in this radix. If we can't possibly overflow a
   // uint64 based on that bound then do the simple conversion to
@@ -837,8 +919,19 @@ NumericLiteralParser::GetFloatValue(llvm::APFloat &Result) {
   using llvm::APFloat;
 
   unsigned n = std::min(SuffixBegin - ThisTokBegin, ThisTokEnd - ThisTokBegin);
-  return Result.convertFromString(StringRef(ThisTokBegin, n),
-                                  APFloat::rmNearestTiesToEven);
+  StringRef Str(ThisTokBegin, n);
+
+  // APFloat only knows the 'e' exponent letter.
+  SmallString<32> Buffer;
+  if (ExponentLetter == 'd' || ExponentLetter == 'q') {
+    Buffer = Str;
+    for (unsigned i = 0, e = Buffer.size(); i != e; ++i)
+      if (isalpha(Buffer[i]))
+        Buffer[i] = 'e';
+    Str = Buffer;
+  }
+
+  return Result.convertFromString(Str, APFloat::rmNearestTiesToEven);
 }
 
 
@@ -16,20 +16,24 @@
 #include "lfort/Basic/FileSystemStatCache.h"
 #include "lfort/Basic/IdentifierTable.h"
 #include "lfort/Basic/OnDiskHashTable.h"
+#include "lfort/Basic/SourceManager.h"
 #include "lfort/Basic/TokenKinds.h"
 #include "lfort/Lex/LexDiagnostic.h"
 #include "lfort/Lex/PTHManager.h"
 #include "lfort/Lex/Preprocessor.h"
 #include "lfort/Lex/Token.h"
 #include "llvm/ADT/OwningPtr.h"
+#include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/StringExtras.h"
 #include "llvm/ADT/StringMap.h"
+#include "llvm/Support/Format.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
 #include "llvm/Support/system_error.h"
 using namespace lfort;
 using namespace lfort::io;
 
-#define DISK_TOKEN_SIZE (1+1+2+4+4)
+#define DISK_TOKEN_SIZE (2+2+4+4+4)
 
 //===----------------------------------------------------------------------===//
 // PTHLexer methods.
@@ -44,6 +48,10 @@ PTHLexer::PTHLexer(Preprocessor &PP, FileID FID, const unsigned char *D,
 }
 
 void PTHLexer::Lex(Token& Tok) {
+  // A Fortran statement label is cached as a token of its own; it is attached
+  // to the token that follows it.
+  unsigned StmtLabel = (unsigned) -1;
+
 LexNextToken:
 
   //===--------------------------------------==//
@@ -55,12 +63,12 @@ LexNextToken:
 
   // Read in the data for the token.
   unsigned Word0 = ReadLE32(CurPtrShadow);
+  uint32_t Len = ReadLE32(CurPtrShadow);
   uint32_t IdentifierID = ReadLE32(CurPtrShadow);
   uint32_t FileOffset = ReadLE32(CurPtrShadow);
 
-  tok::TokenKind TKind = (tok::TokenKind) (Word0 & 0xFF);
-  Token::TokenFlags TFlags = (Token::TokenFlags) ((Word0 >> 8) & 0xFF);
-  uint32_t Len = Word0 >> 16;
+  tok::TokenKind TKind = (tok::TokenKind) (Word0 & 0xFFFF);
+  Token::TokenFlags TFlags = (Token::TokenFlags) ((Word0 >> 16) & 0xFF);
 
   CurPtr = CurPtrShadow;
 
@@ -74,10 +82,23 @@ LexNextToken:
   assert(!LexingRawMode);
   Tok.setLocation(FileStartLoc.getLocWithOffset(FileOffset));
   Tok.setLength(Len);
+  if (StmtLabel != (unsigned) -1)
+    Tok.setStmtLabel(StmtLabel);
 
   // Handle identifiers.
   if (Tok.isLiteral()) {
-    Tok.setLiteralData((const char*) (PTHMgr.SpellingBase + IdentifierID));
+    const char *LiteralData =
+      (const char*) (PTHMgr.SpellingBase + IdentifierID);
+    Tok.setLiteralData(LiteralData);
+
+    // R312-F08 label: the same rule as in Lexer::LexTokenInternal.
+    if (TKind == tok::numeric_constant && Tok.isAtStartOfLine() && Len <= 5) {
+      MIOpt.ReadToken();
+      StmtLabel = 0;
+      for (unsigned i = 0; i < Len; ++i)
+        StmtLabel = StmtLabel*10+(LiteralData[i]-'0');
+      goto LexNextToken;
+    }
   }
   else if (IdentifierID) {
     MIOpt.ReadToken();
@@ -91,6 +112,20 @@ LexNextToken:
 
     if (II->isHandleIdentifierCase())
       PP->HandleIdentifier(Tok);
+
+    // A Fortran INCLUDE line was cached with an eod token after the filename,
+    // so it is handled just like a '#include' directive.
+    if (!ParsingPreprocessorDirective && Tok.isAtStartOfLine() &&
+        (Tok.is(tok::kw_include) || (Tok.is(tok::identifier) &&
+         II->getName().equals_lower("include")))) {
+      PP->HandleDirective(Tok);
+
+      StmtLabel = (unsigned) -1;
+      if (PP->isCurrentLexer(this))
+        goto LexNextToken;
+
+      return PP->Lex(Tok);
+    }
     return;
   }
 
@@ -177,11 +212,11 @@ void PTHLexer::DiscardToEndOfLine() {
   const unsigned char* p = CurPtr;
   while (1) {
     // Read the token kind.  Are we at the end of the file?
-    tok::TokenKind x = (tok::TokenKind) (uint8_t) *p;
+    tok::TokenKind x = (tok::TokenKind) (p[0] | (p[1] << 8));
     if (x == tok::eof) break;
 
     // Read the token flags.  Are we at the start of the next line?
-    Token::TokenFlags y = (Token::TokenFlags) (uint8_t) p[1];
+    Token::TokenFlags y = (Token::TokenFlags) (uint8_t) p[2];
     if (y & Token::StartOfLine) break;
 
     // Skip to the next token.
@@ -276,7 +311,7 @@ bool PTHLexer::SkipBlock() {
   LastHashTokPtr = CurPtr;
 
   // Skip the '#' token.
-  assert(((tok::TokenKind)*CurPtr) == tok::hash);
+  assert(((tok::TokenKind)(CurPtr[0] | (CurPtr[1] << 8))) == tok::hash);
   CurPtr += DISK_TOKEN_SIZE;
 
   // Did we reach a #endif?  If so, go ahead and consume that token as well.
@@ -359,6 +394,28 @@ public:
   }
 };
 
+class PTHContentLookupTrait : public PTHFileLookupCommonTrait {
+public:
+  typedef const char* external_key_type;
+  typedef PTHFileData data_type;
+
+  static internal_key_type GetInternalKey(const char *Key) {
+    return std::make_pair((unsigned char) 0x3, Key);
+  }
+
+  static bool EqualKey(internal_key_type a, internal_key_type b) {
+    return a.first == b.first && strcmp(a.second, b.second) == 0;
+  }
+
+  static PTHFileData ReadData(const internal_key_type& k,
+                              const unsigned char* d, unsigned) {
+    assert(k.first == 0x3 && "Only content lookups can match!");
+    uint32_t x = ::ReadUnalignedLE32(d);
+    uint32_t y = ::ReadUnalignedLE32(d);
+    return PTHFileData(x, y);
+  }
+};
+
 class PTHStringLookupTrait {
 public:
   typedef uint32_t
@@ -403,6 +460,7 @@ public:
 } // end anonymous namespace
 
 typedef OnDiskChainedHashTable<PTHFileLookupTrait>   PTHFileLookup;
+typedef OnDiskChainedHashTable<PTHContentLookupTrait> PTHContentLookup;
 typedef OnDiskChainedHashTable<PTHStringLookupTrait> PTHStringIdLookup;
 
 //===----------------------------------------------------------------------===//
@@ -583,8 +641,28 @@ IdentifierInfo* PTHManager::get(StringRef Name) {
   return GetIdentifierInfo(*I-1);
 }
 
+void PTHManager::getContentKey(StringRef Buffer, bool FreeForm,
+                               SmallVectorImpl<char> &Key) {
+  // 64-bit FNV-1a.  The key has to be stable across runs and hosts, which
+  // rules out llvm::hash_value.
+  uint64_t Hash = 14695981039346656037ULL;
+  for (const char *I = Buffer.begin(), *E = Buffer.end(); I != E; ++I) {
+    Hash ^= (unsigned char) *I;
+    Hash *= 1099511628211ULL;
+  }
+
+  // The source form decides how the file is tokenized, so it is part of the
+  // key along with the size of the file.
+  llvm::raw_svector_ostream OS(Key);
+  OS << (FreeForm ? "free:" : "fixed:") << Buffer.size() << ':'
+     << llvm::format("%016llx", (unsigned long long) Hash);
+  OS.flush();
+}
+
 PTHLexer *PTHManager::CreateLexer(FileID FID) {
-  const FileEntry *FE = PP->getSourceManager().getFileEntryForID(FID);
+  assert(PP && "No preprocessor set yet!");
+  SourceManager &SM = PP->getSourceManager();
+  const FileEntry *FE = SM.getFileEntryForID(FID);
   if (!FE)
     return 0;
 
@@ -594,21 +672,42 @@ PTHLexer *PTHManager::CreateLexer(FileID FID) {
   PTHFileLookup& PFL = *((PTHFileLookup*)FileLookup);
   PTHFileLookup::iterator I = PFL.find(FE);
 
-  if (I == PFL.end()) // No tokens available?
-    return 0;
+  uint32_t TokenOff, PPCondOff;
+  if (I != PFL.end()) {
+    const PTHFileData& FileData = *I;
+    TokenOff = FileData.getTokenOffset();
+    PPCondOff = FileData.getPPCondOffset();
+  } else {
+    // The file may still have been cached under another path, as happens
+    // when the same INCLUDE file is copied into many source directories.
+    bool Invalid = false;
+    const llvm::MemoryBuffer *B = SM.getBuffer(FID, &Invalid);
+    if (Invalid)
+      return 0;
+
+    SmallString<64> Key;
+    getContentKey(B->getBuffer(), PP->getLangOpts().FreeForm, Key);
 
-  const PTHFileData& FileData = *I;
+    PTHContentLookup CL(PFL.getNumBuckets(), PFL.getNumEntries(),
+                        PFL.getBuckets(), PFL.getBase());
+    PTHContentLookup::iterator CI = CL.find(Key.c_str());
+    if (CI == CL.end()) // No tokens available?
+      return 0;
+
+    const PTHFileData& FileData = *CI;
+    TokenOff = FileData.getTokenOffset();
+    PPCondOff = FileData.getPPCondOffset();
+  }
 
   const unsigned char *BufStart = (const unsigned char *)Buf->getBufferStart();
   // Compute the offset of the token data within the buffer.
-  const unsigned char* data = BufStart + FileData.getTokenOffset();
+  const unsigned char* data = BufStart + TokenOff;
 
   // Get the location of pp-conditional table.
-  const unsigned char* ppcond = BufStart + FileData.getPPCondOffset();
+  const unsigned char* ppcond = BufStart + PPCondOff;
   uint32_t Len = ReadLE32(ppcond);
   if (Len == 0) ppcond = 0;
 
-  assert(PP && "No preprocessor set yet!");
   return new PTHLexer(*PP, FID, data, ppcond, *this);
 }
 
@@ -645,7 +744,9 @@ public:
 
   static bool EqualKey(internal_key_type a, internal_key_type b) {
     // When doing 'stat' lookups we don't care about the kind of 'a' and 'b',
-    // just the paths.
+    // just the paths.  Content keys are not paths at all.
+    if (a.first == 0x3 || b.first == 0x3)
+      return false;
     return strcmp(a.second, b.second) == 0;
   }
 
@@ -99,6 +99,9 @@ Preprocessor::Preprocessor(llvm::IntrusiveRefCntPtr<PreprocessorOptions> PPOpts,
   PragmasEnabled = true;
 
   CachedLexPos = 0;
+
+  for (unsigned I = 0; I != NumericLiteralCacheSize; ++I)
+    NumericLiteralCache[I].TokStart = 0;
   
   // We haven't read anything from the external source.
   ReadMacrosFromExternalSource = false;
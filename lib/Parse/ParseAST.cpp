@@ -138,6 +138,7 @@ void lfort::ParseAST(Sema &S, bool PrintStats, bool SkipSubprogramBodies) {
   std::swap(OldCollectStats, S.CollectStats);
   if (PrintStats) {
     llvm::errs() << "\nSTATISTICS:\n";
+    P.PrintStats();
     P.getActions().PrintStats();
     S.getASTContext().PrintStats();
     Decl::PrintStats();
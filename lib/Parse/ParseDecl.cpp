@@ -1774,6 +1774,8 @@ Parser::DeclGroupPtrTy Parser::ParseEntityDeclList(ParsingDeclSpec &DS,
     // Parse the next declarator.
     D.clear();
     D.setCommaLoc(CommaLoc);
+    for (unsigned i = 0; i < DeclaratorChunks.size(); ++i)
+      D.AddInnermostTypeInfo(DeclaratorChunks[i]);
 
     ParseEntityDecl(D);
     if (!D.isInvalidType()) {
@@ -3225,7 +3227,7 @@ void Parser::ParseDeclarationTypeSpec(DeclSpec &DS,
     Diag(Tok, diag::ext_intrinsic_type) << "byte";
     break;
   case tok::kw_logical:
-    if (NextToken().isInLine(tok::l_paren) || NextToken().isInLine(tok::star)) {
+    if (isTypeSelectorNext()) {
       bool OldStyle = NextToken().isInLine(tok::star);
       unsigned KindValue;
       SourceLocation KindValueLoc;
@@ -3253,7 +3255,7 @@ void Parser::ParseDeclarationTypeSpec(DeclSpec &DS,
   case tok::kw_real: {
     bool isComplex = Tok.is(tok::kw_complex);
     DeclSpec::TST T = DeclSpec::TST_float;
-    if (NextToken().isInLine(tok::l_paren) || NextToken().isInLine(tok::star)) {
+    if (isTypeSelectorNext()) {
       bool OldStyle = NextToken().isInLine(tok::star);
       unsigned KindValue;
       SourceLocation KindValueLoc;
@@ -3298,7 +3300,7 @@ void Parser::ParseDeclarationTypeSpec(DeclSpec &DS,
     break; }
   case tok::kw_integer: {
     DeclSpec::TST T = DeclSpec::TST_int;
-    if (NextToken().isInLine(tok::l_paren) || NextToken().isInLine(tok::star)) {
+    if (isTypeSelectorNext()) {
       bool OldStyle = NextToken().isInLine(tok::star);
       unsigned KindValue;
       SourceLocation KindValueLoc;
@@ -3357,7 +3359,7 @@ void Parser::ParseDeclarationTypeSpec(DeclSpec &DS,
   case tok::kw_character: {
     DeclSpec::TST T = DeclSpec::TST_char;
     bool LenProvided = false;
-    if (NextToken().isInLine(tok::l_paren) || NextToken().isInLine(tok::star)) {
+    if (isTypeSelectorNext()) {
       bool OldStyle = NextToken().isInLine(tok::star);
       unsigned KindValue;
       ExprResult LenValue;
@@ -4848,7 +4850,42 @@ void Parser::ParseEntityDecl(Declarator &D) {
     ConsumeToken();
   } else return;
 
-  
+  if (Tok.isInLine(tok::l_paren))
+    ParseArraySpec(D);
+}
+
+/// R515 array-spec is explicit-shape-spec-list
+///
+/// R516 explicit-shape-spec is [ lower-bound : ] upper-bound
+///
+/// Each dimension becomes an array declarator chunk.  The first dimension
+/// varies fastest in memory, so it is the innermost array type: a(2,3) is
+/// laid out like the C array a[3][2].
+void Parser::ParseArraySpec(Declarator &D) {
+  BalancedDelimiterTracker T(*this, tok::l_paren);
+  T.consumeOpen();
+
+  while (true) {
+    // FIXME: lower bounds.
+    SourceLocation Loc = Tok.getLocation();
+    ExprResult Extent(ParseConstantExpression());
+    if (Extent.isInvalid()) {
+      D.setInvalidType(true);
+      SkipUntil(tok::r_paren);
+      return;
+    }
+
+    D.AddInnermostTypeInfo(DeclaratorChunk::getArray(0, false, false,
+                                                     Extent.take(), Loc,
+                                                     Tok.getLocation()));
+    if (!Tok.isInLine(tok::comma))
+      break;
+    ConsumeToken();
+  }
+
+  if (T.consumeClose())
+    D.setInvalidType(true);
+  D.SetRangeEnd(T.getCloseLocation());
 }
 
 static bool isPtrOperatorToken(tok::TokenKind Kind, const LangOptions &Lang) {
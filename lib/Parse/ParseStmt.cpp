@@ -391,6 +391,29 @@ Retry:
     return ParseExprStatement();
   }
 
+  case tok::kw_use: {               // R1109-F08: use-stmt
+    if (ExecOnly) {
+      SkipToNextLine();
+      return StmtError();
+    }
+
+    SourceLocation UseStart = Tok.getLocation();
+    DeclGroupPtrTy Decls = ParseUseStmt();
+    if (!Decls)
+      return StmtEmpty();
+    return Actions.ActOnDeclStmt(Decls, UseStart, PrevTokLocation);
+  }
+
+  case tok::kw_implicit: {          // R560-F08: implicit-stmt
+    if (ExecOnly) {
+      SkipToNextLine();
+      return StmtError();
+    }
+
+    ParseImplicit();
+    return StmtEmpty();
+  }
+
   case tok::kw_case:                // C99 6.8.1: labeled-statement
     return ParseCaseStatement();
   case tok::kw_default:             // C99 6.8.1: labeled-statement
@@ -411,6 +434,8 @@ Retry:
   case tok::kw_while:               // C99 6.8.5.1: while-statement
     return ParseWhileStatement(0/*TrailingElseLoc*/);
   case tok::kw_do:                  // C99 6.8.5.2: do-statement
+    if (NextToken().isInLine(tok::kw_concurrent))
+      return ParseDoConcurrentConstruct();
     Res = ParseDoStatement();
     SemiError = "do/while";
     break;
@@ -1085,7 +1110,8 @@ Parser::ParseBlock() {
   // Parse any pragmas at the beginning of the block.
   ParseCompoundStatementLeadingPragmas();
 
-  StmtVector Stmts;
+  // The statements of this block go on top of those of the enclosing blocks.
+  unsigned FirstStmt = BlockStmts.size();
 
   SourceLocation OpenLoc = Tok.getLocation();
 
@@ -1099,14 +1125,30 @@ Parser::ParseBlock() {
       continue;
     }
 
-    StmtResult R = ParseExecOrSpecPartConstruct(Stmts);
-    if (R.isUsable())
-      Stmts.push_back(R.release());
+    StmtResult R = ParseExecOrSpecPartConstruct(BlockStmts);
+    if (R.isUsable()) {
+      if (BlockStmts.size() == BlockStmts.capacity())
+        ++NumBlockStmtsGrowths;
+      BlockStmts.push_back(R.release());
+      ++NumBlockStmts;
+    }
   }
 
   SourceLocation CloseLoc = Tok.getLocation();
 
-  return Actions.ActOnBlock(OpenLoc, CloseLoc, Stmts, false);
+  // Count the allocations a statement list of this block's own would have
+  // made, growing the way a SmallVector of pointers does.
+  unsigned NumStmts = BlockStmts.size() - FirstStmt;
+  for (size_t Capacity = StmtVector().capacity(); Capacity < NumStmts;
+       Capacity = 2 * Capacity + 1)
+    ++NumPerBlockStmtsGrowths;
+
+  StmtResult Block = Actions.ActOnBlock(
+    OpenLoc, CloseLoc,
+    MultiStmtArg(BlockStmts.data() + FirstStmt, BlockStmts.size() - FirstStmt),
+    false);
+  BlockStmts.resize(FirstStmt);
+  return Block;
 }
 
 /// ParseParenExprOrCondition:
@@ -1493,6 +1535,151 @@ StmtResult Parser::ParseDoStatement() {
                              Cond.get(), T.getCloseLocation());
 }
 
+/// \brief Parse the concurrent-header of a DO CONCURRENT construct,
+/// declaring its index-names in the current scope.
+///
+/// \returns true if there was a parse error.
+bool Parser::ParseConcurrentHeader(BalancedDelimiterTracker &T,
+                                   SmallVectorImpl<VarDecl *> &Indices,
+                                   ExprVector &Limits, ExprResult &Mask) {
+  if (T.expectAndConsume(diag::err_expected_lparen_after, "concurrent"))
+    return true;
+
+  ParsedType IndexTy;
+  if (Tok.is(tok::kw_integer)) {
+    ParsingDeclSpec DS(*this);
+    SmallVector<DeclaratorChunk, 4> DeclaratorChunks;
+    ParseDeclarationTypeSpec(DS, DeclaratorChunks);
+    Declarator D(DS, Declarator::TypeNameContext);
+    for (unsigned I = 0, N = DeclaratorChunks.size(); I != N; ++I)
+      D.AddInnermostTypeInfo(DeclaratorChunks[I]);
+    TypeResult Ty = Actions.ActOnTypeName(getCurScope(), D);
+    if (!Ty.isInvalid())
+      IndexTy = Ty.get();
+    if (ExpectAndConsume(tok::coloncolon, diag::err_expected_coloncolon))
+      return true;
+  }
+
+  // The limits are parsed before any index-name is declared, since they
+  // may not refer to the indices of the header.
+  SmallVector<IdentifierInfo *, 4> Names;
+  SmallVector<SourceLocation, 4> NameLocs;
+  bool HasMask = false;
+  while (true) {
+    if (Tok.isNot(tok::identifier) || NextToken().isNot(tok::equal)) {
+      Diag(Tok, diag::err_expected_concurrent_index);
+      return true;
+    }
+    Names.push_back(Tok.getIdentifierInfo());
+    NameLocs.push_back(ConsumeToken());
+    ConsumeToken();  // eat the '='.
+
+    ColonProtectionRAIIObject ColonProtection(*this);
+    ExprResult Lower = ParseAssignmentExpression();
+    if (Lower.isInvalid() ||
+        ExpectAndConsume(tok::colon, diag::err_expected_colon))
+      return true;
+    ExprResult Upper = ParseAssignmentExpression();
+    ExprResult Step;
+    if (!Upper.isInvalid() && Tok.is(tok::colon)) {
+      ConsumeToken();
+      Step = ParseAssignmentExpression();
+    }
+    if (Upper.isInvalid() || Step.isInvalid())
+      return true;
+    Limits.push_back(Lower.take());
+    Limits.push_back(Upper.take());
+    Limits.push_back(Step.take());
+
+    if (Tok.isNot(tok::comma))
+      break;
+    ConsumeToken();
+
+    // Anything other than another triplet is the mask.
+    if (Tok.isNot(tok::identifier) || NextToken().isNot(tok::equal)) {
+      HasMask = true;
+      break;
+    }
+  }
+
+  bool Invalid = false;
+  for (unsigned I = 0, N = Names.size(); I != N; ++I) {
+    VarDecl *Index = Actions.ActOnDoConcurrentIndex(getCurScope(), Names[I],
+                                                    NameLocs[I], IndexTy);
+    if (!Index)
+      Invalid = true;
+    Indices.push_back(Index);
+  }
+
+  if (HasMask)
+    Mask = ParseAssignmentExpression();
+  return T.consumeClose() || Mask.isInvalid() || Invalid;
+}
+
+/// ParseDoConcurrentConstruct
+///       do-concurrent-construct: [F08 8.1.6]
+///         'do' 'concurrent' concurrent-header
+///           block
+///         end-do-stmt
+///
+///       concurrent-header: [R754-F08]
+///         '(' [integer-type-spec '::'] concurrent-triplet-spec-list
+///             [',' scalar-mask-expr] ')'
+///
+///       concurrent-triplet-spec: [R755-F08]
+///         index-name '=' concurrent-limit ':' concurrent-limit
+///             [':' concurrent-step]
+///
+///       end-do-stmt: [R822-F08]
+///         'end' 'do' [do-construct-name]
+///         'enddo' [do-construct-name]
+StmtResult Parser::ParseDoConcurrentConstruct() {
+  assert(Tok.is(tok::kw_do) && "Not a do concurrent construct!");
+  SourceLocation DoLoc = ConsumeToken();  // eat the 'do'.
+  ConsumeToken();                          // eat the 'concurrent'.
+
+  // The index-names are local to the construct.
+  ParseScope ConcurrentScope(this, Scope::DeclScope);
+
+  SmallVector<VarDecl *, 4> Indices;
+  ExprVector Limits;
+  ExprResult Mask;
+  BalancedDelimiterTracker T(*this, tok::l_paren);
+  bool Invalid = ParseConcurrentHeader(T, Indices, Limits, Mask);
+  if (Invalid && !Tok.isAtStartOfNonContinuationLine())
+    SkipToNextLine();
+
+  StmtResult Body(ParseBlock());
+
+  SourceLocation EndLoc = Tok.getLocation();
+  if (Tok.is(tok::kw_enddo)) {
+    ConsumeToken();
+  } else if (Tok.is(tok::kw_end) && NextToken().isInLine(tok::kw_do)) {
+    ConsumeToken();
+    EndLoc = ConsumeToken();
+  } else {
+    Diag(Tok, diag::err_expected_end_do);
+    Diag(DoLoc, diag::note_matching) << "do concurrent";
+    return StmtError();
+  }
+
+  // FIXME: Check the do-construct-name against the name of the construct.
+  if (Tok.isInLine(tok::identifier))
+    EndLoc = ConsumeToken();
+  if (Tok.is(tok::semi))
+    ConsumeToken();
+
+  ConcurrentScope.Exit();
+
+  if (Invalid || Body.isInvalid())
+    return StmtError();
+
+  return Actions.ActOnDoConcurrentStmt(DoLoc, T.getOpenLocation(), Indices,
+                                       Limits, Mask.get(),
+                                       T.getCloseLocation(), Body.get(),
+                                       EndLoc);
+}
+
 /// ParseForStatement
 ///       for-statement: [C99 6.8.5.3]
 ///         'for' '(' expr[opt] ';' expr[opt] ';' expr[opt] ')' statement
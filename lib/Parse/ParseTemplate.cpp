@@ -1240,6 +1240,10 @@ void Parser::LateTemplateParserCallback(void *P, const SubprogramDecl *FD) {
 
 void Parser::LateTemplateParser(const SubprogramDecl *FD) {
   LateParsedTemplatedSubprogram *LPT = LateParsedTemplateMap[FD];
+  if (LPT && LPT->IsFortranBody) {
+    ParseLateFortranBody(*LPT);
+    return;
+  }
   if (LPT) {
     ParseLateTemplatedFuncDef(*LPT);
     return;
@@ -18,6 +18,7 @@
 #include "lfort/AST/DeclTemplate.h"
 #include "lfort/Parse/ParseDiagnostic.h"
 #include "lfort/Sema/DeclSpec.h"
+#include "lfort/Sema/ImplicitTypeTable.h"
 #include "lfort/Sema/ParsedTemplate.h"
 #include "lfort/Sema/PrettyDeclStackTrace.h"
 #include "lfort/Sema/Scope.h"
@@ -53,7 +54,8 @@ IdentifierInfo *Parser::getSEHExceptKeyword() {
 Parser::Parser(Preprocessor &pp, Sema &actions, bool skipSubprogramBodies)
   : PP(pp), Actions(actions), Diags(PP.getDiagnostics()),
     GreaterThanIsOperator(true), ColonIsSacred(false), 
-    InMessageExpression(false), TemplateParameterDepth(0),
+    InMessageExpression(false), ParenIsImplicitLetterSpecList(false),
+    TemplateParameterDepth(0),
     ParsingInObjCContainer(false) {
   SkipSubprogramBodies = pp.isCodeCompletionEnabled() || skipSubprogramBodies;
   Tok.startToken();
@@ -62,6 +64,7 @@ Parser::Parser(Preprocessor &pp, Sema &actions, bool skipSubprogramBodies)
   NumCachedScopes = 0;
   ParenCount = BracketCount = BraceCount = 0;
   CurParsedObjCImpl = 0;
+  NumBlockStmts = NumBlockStmtsGrowths = NumPerBlockStmtsGrowths = 0;
 
   // Add #pragma handlers. These are removed and destroyed in the
   // destructor.
@@ -397,6 +400,15 @@ Parser::ParseScopeFlags::~ParseScopeFlags() {
 // C99 6.9: External Definitions.
 //===----------------------------------------------------------------------===//
 
+void Parser::PrintStats() const {
+  llvm::errs() << "\n*** Parser Stats:\n";
+  llvm::errs() << NumBlockStmts << " statements parsed into blocks.\n";
+  llvm::errs() << NumBlockStmtsGrowths
+               << " allocations for block statement lists.\n";
+  llvm::errs() << NumPerBlockStmtsGrowths
+               << " allocations for per-block statement lists avoided.\n";
+}
+
 Parser::~Parser() {
   // If we still have scopes active, delete the scope tree.
   delete getCurScope();
@@ -411,6 +423,10 @@ Parser::~Parser() {
       it != LateParsedTemplateMap.end(); ++it)
     delete it->second;
 
+  // Sema outlives the parser; don't leave it a callback into this one.
+  if (Actions.OpaqueParser == this)
+    Actions.SetLateTemplateParser(0, 0);
+
   // Remove the pragma handlers we installed.
   PP.RemovePragmaHandler(AlignHandler.get());
   AlignHandler.reset();
@@ -552,6 +568,13 @@ bool Parser::ParseTopLevelDecl(DeclGroupPtrTy &Result) {
     // Late template parsing can begin.
     if (getLangOpts().DelayedTemplateParsing)
       Actions.SetLateTemplateParser(LateTemplateParserCallback, this);
+
+    // Parse the skipped bodies the consumer still needs while the parser is
+    // around to do it.
+    if (!SkippedFortranBodies.empty() &&
+        Actions.getASTConsumer().needsSkippedSubprogramBodies())
+      ParseSkippedFortranBodies();
+
     if (!PP.isIncrementalProcessingEnabled())
       Actions.ActOnEndOfProgram();
     //else don't tell Sema that we ended parsing: more input might come.
@@ -700,84 +723,50 @@ Parser::ParseMainProgram() {
     ProgramLoc = Tok.getLocation();
   }
 
-  ParsingDeclSpec DS(*this);
-  ParsingDeclarator D(*this, DS, Declarator::FileContext);
-  if (ProgramName)
-    D.SetIdentifier(ProgramName, ProgramNameLoc);
-  else
-    D.SetIdentifier(PP.getIdentifierInfo("<main-program>"), ProgramLoc);
-
-  const char *PrevSpec;
-  unsigned DiagID;
-  D.getMutableDeclSpec().SetTypeSpecType(DeclSpec::TST_void,
-                                         D.getIdentifierLoc(),
-                                         PrevSpec, DiagID);
-  D.SetRangeBegin(D.getDeclSpec().getSourceRange().getBegin());
-
-  SmallVector<DeclaratorChunk::ParamInfo, 16> ParamInfo;
-  ExceptionSpecificationType ESpecType = EST_None;
-  SmallVector<ParsedType, 2> DynamicExceptions;
-  SmallVector<SourceRange, 2> DynamicExceptionRanges;
-  ParsedType TrailingReturnType;
-
-  ParsedAttributes SubPgmAttrs(AttrFactory);
-
-  // FIXME: attributes need a comma first and are comma separated.
-  MaybeParseAttributes(SubPgmAttrs);
-
-  // Remember that we parsed a function type, and remember the attributes.
-  D.AddTypeInfo(DeclaratorChunk::getSubprogram(true,
-                                             false,
-                                             SourceLocation(),
-                                             ParamInfo.data(),
-                                             ParamInfo.size(),
-                                             SourceLocation(),
-                                             SourceLocation(),
-                                             DS.getTypeQualifiers(),
-                                             false,
-                                             SourceLocation(),
-                                             SourceLocation(),
-                                             SourceLocation(),
-                                             SourceLocation(),
-                                             ESpecType,
-                                             SourceLocation(),
-                                             DynamicExceptions.data(),
-                                             DynamicExceptionRanges.data(),
-                                             DynamicExceptions.size(),
-                                             0,
-                                             ProgramLoc, 
-                                             ProgramLoc,
-                                             D,
-                                             TrailingReturnType,
-                                             /* IsMainProgram */ true),
-                SubPgmAttrs, ProgramLoc);
-
   // Enter a scope for the MAIN__ function body.
   ParseScope BodyScope(this, Scope::SubPgmScope|Scope::DeclScope);
 
-  Decl *Res = Actions.ActOnStartOfSubprogramDef(getCurScope(), D);
-
-  // Break out of the ParsingDeclarator context before we parse the body.
-  D.complete(Res);
+  // A main program has no dummy arguments, result or attributes, so its
+  // declaration is built directly rather than through a declarator.
+  Decl *Res = Actions.ActOnMainProgram(
+    getCurScope(), ProgramLoc,
+    ProgramName ? ProgramName : PP.getIdentifierInfo("<main-program>"),
+    ProgramName ? ProgramNameLoc : ProgramLoc);
+
+  // When bodies are skipped, keep the tokens of the body, including any
+  // internal subprograms after CONTAINS, to parse it on demand.
+  LateParsedTemplatedSubprogram *LateBody = 0;
+  if (SkipSubprogramBodies && Res && Actions.canSkipSubprogramBody(Res)) {
+    LateBody = new LateParsedTemplatedSubprogram(Res, /*IsFortranBody=*/true);
+    if (!tryLexMainProgramBodyForLateParsing(LateBody->Toks)) {
+      delete LateBody;
+      LateBody = 0;
+    }
+  }
 
-  // Break out of the ParsingDeclSpec context, too.  This const_cast is
-  // safe because we're always the sole owner.
-  D.getMutableDeclSpec().abort();
+  StmtResult SubPgmBody;
+  if (LateBody) {
+    SubprogramDecl *SubPgmD = cast<SubprogramDecl>(Res);
+    LateParsedTemplateMap[SubPgmD] = LateBody;
+    SkippedFortranBodies.push_back(SubPgmD);
+    Actions.MarkAsLateParsedTemplate(SubPgmD);
+    Actions.SetLateTemplateParser(LateTemplateParserCallback, this);
+  } else {
+    Actions.ActOnStartOfSubprogramDef(getCurScope(), Res);
 
-  PrettyDeclStackTraceEntry CrashInfo(Actions, Res, ProgramLoc,
-                                      "parsing program body");
+    PrettyDeclStackTraceEntry CrashInfo(Actions, Res, ProgramLoc,
+                                        "parsing program body");
 
-  StmtResult SubPgmBody(ParseBlock());
+    SubPgmBody = ParseBlock();
 
-  // If the function body could not be parsed, make a bogus compoundstmt.
-  if (SubPgmBody.isInvalid()) {
-    Sema::CompoundScopeRAII CompoundScope(Actions);
-    SubPgmBody = Actions.ActOnBlock(ProgramLoc, ProgramLoc,
-                                           MultiStmtArg(), false);
+    // If the function body could not be parsed, make a bogus compoundstmt.
+    if (SubPgmBody.isInvalid()) {
+      Sema::CompoundScopeRAII CompoundScope(Actions);
+      SubPgmBody = Actions.ActOnBlock(ProgramLoc, ProgramLoc,
+                                             MultiStmtArg(), false);
+    }
   }
 
-  SourceLocation EndLoc = Tok.getLocation();
-
   if (Tok.is(tok::kw_end)) {
     ConsumeToken();
     if (Tok.isInLine(tok::kw_program))
@@ -797,10 +786,119 @@ Parser::ParseMainProgram() {
 
   BodyScope.Exit();
 
+  if (LateBody)
+    return Actions.ConvertDeclToDeclGroup(Res);
+
   Decl *TheDecl = Actions.ActOnFinishSubprogramBody(Res, SubPgmBody.take());
   return Actions.ConvertDeclToDeclGroup(TheDecl);
 }
 
+/// \brief Returns true if the current token starts the end-program-stmt of
+/// the main program being parsed.
+///
+/// The end statements of internal subprograms name their SUBROUTINE or
+/// FUNCTION keyword, so a bare END ends the main program.
+bool Parser::isEndOfMainProgram() {
+  if (Tok.is(tok::eof) || Tok.is(tok::kw_endprogram))
+    return true;
+  if (Tok.isNot(tok::kw_end) || !Tok.isAtStartOfNonContinuationLine())
+    return false;
+
+  const Token &Next = NextToken();
+  return Next.is(tok::eof) || Next.isAtStartOfNonContinuationLine() ||
+         Next.is(tok::semi) || Next.isInLine(tok::kw_program);
+}
+
+/// \brief Consumes the tokens of the main program body, up to but not
+/// including its end-program-stmt, and stores them in \p Toks followed by
+/// the first token of the end-program-stmt.
+///
+/// \returns false if the code-completion point was reached, which is left
+/// as the current token.
+bool Parser::ConsumeAndStoreMainProgramBody(CachedTokens &Toks) {
+  while (!isEndOfMainProgram()) {
+    if (Tok.is(tok::code_completion))
+      return false;
+    Toks.push_back(Tok);
+    ConsumeAnyToken();
+  }
+  Toks.push_back(Tok);
+  return true;
+}
+
+/// \brief Skips the body of the main program being parsed, storing its
+/// tokens in \p Toks to parse it on demand.
+///
+/// \returns false, having consumed nothing, if the body has to be parsed now
+/// because it contains the code-completion point.
+bool Parser::tryLexMainProgramBodyForLateParsing(CachedTokens &Toks) {
+  if (!PP.isCodeCompletionEnabled())
+    return ConsumeAndStoreMainProgramBody(Toks);
+
+  TentativeParsingAction PA(*this);
+  if (ConsumeAndStoreMainProgramBody(Toks)) {
+    PA.Commit();
+    return true;
+  }
+
+  PA.Revert();
+  Toks.clear();
+  return false;
+}
+
+/// \brief Parses the skipped body of a program unit, when something asks for
+/// it.
+void Parser::ParseLateFortranBody(LateParsedTemplatedSubprogram &LPT) {
+  SubprogramDecl *FD = cast<SubprogramDecl>(LPT.D);
+  assert(!LPT.Toks.empty() && "Empty body!");
+
+  // The cached tokens end with the first token of the end statement.  Append
+  // the current token after them so that it doesn't get lost.
+  SourceLocation EndLoc = LPT.Toks.back().getLocation();
+  LPT.Toks.push_back(Tok);
+  PP.EnterTokenStream(LPT.Toks.data(), LPT.Toks.size(), true, false);
+
+  // Consume the previously pushed token.
+  ConsumeAnyToken();
+
+  Sema::ContextRAII SavedContext(Actions, Actions.getContainingDC(FD));
+  ParseScope BodyScope(this, Scope::SubPgmScope|Scope::DeclScope);
+  Actions.ActOnStartOfSubprogramDef(getCurScope(), FD);
+
+  PrettyDeclStackTraceEntry CrashInfo(Actions, FD, FD->getLocation(),
+                                      "parsing program body");
+
+  StmtResult SubPgmBody(ParseBlock());
+  if (SubPgmBody.isInvalid()) {
+    Sema::CompoundScopeRAII CompoundScope(Actions);
+    SubPgmBody = Actions.ActOnBlock(FD->getLocation(), FD->getLocation(),
+                                    MultiStmtArg(), false);
+  }
+
+  // Drop whatever the body left unparsed, up to the end statement.
+  while (Tok.getLocation() != EndLoc)
+    ConsumeAnyToken();
+
+  BodyScope.Exit();
+  Actions.ActOnFinishSubprogramBody(FD, SubPgmBody.take());
+  Actions.MarkAsLateParsedTemplate(FD, false);
+
+  // Consume the first token of the end statement, returning to the token
+  // that was current before.
+  ConsumeAnyToken();
+}
+
+/// \brief Parses the skipped bodies that nothing has asked for yet, and hands
+/// every skipped program unit to the consumer again now that it is complete.
+void Parser::ParseSkippedFortranBodies() {
+  for (unsigned I = 0, N = SkippedFortranBodies.size(); I != N; ++I) {
+    SubprogramDecl *FD = SkippedFortranBodies[I];
+    Actions.ParseLateParsedSubprogramBody(FD);
+    Actions.getASTConsumer().HandleTopLevelDecl(DeclGroupRef(FD));
+  }
+  SkippedFortranBodies.clear();
+}
+
 /*
  * R204 specification-part
  *    is [ use-stmt ] ... 
@@ -823,10 +921,26 @@ Parser::ParseSpecificationPart() {
   return DeclGroupPtrTy();
 }
 
+/* R1109-F08 use-stmt
+ *   is  USE [ [ , module-nature ] :: ] module-name [ , rename-list ]
+ *   or  USE [ [ , module-nature ] :: ] module-name ,
+ *          ONLY : [ only-list ]
+ * R1110-F08 module-nature
+ *   is  INTRINSIC
+ *   or  NON_INTRINSIC
+ * R1111-F08 rename
+ *   is  local-name => use-name
+ *   or  OPERATOR (local-defined-operator) =>
+ *          OPERATOR (use-defined-operator)
+ * R1112-F08 only
+ *   is  generic-spec
+ *   or  only-use-name
+ *   or  rename
+ */
 Parser::DeclGroupPtrTy
 Parser::ParseUseStmt() {
   assert(Tok.is(tok::kw_use) && "Not 'use' token");
-  ConsumeToken();
+  SourceLocation UseLoc = ConsumeToken();
 
   if (Tok.is(tok::code_completion)) {
     Actions.CodeCompleteUsingDirective(getCurScope());
@@ -834,8 +948,95 @@ Parser::ParseUseStmt() {
     return DeclGroupPtrTy();
   }
 
-  // Actions.ConvertDeclToDeclGroup(SingleDecl);
-  return DeclGroupPtrTy();
+  bool IsIntrinsic = false;
+  if (Tok.isInLine(tok::comma)) {
+    ConsumeToken();
+    if (Tok.isInLine(tok::kw_intrinsic))
+      IsIntrinsic = true;
+    else if (!Tok.isInLine(tok::kw_non_intrinsic)) {
+      Diag(Tok, diag::err_expected_module_nature);
+      SkipToNextLine();
+      return DeclGroupPtrTy();
+    }
+    ConsumeToken();
+    if (!Tok.isInLine(tok::coloncolon)) {
+      Diag(Tok, diag::err_expected_coloncolon);
+      SkipToNextLine();
+      return DeclGroupPtrTy();
+    }
+  }
+  if (Tok.isInLine(tok::coloncolon))
+    ConsumeToken();
+
+  if (!Tok.isInLine(tok::identifier)) {
+    Diag(Tok, diag::err_expected_ident);
+    SkipToNextLine();
+    return DeclGroupPtrTy();
+  }
+  IdentifierInfo *ModuleName = Tok.getIdentifierInfo();
+  SourceLocation ModuleNameLoc = ConsumeToken();
+
+  bool HasOnly = false;
+  SmallVector<Sema::FortranUseItem, 8> Items;
+  if (Tok.isInLine(tok::comma)) {
+    ConsumeToken();
+    if (Tok.isInLine(tok::kw_only) && NextToken().isInLine(tok::colon)) {
+      HasOnly = true;
+      ConsumeToken();
+      ConsumeToken();
+    }
+
+    // An ONLY list may be empty, a rename list may not.
+    while (!HasOnly || (!Tok.isAtStartOfNonContinuationLine() &&
+                        Tok.isNot(tok::semi) && Tok.isNot(tok::eof))) {
+      if (Tok.isInLine(tok::kw_operator) || Tok.isInLine(tok::kw_assignment)) {
+        Diag(Tok, diag::err_use_generic_spec_unsupported);
+        SkipToNextLine();
+        return DeclGroupPtrTy();
+      }
+      if (!Tok.isInLine(tok::identifier)) {
+        Diag(Tok, diag::err_expected_ident);
+        SkipToNextLine();
+        return DeclGroupPtrTy();
+      }
+
+      Sema::FortranUseItem Item;
+      Item.LocalName = Item.UseName = Tok.getIdentifierInfo();
+      Item.LocalNameLoc = Item.UseNameLoc = ConsumeToken();
+      if (Tok.isInLine(tok::equalgreater)) {
+        ConsumeToken();
+        if (!Tok.isInLine(tok::identifier)) {
+          Diag(Tok, diag::err_expected_ident);
+          SkipToNextLine();
+          return DeclGroupPtrTy();
+        }
+        Item.UseName = Tok.getIdentifierInfo();
+        Item.UseNameLoc = ConsumeToken();
+      } else if (!HasOnly) {
+        Diag(Tok, diag::err_expected_equal_greater);
+        SkipToNextLine();
+        return DeclGroupPtrTy();
+      }
+      Items.push_back(Item);
+
+      if (!Tok.isInLine(tok::comma))
+        break;
+      ConsumeToken();
+    }
+  }
+
+  if (!Tok.isAtStartOfNonContinuationLine() && Tok.isNot(tok::eof)) {
+    if (Tok.is(tok::semi))
+      ConsumeToken();
+    else {
+      ExpectAndConsume(tok::semi, diag::err_expected_semi_after, "use statement");
+      SkipToNextLine();
+    }
+  }
+
+  return Actions.ActOnFortranUseStmt(getCurScope(), UseLoc, ModuleName,
+                                     ModuleNameLoc, IsIntrinsic, HasOnly,
+                                     Items);
 }
 
 Parser::DeclGroupPtrTy
@@ -849,18 +1050,268 @@ Parser::ParseSubprogram() {
 }
 
 Parser::DeclGroupPtrTy
-Parser::ParseSubmodule() {
+Parser::ParseBlockData() {
   return DeclGroupPtrTy();
 }
 
+/* R1104-F08 module
+ *   is  module-stmt
+ *          [ specification-part ]
+ *          [ module-subprogram-part ]
+ *          end-module-stmt
+ */
 Parser::DeclGroupPtrTy
-Parser::ParseBlockData() {
-  return DeclGroupPtrTy();
+Parser::ParseModule() {
+  assert(Tok.is(tok::kw_module) && "Not 'module' token");
+
+  /* R1105-F08 module-stmt
+   *   is  MODULE module-name
+   */
+  SourceLocation ModuleLoc = ConsumeToken();
+  if (!Tok.isInLine(tok::identifier)) {
+    Diag(Tok, diag::err_expected_ident);
+    SkipToEndModule();
+    SkipToNextLine();
+    return DeclGroupPtrTy();
+  }
+  IdentifierInfo *ModuleName = Tok.getIdentifierInfo();
+  SourceLocation ModuleNameLoc = ConsumeToken();
+
+  // Enter a scope for the module's specification part.
+  ParseScope ModuleScope(this, Scope::DeclScope);
+
+  Decl *ModuleDecl = Actions.ActOnStartOfFortranModule(getCurScope(),
+                                                       ModuleLoc, ModuleName,
+                                                       ModuleNameLoc);
+
+  PrettyDeclStackTraceEntry CrashInfo(Actions, ModuleDecl, ModuleLoc,
+                                      "parsing module");
+
+  ParseModuleBody(ModuleName, /*IsSubmodule=*/false);
+
+  // Finish the module before consuming its end-module-stmt: when the module
+  // ends the file, the preprocessor reaches the end of the main file as the
+  // statement is consumed, and its callbacks expect the module to be
+  // complete by then.
+  ModuleScope.Exit();
+  Decl *TheDecl = Actions.ActOnFinishFortranModule(ModuleDecl,
+                                                   Tok.getLocation());
+
+  /* R1106-F08 end-module-stmt
+   *   is  END [ MODULE [ module-name ] ]
+   */
+  ParseEndModuleStmt(ModuleName, /*IsSubmodule=*/false);
+  return Actions.ConvertDeclToDeclGroup(TheDecl);
 }
 
+/* R1116-F08 submodule
+ *   is  submodule-stmt
+ *          [ specification-part ]
+ *          [ module-subprogram-part ]
+ *          end-submodule-stmt
+ */
 Parser::DeclGroupPtrTy
-Parser::ParseModule() {
-  return DeclGroupPtrTy();
+Parser::ParseSubmodule() {
+  assert(Tok.is(tok::kw_submodule) && "Not 'submodule' token");
+
+  /* R1117-F08 submodule-stmt
+   *   is  SUBMODULE ( parent-identifier ) submodule-name
+   * R1118-F08 parent-identifier
+   *   is  ancestor-module-name [ : parent-submodule-name ]
+   */
+  SourceLocation SubmoduleLoc = ConsumeToken();
+  IdentifierInfo *AncestorName = 0, *ParentName = 0, *Name = 0;
+  SourceLocation AncestorLoc, ParentLoc, NameLoc;
+  if (!Tok.isInLine(tok::l_paren))
+    Diag(Tok, diag::err_expected_lparen_after) << "submodule";
+  else {
+    ConsumeParen();
+    if (!Tok.isInLine(tok::identifier))
+      Diag(Tok, diag::err_expected_ident);
+    else {
+      AncestorName = Tok.getIdentifierInfo();
+      AncestorLoc = ConsumeToken();
+      if (Tok.isInLine(tok::colon)) {
+        ConsumeToken();
+        if (Tok.isInLine(tok::identifier)) {
+          ParentName = Tok.getIdentifierInfo();
+          ParentLoc = ConsumeToken();
+        } else {
+          Diag(Tok, diag::err_expected_ident);
+          AncestorName = 0;
+        }
+      }
+
+      if (AncestorName && !Tok.isInLine(tok::r_paren)) {
+        Diag(Tok, diag::err_expected_rparen);
+        AncestorName = 0;
+      } else if (AncestorName) {
+        ConsumeParen();
+        if (!Tok.isInLine(tok::identifier))
+          Diag(Tok, diag::err_expected_ident);
+        else {
+          Name = Tok.getIdentifierInfo();
+          NameLoc = ConsumeToken();
+        }
+      }
+    }
+  }
+  if (!Name) {
+    SkipToEndModule();
+    SkipToNextLine();
+    return DeclGroupPtrTy();
+  }
+
+  // Enter a scope for the submodule's specification part.
+  ParseScope SubmoduleScope(this, Scope::DeclScope);
+
+  Decl *SubmoduleDecl
+    = Actions.ActOnStartOfFortranSubmodule(getCurScope(), SubmoduleLoc,
+                                           AncestorName, AncestorLoc,
+                                           ParentName, ParentLoc, Name,
+                                           NameLoc);
+
+  PrettyDeclStackTraceEntry CrashInfo(Actions, SubmoduleDecl, SubmoduleLoc,
+                                      "parsing submodule");
+
+  ParseModuleBody(Name, /*IsSubmodule=*/true);
+
+  SubmoduleScope.Exit();
+  Decl *TheDecl = Actions.ActOnFinishFortranSubmodule(SubmoduleDecl,
+                                                      Tok.getLocation());
+
+  /* R1119-F08 end-submodule-stmt
+   *   is  END [ SUBMODULE [ submodule-name ] ]
+   */
+  ParseEndModuleStmt(Name, /*IsSubmodule=*/true);
+  return Actions.ConvertDeclToDeclGroup(TheDecl);
+}
+
+/// \brief Parse the specification part and module-subprogram-part of a
+/// module or submodule, up to its end statement.
+void Parser::ParseModuleBody(IdentifierInfo *Name, bool IsSubmodule) {
+  StmtVector Stmts;
+  while (Tok.isNot(tok::eof) && Tok.isNot(tok::kw_end) &&
+         Tok.isNot(tok::kw_endmodule) && Tok.isNot(tok::kw_endsubmodule) &&
+         Tok.isNot(tok::kw_contains)) {
+    switch (Tok.getKind()) {
+    case tok::kw_use:
+      ParseUseStmt();
+      continue;
+    case tok::kw_implicit:
+      ParseImplicit();
+      continue;
+    case tok::kw_public:
+    case tok::kw_private:
+      ParseAccessStmt();
+      continue;
+    case tok::semi:
+      ConsumeToken();
+      continue;
+    default:
+      break;
+    }
+
+    if (!isDeclarationConstruct()) {
+      Diag(Tok, diag::err_executable_stmt_in_module) << IsSubmodule;
+      SkipToNextLine();
+      continue;
+    }
+
+    SourceLocation DeclEnd;
+    ParseDeclarationConstruct(Stmts, Declarator::FileContext, DeclEnd);
+  }
+
+  /* R1107-F08 module-subprogram-part
+   *   is  contains-stmt
+   *          [ module-subprogram ] ...
+   */
+  if (Tok.is(tok::kw_contains)) {
+    // FIXME: Parse module subprograms, and the separate module procedures
+    // of submodules, once subroutines and functions are parsed at all.
+    Diag(Tok, diag::warn_module_subprograms_unsupported)
+      << Name->getName() << IsSubmodule;
+    SkipToEndModule();
+  }
+}
+
+/// \brief Parse the end-module-stmt or end-submodule-stmt of the module or
+/// submodule \p Name.
+void Parser::ParseEndModuleStmt(IdentifierInfo *Name, bool IsSubmodule) {
+  tok::TokenKind Kind = IsSubmodule ? tok::kw_submodule : tok::kw_module;
+  tok::TokenKind EndKind = IsSubmodule ? tok::kw_endsubmodule
+                                       : tok::kw_endmodule;
+  if (Tok.is(tok::kw_end)) {
+    ConsumeToken();
+    if (Tok.isInLine(Kind))
+      ConsumeToken();
+  } else if (Tok.is(EndKind)) {
+    ConsumeToken();
+  } else {
+    Diag(Tok, diag::err_expected_end_module) << IsSubmodule;
+    SkipToNextLine();
+  }
+
+  if (Tok.isInLine(tok::identifier)) {
+    if (Tok.getIdentifierInfo() != Name) {
+      Diag(ConsumeToken(), diag::warn_end_module_name_mismatch)
+           << Name->getName() << IsSubmodule;
+    } else ConsumeToken();
+  }
+}
+
+/// \brief Skip to the end statement of the module or submodule being parsed,
+/// without consuming it.
+void Parser::SkipToEndModule() {
+  while (Tok.isNot(tok::eof) && Tok.isNot(tok::kw_endmodule) &&
+         Tok.isNot(tok::kw_endsubmodule) &&
+         !(Tok.is(tok::kw_end) && Tok.isAtStartOfNonContinuationLine() &&
+           (NextToken().isInLine(tok::kw_module) ||
+            NextToken().isInLine(tok::kw_submodule))))
+    ConsumeAnyToken();
+}
+
+/* R524-F08 access-stmt
+ *   is  access-spec [ [ :: ] access-id-list ]
+ * R525-F08 access-id
+ *   is  use-name
+ *   or  generic-spec
+ */
+void Parser::ParseAccessStmt() {
+  assert((Tok.is(tok::kw_public) || Tok.is(tok::kw_private)) &&
+         "Not an access-spec");
+  bool IsPrivate = Tok.is(tok::kw_private);
+  SourceLocation AccessLoc = ConsumeToken();
+
+  if (Tok.isInLine(tok::coloncolon))
+    ConsumeToken();
+
+  SmallVector<IdentifierLocPair, 8> Names;
+  while (!Tok.isAtStartOfNonContinuationLine() && Tok.isNot(tok::semi) &&
+         Tok.isNot(tok::eof)) {
+    if (!Tok.is(tok::identifier)) {
+      Diag(Tok, diag::err_expected_ident);
+      SkipToNextLine();
+      return;
+    }
+    Names.push_back(IdentifierLocPair(Tok.getIdentifierInfo(),
+                                      Tok.getLocation()));
+    ConsumeToken();
+
+    if (!Tok.isInLine(tok::comma))
+      break;
+    ConsumeToken();
+  }
+
+  if (Tok.is(tok::semi))
+    ConsumeToken();
+  else if (!Tok.isAtStartOfNonContinuationLine() && Tok.isNot(tok::eof)) {
+    ExpectAndConsume(tok::semi, diag::err_expected_semi_after,
+                     IsPrivate ? "private statement" : "public statement");
+    SkipToNextLine();
+  }
+
+  Actions.ActOnFortranAccessStmt(getCurScope(), AccessLoc, IsPrivate, Names);
 }
 
 Parser::DeclGroupPtrTy
@@ -868,11 +1319,141 @@ Parser::ParseImportStmt() {
   return DeclGroupPtrTy();
 }
 
+/* R560-F08 implicit-stmt
+ *   is  IMPLICIT implicit-spec-list
+ *   or  IMPLICIT NONE
+ * R561-F08 implicit-spec
+ *   is  declaration-type-spec ( letter-spec-list )
+ */
 Parser::DeclGroupPtrTy
 Parser::ParseImplicit() {
+  assert(Tok.is(tok::kw_implicit) && "Not 'implicit' token");
+  SourceLocation ImplicitLoc = ConsumeToken();
+
+  if (Tok.isInLine(tok::kw_none)) {
+    ConsumeToken();
+    Actions.ActOnFortranImplicitNone(getCurScope(), ImplicitLoc);
+  } else {
+    while (true) {
+      if (Tok.isAtStartOfNonContinuationLine()) {
+        Diag(Tok, diag::err_expected_implicit_type);
+        return DeclGroupPtrTy();
+      }
+
+      // The parenthesis after the type keyword is the letter-spec list
+      // unless another parenthesized list follows it.
+      SaveAndRestore<bool> LetterSpecList(ParenIsImplicitLetterSpecList,
+                                          isImplicitLetterSpecListNext());
+
+      ParsingDeclSpec DS(*this);
+      SmallVector<DeclaratorChunk, 4> DeclaratorChunks;
+      ParseDeclarationTypeSpec(DS, DeclaratorChunks);
+      if (DS.getTypeSpecType() == DeclSpec::TST_unspecified) {
+        Diag(Tok, diag::err_expected_implicit_type);
+        SkipToNextLine();
+        return DeclGroupPtrTy();
+      }
+
+      SmallVector<Sema::FortranLetterSpec, 4> Letters;
+      if (!ParseImplicitLetterSpecList(Letters)) {
+        SkipToNextLine();
+        return DeclGroupPtrTy();
+      }
+
+      Declarator D(DS, Declarator::TypeNameContext);
+      for (unsigned I = 0, N = DeclaratorChunks.size(); I != N; ++I)
+        D.AddInnermostTypeInfo(DeclaratorChunks[I]);
+      TypeResult Ty = Actions.ActOnTypeName(getCurScope(), D);
+      if (!Ty.isInvalid())
+        Actions.ActOnFortranImplicitSpec(getCurScope(), ImplicitLoc, Ty.get(),
+                                         Letters);
+
+      if (!Tok.isInLine(tok::comma))
+        break;
+      ConsumeToken();
+    }
+  }
+
+  if (Tok.is(tok::semi))
+    ConsumeToken();
+  else if (!Tok.isAtStartOfNonContinuationLine() && Tok.isNot(tok::eof)) {
+    ExpectAndConsume(tok::semi, diag::err_expected_semi_after,
+                     "implicit statement");
+    SkipToNextLine();
+  }
   return DeclGroupPtrTy();
 }
 
+/// \brief Returns true if the parenthesized list after the type keyword at
+/// the current token is the letter-spec list of an implicit-spec, rather
+/// than a kind or char selector that the letter-spec list follows.
+bool Parser::isImplicitLetterSpecListNext() {
+  unsigned N = 1;
+  if (Tok.is(tok::kw_double) && (NextToken().isInLine(tok::kw_precision) ||
+                                 NextToken().isInLine(tok::kw_complex)))
+    N = 2;
+
+  Token Next = GetLookAheadToken(N);
+  if (!Next.isInLine(tok::l_paren))
+    return false;
+
+  // Find the matching parenthesis.
+  for (unsigned Depth = 0;; Next = GetLookAheadToken(++N)) {
+    if (Next.is(tok::eof) || Next.isAtStartOfNonContinuationLine())
+      return false;
+    if (Next.is(tok::l_paren))
+      ++Depth;
+    else if (Next.is(tok::r_paren) && --Depth == 0)
+      break;
+  }
+  return !GetLookAheadToken(N + 1).isInLine(tok::l_paren);
+}
+
+/* R562-F08 letter-spec
+ *   is  letter [ - letter ]
+ */
+bool Parser::ParseImplicitLetterSpecList(
+    SmallVectorImpl<Sema::FortranLetterSpec> &Letters) {
+  if (!Tok.isInLine(tok::l_paren)) {
+    Diag(Tok, diag::err_expected_lparen_after) << "implicit type";
+    return false;
+  }
+  ConsumeParen();
+
+  while (true) {
+    Sema::FortranLetterSpec Spec;
+    Spec.Loc = Tok.getLocation();
+    for (unsigned I = 0; I != 2; ++I) {
+      StringRef Name = Tok.isInLine(tok::identifier)
+                         ? Tok.getIdentifierInfo()->getName() : StringRef();
+      if (Name.size() != 1 || ImplicitTypeTable::getLetterIndex(Name[0]) < 0) {
+        Diag(Tok, diag::err_expected_implicit_letter);
+        return false;
+      }
+      ConsumeToken();
+      Spec.Last = Name[0];
+      if (I == 0) {
+        Spec.First = Name[0];
+        if (!Tok.isInLine(tok::minus))
+          break;
+        ConsumeToken();
+      }
+    }
+    Letters.push_back(Spec);
+
+    if (!Tok.isInLine(tok::comma))
+      break;
+    ConsumeToken();
+  }
+
+  if (!Tok.isInLine(tok::r_paren)) {
+    Diag(Tok, diag::err_expected_rparen);
+    return false;
+  }
+  ConsumeParen();
+  return true;
+}
+
 /// ParseExternalDeclaration:
 ///
 ///       external-declaration: [C99 6.9], declaration: [C++ dcl.dcl]
@@ -268,3 +268,11 @@ void MultiplexExternalSemaSource::ReadPendingInstantiations(
   for(size_t i = 0; i < Sources.size(); ++i)
     Sources[i]->ReadPendingInstantiations(Pending);
 }
+
+bool MultiplexExternalSemaSource::getFortranModuleInterfaceHash(
+                                 StringRef Name, uint64_t &InterfaceHash) const {
+  for(size_t i = 0; i < Sources.size(); ++i)
+    if (Sources[i]->getFortranModuleInterfaceHash(Name, InterfaceHash))
+      return true;
+  return false;
+}
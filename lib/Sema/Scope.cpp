@@ -36,12 +36,14 @@ void Scope::Init(Scope *parent, unsigned flags) {
     SubPgmParent       = parent->SubPgmParent;
     BlockParent    = parent->BlockParent;
     TemplateParamParent = parent->TemplateParamParent;
+    ImplicitTypes = parent->ImplicitTypes;
   } else {
     Depth = 0;
     PrototypeDepth = 0;
     PrototypeIndex = 0;
     SubPgmParent = BlockParent = 0;
     TemplateParamParent = 0;
+    ImplicitTypes = 0;
   }
 
   // If this scope is a function or contains breaks/continues, remember it.
@@ -56,6 +58,7 @@ void Scope::Init(Scope *parent, unsigned flags) {
 
   DeclsInScope.clear();
   UsingDirectives.clear();
+  UseAssociatedDecls.clear();
   Entity = 0;
   ErrorTrap.reset();
 }
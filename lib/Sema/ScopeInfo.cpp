@@ -29,6 +29,7 @@ void SubprogramScopeInfo::Clear() {
 
   SwitchStack.clear();
   Returns.clear();
+  ImplicitlyTypedVars.clear();
   ErrorTrap.reset();
   PossiblyUnreachableDiags.clear();
   WeakObjectUses.clear();
@@ -25,6 +25,7 @@
 #include "lfort/AST/StmtObjC.h"
 #include "lfort/Analysis/Analyses/FormatString.h"
 #include "lfort/Basic/ConvertUTF.h"
+#include "lfort/Basic/FortranIntrinsics.h"
 #include "lfort/Basic/TargetBuiltins.h"
 #include "lfort/Basic/TargetInfo.h"
 #include "lfort/Lex/Preprocessor.h"
@@ -35,7 +36,10 @@
 #include "llvm/ADT/BitVector.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/Support/raw_ostream.h"
+#include <algorithm>
+#include <cstring>
 #include <limits>
 using namespace lfort;
 using namespace sema;
@@ -300,6 +304,297 @@ Sema::CheckBuiltinSubprogramCall(unsigned BuiltinID, CallExpr *TheCall) {
   return TheCallResult;
 }
 
+/// \brief Determine whether two scalar types have the same Fortran type and
+/// kind; the lengths of character types may differ.
+static bool isSameFortranTypeAndKind(ASTContext &Ctx, QualType A, QualType B) {
+  if (Ctx.isFortranCharacterType(A) && Ctx.isFortranCharacterType(B)) {
+    A = Ctx.getAsArrayType(A)->getElementType();
+    B = Ctx.getAsArrayType(B)->getElementType();
+  }
+  return Ctx.hasSameUnqualifiedType(A, B);
+}
+
+/// \brief The argument type codes of FortranIntrinsics.td that name a set of
+/// types, in the order of the err_fortran_intrinsic_arg_type diagnostic.
+static const char FortranIntrinsicTypeCodes[] = "ircfxnls";
+
+/// \brief Determine whether the scalar type \p T is accepted by the argument
+/// type code \p Code of an intrinsic.
+static bool matchesFortranIntrinsicArgType(ASTContext &Ctx, char Code,
+                                           QualType T) {
+  bool IsCharacter = Ctx.isFortranCharacterType(T);
+  bool IsInteger = !IsCharacter && T->isIntegerType() && !T->isBooleanType();
+  bool IsReal = T->isRealFloatingType();
+  bool IsComplex = T->isAnyComplexType();
+
+  switch (Code) {
+  case 'i': return IsInteger;
+  case 'r': return IsReal;
+  case 'c': return IsComplex;
+  case 'f': return IsReal || IsComplex;
+  case 'x': return IsInteger || IsReal;
+  case 'n': return IsInteger || IsReal || IsComplex;
+  case 'l': return T->isBooleanType();
+  case 's': return IsCharacter;
+  default:  return true;
+  }
+}
+
+/// \brief Return the type with the same type category as the scalar type
+/// \p T whose kind type parameter is \p Kind.
+///
+/// As for type declarations, a kind is the size of the type in bytes.  If
+/// no type of the category has that kind, returns a null type and fills in
+/// the name of the category and the list of allowed kinds.
+static QualType getFortranTypeOfKind(ASTContext &Ctx, QualType T,
+                                     uint64_t Kind, const char *&TypeName,
+                                     std::string &AllowedKinds) {
+  const ArrayType *StringTy = 0;
+  const ComplexType *CT = 0;
+  SmallVector<QualType, 5> Candidates;
+  if (Ctx.isFortranCharacterType(T)) {
+    StringTy = Ctx.getAsArrayType(T);
+    TypeName = "character";
+    Candidates.push_back(Ctx.CharTy);
+    Candidates.push_back(Ctx.WCharTy);
+  } else if (T->isBooleanType()) {
+    TypeName = "logical";
+    Candidates.push_back(Ctx.BoolTy);
+  } else if (T->isRealFloatingType() ||
+             (CT = T->getAs<ComplexType>())) {
+    TypeName = CT ? "complex" : "real";
+    Candidates.push_back(Ctx.FloatTy);
+    Candidates.push_back(Ctx.DoubleTy);
+    Candidates.push_back(Ctx.LongDoubleTy);
+  } else {
+    TypeName = "integer";
+    Candidates.push_back(Ctx.CharTy);
+    Candidates.push_back(Ctx.ShortTy);
+    Candidates.push_back(Ctx.IntTy);
+    Candidates.push_back(Ctx.LongTy);
+    Candidates.push_back(Ctx.LongLongTy);
+  }
+
+  SmallVector<uint64_t, 5> Kinds;
+  for (unsigned I = 0, N = Candidates.size(); I != N; ++I) {
+    uint64_t CandidateKind = (Ctx.getTypeSize(Candidates[I]) + 7) / 8;
+    if (CandidateKind != Kind) {
+      if (Kinds.empty() || Kinds.back() != CandidateKind)
+        Kinds.push_back(CandidateKind);
+      continue;
+    }
+
+    QualType Result = Candidates[I];
+    if (CT)
+      return Ctx.getComplexType(Result);
+    if (const ConstantArrayType *CAT =
+          dyn_cast_or_null<ConstantArrayType>(StringTy))
+      return Ctx.getConstantArrayType(Result, CAT->getSize(),
+                                      ArrayType::Normal, 0);
+    if (StringTy)
+      return Ctx.getIncompleteArrayType(Result, ArrayType::Normal, 0);
+    return Result;
+  }
+
+  for (unsigned I = 0, N = Kinds.size(); I != N; ++I) {
+    if (N > 1 && I == N - 1)
+      AllowedKinds += " and ";
+    else if (I > 0)
+      AllowedKinds += ", ";
+    AllowedKinds += llvm::utostr(Kinds[I]);
+  }
+  return QualType();
+}
+
+/// \brief Check a call to a Fortran intrinsic procedure against its entry in
+/// the intrinsic table and compute the type of its result.
+///
+/// Scalar arguments are passed by value, without the default argument
+/// promotions of C.  A reference to an elemental intrinsic with an array
+/// argument has an array result of the same shape.
+ExprResult
+Sema::CheckFortranIntrinsicCall(unsigned IntrinsicID, CallExpr *TheCall) {
+  const intrinsic::Info &Info =
+    intrinsic::getInfo(static_cast<intrinsic::ID>(IntrinsicID));
+  SubprogramDecl *FDecl = TheCall->getDirectCallee();
+  unsigned NumArgs = TheCall->getNumArgs();
+  unsigned NumFormals = Info.getNumArgs();
+
+  if (NumArgs < Info.NumRequired) {
+    Diag(TheCall->getRParenLoc(), diag::err_fortran_intrinsic_arg_count)
+      << 0 << FDecl
+      << (NumFormals == Info.NumRequired && !Info.isVariadic() ? 0 : 1)
+      << unsigned(Info.NumRequired) << NumArgs << TheCall->getSourceRange();
+    return ExprError();
+  }
+  if (NumArgs > NumFormals && !Info.isVariadic()) {
+    SourceRange Excess(TheCall->getArg(NumFormals)->getLocStart(),
+                       TheCall->getArg(NumArgs - 1)->getLocEnd());
+    Diag(Excess.getBegin(), diag::err_fortran_intrinsic_arg_count)
+      << 1 << FDecl << (NumFormals == Info.NumRequired ? 0 : 2)
+      << NumFormals << NumArgs << Excess;
+    return ExprError();
+  }
+
+  SmallVector<StringRef, 6> Keywords;
+  StringRef(Info.Keywords).split(Keywords, ",");
+
+  QualType FirstTy, ShapeTy;
+  Expr *ShapeArg = 0;
+  uint64_t Kind = 0;
+  bool HasKind = false;
+  for (unsigned I = 0; I != NumArgs; ++I) {
+    // Repeated arguments are named like the last one, with their position
+    // as the suffix (a3, a4, ...).
+    std::string Keyword;
+    if (I < NumFormals)
+      Keyword = Keywords[I];
+    else
+      Keyword = Keywords.back().rtrim("0123456789").str() +
+                llvm::utostr(I + 1);
+    char Code = Info.ArgTypes[std::min(I, NumFormals - 1)];
+
+    Expr *Arg = TheCall->getArg(I);
+    if (!Context.getAsArrayType(Arg->getType())) {
+      ExprResult Converted = DefaultLvalueConversion(Arg);
+      if (Converted.isInvalid())
+        return ExprError();
+      Arg = Converted.take();
+      TheCall->setArg(I, Arg);
+    }
+    QualType ArgTy = Arg->getType();
+    QualType ScalarTy = Context.getFortranScalarType(ArgTy);
+    bool IsArray = Context.isFortranArrayType(ArgTy);
+    if (I == 0)
+      FirstTy = ScalarTy;
+
+    if (Code == 'k') {
+      llvm::APSInt Value;
+      if (IsArray || !matchesFortranIntrinsicArgType(Context, 'i', ScalarTy) ||
+          !Arg->isIntegerConstantExpr(Value, Context)) {
+        Diag(Arg->getLocStart(), diag::err_fortran_intrinsic_kind_arg)
+          << Keyword << FDecl << Arg->getSourceRange();
+        return ExprError();
+      }
+      if ((int)I == Info.KindArg) {
+        Kind = Value.getZExtValue();
+        HasKind = true;
+      }
+      continue;
+    }
+
+    if (Code == '=') {
+      if (!isSameFortranTypeAndKind(Context, FirstTy, ScalarTy)) {
+        Diag(Arg->getLocStart(), diag::err_fortran_intrinsic_arg_mismatch)
+          << Keyword << FDecl << Keywords[0] << FirstTy << ScalarTy
+          << Arg->getSourceRange();
+        return ExprError();
+      }
+    } else if (!matchesFortranIntrinsicArgType(Context, Code, ScalarTy)) {
+      Diag(Arg->getLocStart(), diag::err_fortran_intrinsic_arg_type)
+        << Keyword << FDecl
+        << unsigned(strchr(FortranIntrinsicTypeCodes, Code) -
+                    FortranIntrinsicTypeCodes)
+        << ArgTy << Arg->getSourceRange();
+      return ExprError();
+    }
+
+    // The array arguments of an elemental intrinsic must conform.
+    if (Info.Elemental && IsArray) {
+      if (!ShapeArg) {
+        ShapeTy = ArgTy;
+        ShapeArg = Arg;
+      } else if (CheckFortranArrayConformance(Arg->getLocStart(), ShapeArg,
+                                              Arg))
+        return ExprError();
+    }
+  }
+
+  QualType ResultTy;
+  switch (Info.ResultType) {
+  case '=':
+  case 'e':
+    ResultTy = FirstTy;
+    break;
+  case 'p':
+    ResultTy = FirstTy;
+    if (const ComplexType *CT = ResultTy->getAs<ComplexType>())
+      ResultTy = CT->getElementType();
+    break;
+  case 'q':
+    if (const ComplexType *CT = FirstTy->getAs<ComplexType>())
+      ResultTy = CT->getElementType();
+    else if (FirstTy->isRealFloatingType())
+      ResultTy = FirstTy;
+    else
+      ResultTy = Context.FloatTy;
+    break;
+  case 'm':
+    ResultTy = Context.getFortranScalarType(TheCall->getArg(1)->getType());
+    break;
+  case 'i':
+    ResultTy = Context.IntTy;
+    break;
+  case 'r':
+    ResultTy = Context.FloatTy;
+    break;
+  case 'd':
+    ResultTy = Context.DoubleTy;
+    break;
+  case 'c':
+    ResultTy = Context.getComplexType(Context.FloatTy);
+    break;
+  case 'l':
+    ResultTy = Context.BoolTy;
+    break;
+  case 'h':
+    ResultTy = Context.getConstantArrayType(Context.CharTy,
+                 llvm::APInt(Context.getTypeSize(Context.getSizeType()), 1),
+                 ArrayType::Normal, 0);
+    break;
+  case 's':
+    ResultTy = Context.getIncompleteArrayType(Context.CharTy,
+                                              ArrayType::Normal, 0);
+    break;
+  case 'j':
+    ResultTy = Context.getIncompleteArrayType(Context.IntTy,
+                                              ArrayType::Normal, 0);
+    break;
+  case 'a':
+    ResultTy = Context.getIncompleteArrayType(FirstTy, ArrayType::Normal, 0);
+    break;
+  case 'v':
+    ResultTy = Context.VoidTy;
+    break;
+  default:
+    llvm_unreachable("Invalid intrinsic result type!");
+  }
+
+  if (HasKind) {
+    Expr *KindArg = TheCall->getArg(Info.KindArg);
+    const char *TypeName;
+    std::string AllowedKinds;
+    QualType ElementTy = Context.getFortranScalarType(ResultTy);
+    QualType KindTy = getFortranTypeOfKind(Context, ElementTy, Kind, TypeName,
+                                           AllowedKinds);
+    if (KindTy.isNull()) {
+      Diag(KindArg->getLocStart(), diag::err_fortran_intrinsic_kind_value)
+        << unsigned(Kind) << TypeName << AllowedKinds
+        << KindArg->getSourceRange();
+      return ExprError();
+    }
+    ResultTy = ElementTy == ResultTy ? KindTy :
+               Context.getFortranArrayOfShape(ResultTy, KindTy);
+  }
+
+  if (!ShapeTy.isNull() && !ResultTy->isVoidType())
+    ResultTy = Context.getFortranArrayOfShape(ShapeTy, ResultTy);
+
+  TheCall->setType(ResultTy);
+  TheCall->setValueKind(VK_RValue);
+  return Owned(TheCall);
+}
+
 // Get the valid immediate range for the specified NEON type code.
 static unsigned RFT(unsigned t, bool shift = false) {
   NeonTypeFlags Type(t);
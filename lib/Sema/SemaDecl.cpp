@@ -24,6 +24,7 @@
 #include "lfort/AST/EvaluatedExprVisitor.h"
 #include "lfort/AST/ExprCXX.h"
 #include "lfort/AST/StmtCXX.h"
+#include "lfort/Basic/FortranIntrinsics.h"
 #include "lfort/Basic/PartialDiagnostic.h"
 #include "lfort/Basic/SourceManager.h"
 #include "lfort/Basic/TargetInfo.h"
@@ -34,12 +35,14 @@
 #include "lfort/Sema/CXXFieldCollector.h"
 #include "lfort/Sema/DeclSpec.h"
 #include "lfort/Sema/DelayedDiagnostic.h"
+#include "lfort/Sema/ImplicitTypeTable.h"
 #include "lfort/Sema/Initialization.h"
 #include "lfort/Sema/Lookup.h"
 #include "lfort/Sema/ParsedTemplate.h"
 #include "lfort/Sema/Scope.h"
 #include "lfort/Sema/ScopeInfo.h"
 #include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/ADT/Triple.h"
 #include <algorithm>
 #include <cstring>
@@ -1568,6 +1571,37 @@ NamedDecl *Sema::LazilyCreateBuiltin(IdentifierInfo *II, unsigned bid,
   return New;
 }
 
+/// \brief The name of a Fortran intrinsic procedure was referenced without
+/// being declared or made accessible by use association; lazily create a
+/// decl for it at program scope.
+///
+/// The decl has no prototype: the arguments of a call to it are checked and
+/// the type of its result is computed from the generated intrinsic table by
+/// CheckFortranIntrinsicCall.
+NamedDecl *Sema::LazilyCreateFortranIntrinsic(IdentifierInfo *II,
+                                              SourceLocation Loc) {
+  intrinsic::ID IntrinsicID = intrinsic::lookup(II->getName());
+  if (IntrinsicID == intrinsic::NotIntrinsic)
+    return 0;
+
+  const intrinsic::Info &Info = intrinsic::getInfo(IntrinsicID);
+  QualType R = Context.getSubprogramNoProtoType(
+                 Info.isSubroutine() ? Context.VoidTy : Context.IntTy);
+  SubprogramDecl *New = SubprogramDecl::Create(Context,
+                                               Context.getProgramDecl(),
+                                               Loc, Loc, II, R, /*TInfo=*/0,
+                                               SC_Extern, SC_None, false,
+                                               /*hasPrototype=*/false);
+  New->setImplicit();
+  New->addAttr(new (Context) FortranIntrinsicAttr(Loc, Context, IntrinsicID));
+
+  DeclContext *SavedContext = CurContext;
+  CurContext = Context.getProgramDecl();
+  PushOnScopeChains(New, PgmScope);
+  CurContext = SavedContext;
+  return New;
+}
+
 bool Sema::isIncompatibleTypedef(TypeDecl *Old, TypedefNameDecl *New) {
   QualType OldType;
   if (TypedefNameDecl *OldTypedef = dyn_cast<TypedefNameDecl>(Old))
@@ -6134,6 +6168,10 @@ bool Sema::CheckSubprogramDeclaration(Scope *S, SubprogramDecl *NewFD,
   assert(!NewFD->getResultType()->isVariablyModifiedType() 
          && "Variably modified return types are not handled here");
 
+  // Calls resolved to the specifics of this name before it was extended
+  // have to be resolved again.
+  GenericResolutions.noteSpecificDeclared(NewFD->getDeclName());
+
   // Check for a previous declaration of this name.
   if (Previous.empty() && NewFD->isExternC()) {
     // Since we did not find anything by this name and we're declaring
@@ -7836,6 +7874,36 @@ Decl *Sema::ActOnStartOfSubprogramDef(Scope *SubPgmBodyScope, Declarator &D) {
   return ActOnStartOfSubprogramDef(SubPgmBodyScope, DP);
 }
 
+/// \brief Declares a main program, whose definition starts with
+/// ActOnStartOfSubprogramDef.
+///
+/// A main program has no dummy arguments, result or attributes, so unlike
+/// other subprograms it does not need a declarator to describe it.
+Decl *Sema::ActOnMainProgram(Scope *BodyScope, SourceLocation ProgramLoc,
+                             IdentifierInfo *Name, SourceLocation NameLoc) {
+  assert(getCurSubprogramDecl() == 0 && "Subprogram parsing confused");
+  Scope *ParentScope = BodyScope->getParent();
+
+  SubprogramProtoType::ExtProtoInfo EPI;
+  QualType R = Context.getSubprogramType(Context.VoidTy, 0, 0, EPI);
+  DeclarationNameInfo NameInfo(Name, NameLoc);
+  MainProgramDecl *NewPD = MainProgramDecl::Create(
+    Context, CurContext, ProgramLoc, NameInfo, R,
+    Context.getTrivialTypeSourceInfo(R, NameLoc), SC_None, SC_None,
+    false /* isInline */, false /* HasPrototype */);
+  NewPD->setLexicalDeclContext(CurContext);
+
+  LookupResult Previous(*this, NameInfo, LookupOrdinaryName,
+                        ForRedeclaration);
+  LookupName(Previous, ParentScope);
+  bool Redeclaration = CheckSubprogramDeclaration(ParentScope, NewPD,
+                                                  Previous, false);
+  if (!(Redeclaration && NewPD->isInvalidDecl()))
+    PushOnScopeChains(NewPD, ParentScope);
+
+  return NewPD;
+}
+
 static bool ShouldWarnAboutMissingPrototype(const SubprogramDecl *FD, 
                              const SubprogramDecl*& PossibleZeroParamPrototype) {
   // Don't warn about invalid declarations.
@@ -8134,6 +8202,21 @@ Decl *Sema::ActOnFinishSubprogramBody(Decl *dcl, Stmt *Body,
   sema::AnalysisBasedWarnings::Policy *ActivePolicy = 0;
 
   if (FD) {
+    // The implicitly typed variables of a Fortran subprogram are declared at
+    // the start of its body.
+    ArrayRef<VarDecl *> ImplicitVars = getCurSubprogram()->ImplicitlyTypedVars;
+    CompoundStmt *Compound = dyn_cast_or_null<CompoundStmt>(Body);
+    if (Compound && !ImplicitVars.empty()) {
+      SmallVector<Stmt *, 32> Stmts;
+      for (unsigned I = 0, N = ImplicitVars.size(); I != N; ++I) {
+        SourceLocation Loc = ImplicitVars[I]->getLocation();
+        Stmts.push_back(new (Context) DeclStmt(DeclGroupRef(ImplicitVars[I]),
+                                               Loc, Loc));
+      }
+      Stmts.append(Compound->body_begin(), Compound->body_end());
+      Compound->setStmts(Context, Stmts.data(), Stmts.size());
+    }
+
     FD->setBody(Body);
 
     // If the function implicitly returns zero (like 'main') or is naked,
@@ -8364,6 +8447,36 @@ NamedDecl *Sema::ImplicitlyDefineSubprogram(SourceLocation Loc,
   return FD;
 }
 
+/// \brief Declares a variable of the implicit type of \p II in the
+/// subprogram being parsed, for a name that lookup did not find.
+///
+/// \returns the variable, or null if the implicit typing rules in effect
+/// give \p II no type or the name is not used in a subprogram.
+VarDecl *Sema::ImplicitlyDeclareFortranVariable(SourceLocation Loc,
+                                                IdentifierInfo &II,
+                                                Scope *S) {
+  Scope *SubPgmScope = S->getSubPgmParent();
+  if (!SubPgmScope)
+    return 0;
+  SubprogramDecl *Subprogram = dyn_cast_or_null<SubprogramDecl>(
+    static_cast<DeclContext *>(SubPgmScope->getEntity()));
+  if (!Subprogram || Subprogram != getCurSubprogramDecl())
+    return 0;
+
+  QualType T = getFortranImplicitType(S, &II);
+  if (T.isNull())
+    return 0;
+
+  VarDecl *Var = VarDecl::Create(Context, Subprogram, Loc, Loc, &II, T,
+                                 Context.getTrivialTypeSourceInfo(T, Loc),
+                                 SC_None, SC_None);
+  Var->setImplicit();
+  Subprogram->addDecl(Var);
+  PushOnScopeChains(Var, SubPgmScope, /*AddToContext=*/false);
+  getCurSubprogram()->ImplicitlyTypedVars.push_back(Var);
+  return Var;
+}
+
 /// \brief Adds any function attributes that we know a priori based on
 /// the declaration of this function.
 ///
@@ -11153,6 +11266,504 @@ DeclResult Sema::ActOnPCModuleImport(SourceLocation AtLoc,
   return Import;
 }
 
+Decl *Sema::ActOnStartOfFortranModule(Scope *S, SourceLocation ModuleLoc,
+                                      IdentifierInfo *Name,
+                                      SourceLocation NameLoc) {
+  // Module names are global identifiers, so any other program-scope entity
+  // by that name conflicts with the module.
+  bool IsInvalid = false;
+  DeclContext::lookup_result R = Context.getProgramDecl()->lookup(Name);
+  if (!R.empty()) {
+    NamedDecl *PrevDecl = R.front();
+    if (isa<NamespaceDecl>(PrevDecl))
+      Diag(NameLoc, diag::err_redefinition) << Name;
+    else
+      Diag(NameLoc, diag::err_redefinition_different_kind) << Name;
+    Diag(PrevDecl->getLocation(), diag::note_previous_definition);
+    IsInvalid = true;
+  }
+
+  NamespaceDecl *Module = NamespaceDecl::Create(Context, CurContext,
+                                                /*Inline=*/false, ModuleLoc,
+                                                NameLoc, Name, /*PrevDecl=*/0);
+  if (IsInvalid)
+    Module->setInvalidDecl();
+  else
+    FortranModules.push_back(Module);
+
+  CurFortranModuleAccess = FortranModuleAccessInfo();
+  PushOnScopeChains(Module, S->getParent());
+  PushDeclContext(S, Module);
+  return Module;
+}
+
+/// \brief Describe what the programs that use a module see of the entity
+/// \p D, known in the module as \p Name.
+static void describeFortranModuleEntity(const NamedDecl *D,
+                                        DeclarationName Name,
+                                        const PrintingPolicy &Policy,
+                                        raw_ostream &OS) {
+  // An entity the module itself uses is seen under its local name.
+  if (const UsingShadowDecl *Shadow = dyn_cast<UsingShadowDecl>(D)) {
+    describeFortranModuleEntity(Shadow->getTargetDecl(), Name, Policy, OS);
+    return;
+  }
+
+  OS << D->getDeclKindName() << ' ' << Name.getAsString();
+  if (const ValueDecl *VD = dyn_cast<ValueDecl>(D))
+    OS << " : " << VD->getType().getCanonicalType().getAsString(Policy);
+
+  if (const VarDecl *Var = dyn_cast<VarDecl>(D)) {
+    // The value of a named constant can be folded into the using program.
+    if (Var->getType().isConstQualified() && Var->getInit()) {
+      OS << " = ";
+      Var->getInit()->printPretty(OS, 0, Policy);
+    }
+  } else if (const FunctionDecl *FD = dyn_cast<FunctionDecl>(D)) {
+    // Dummy argument names can be used as argument keywords.
+    for (unsigned I = 0, N = FD->getNumParams(); I != N; ++I)
+      OS << ' ' << FD->getParamDecl(I)->getName();
+  } else if (const TypedefNameDecl *TD = dyn_cast<TypedefNameDecl>(D)) {
+    OS << " = "
+       << TD->getUnderlyingType().getCanonicalType().getAsString(Policy);
+  } else if (const RecordDecl *RD = dyn_cast<RecordDecl>(D)) {
+    if (const RecordDecl *Def = RD->getDefinition())
+      for (RecordDecl::field_iterator F = Def->field_begin(),
+                                      FEnd = Def->field_end();
+           F != FEnd; ++F)
+        OS << ' ' << F->getName() << " : "
+           << F->getType().getCanonicalType().getAsString(Policy);
+  }
+}
+
+/// \brief Compute a hash of the public interface of \p Module: the names,
+/// types and constant values of its public entities, and the modules it
+/// re-exports along with their own hashes.  Private entities and procedure
+/// bodies do not contribute, so the hash only changes when the programs that
+/// use the module may need to be recompiled.
+static uint64_t computeFortranModuleInterfaceHash(Sema &S,
+                                                  NamespaceDecl *Module) {
+  PrintingPolicy Policy = S.getPrintingPolicy();
+  SmallVector<std::string, 16> Entities;
+  for (DeclContext::decl_iterator I = Module->decls_begin(),
+                                  E = Module->decls_end(); I != E; ++I) {
+    if (UsingDirectiveDecl *UD = dyn_cast<UsingDirectiveDecl>(*I)) {
+      // A re-exported module's interface is part of this one, so a change
+      // to it must change this hash too.
+      NamespaceDecl *Used = UD->getNominatedNamespace();
+      std::string Description = "use " + Used->getNameAsString();
+      uint64_t UsedHash;
+      llvm::DenseMap<const NamespaceDecl *, uint64_t>::iterator Known
+        = S.FortranModuleInterfaceHashes.find(Used);
+      if (Known != S.FortranModuleInterfaceHashes.end())
+        Description += " " + llvm::utohexstr(Known->second);
+      else if (S.getExternalSource() &&
+               S.getExternalSource()->getFortranModuleInterfaceHash(
+                 Used->getName(), UsedHash))
+        Description += " " + llvm::utohexstr(UsedHash);
+      Entities.push_back(Description);
+      continue;
+    }
+
+    NamedDecl *ND = dyn_cast<NamedDecl>(*I);
+    if (!ND || !ND->getIdentifier() || ND->isPCModulePrivate() ||
+        isa<UsingDecl>(ND))
+      continue;
+
+    std::string Description;
+    llvm::raw_string_ostream OS(Description);
+    describeFortranModuleEntity(ND, ND->getDeclName(), Policy, OS);
+    Entities.push_back(OS.str());
+  }
+
+  // The order of the specification part is not part of the interface.
+  std::sort(Entities.begin(), Entities.end());
+
+  // 64-bit FNV-1a, which gives the same hash on every host and every run.
+  uint64_t Hash = 14695981039346656037ULL;
+  for (unsigned I = 0, N = Entities.size(); I != N; ++I) {
+    const std::string &Entity = Entities[I];
+    for (unsigned C = 0, CEnd = Entity.size() + 1; C != CEnd; ++C) {
+      Hash ^= (unsigned char)Entity.c_str()[C];
+      Hash *= 1099511628211ULL;
+    }
+  }
+  return Hash;
+}
+
+Decl *Sema::ActOnFinishFortranModule(Decl *D, SourceLocation EndLoc) {
+  NamespaceDecl *Module = cast<NamespaceDecl>(D);
+  Module->setRBraceLoc(EndLoc);
+  PopDeclContext();
+
+  // Apply the PUBLIC and PRIVATE statements.  Private entities are written
+  // to the module file as module-private declarations, which the AST reader
+  // keeps hidden from the programs that use the module.
+  const FortranModuleAccessInfo &Access = CurFortranModuleAccess;
+  llvm::DenseMap<IdentifierInfo *, std::pair<bool, SourceLocation> > Named;
+  for (unsigned I = 0, N = Access.Names.size(); I != N; ++I)
+    Named[Access.Names[I].first.first] =
+      std::make_pair(Access.Names[I].second, Access.Names[I].first.second);
+
+  llvm::SmallPtrSet<IdentifierInfo *, 8> Seen;
+  for (DeclContext::decl_iterator I = Module->decls_begin(),
+                                  E = Module->decls_end(); I != E; ++I) {
+    NamedDecl *ND = dyn_cast<NamedDecl>(*I);
+    if (!ND || !ND->getIdentifier())
+      continue;
+
+    bool IsPrivate = Access.DefaultPrivate;
+    llvm::DenseMap<IdentifierInfo *, std::pair<bool, SourceLocation> >
+      ::iterator Pos = Named.find(ND->getIdentifier());
+    if (Pos != Named.end()) {
+      IsPrivate = Pos->second.first;
+      Seen.insert(ND->getIdentifier());
+    }
+    if (IsPrivate)
+      ND->setPCModulePrivate();
+  }
+
+  for (unsigned I = 0, N = Access.Names.size(); I != N; ++I) {
+    IdentifierInfo *Name = Access.Names[I].first.first;
+    if (!Seen.count(Name))
+      Diag(Access.Names[I].first.second,
+           diag::err_fortran_access_stmt_undeclared)
+        << Name << Access.Names[I].second;
+  }
+  CurFortranModuleAccess = FortranModuleAccessInfo();
+
+  if (!Module->isInvalidDecl()) {
+    uint64_t InterfaceHash
+      = computeFortranModuleInterfaceHash(*this, Module);
+    FortranModuleInterfaceHashes[Module] = InterfaceHash;
+    if (PPCallbacks *Callbacks = PP.getPPCallbacks())
+      Callbacks->FortranModuleInterface(Module->getLocation(),
+                                        Module->getName(), /*File=*/0,
+                                        InterfaceHash);
+  }
+
+  return Module;
+}
+
+/// \brief Determine whether the namespace \p ND represents a Fortran
+/// submodule, which is named "ancestor@submodule".
+static bool isFortranSubmodule(const NamespaceDecl *ND) {
+  return ND->getIdentifier() &&
+         ND->getName().find('@') != StringRef::npos;
+}
+
+Decl *Sema::ActOnStartOfFortranSubmodule(Scope *S, SourceLocation SubmoduleLoc,
+                                         IdentifierInfo *AncestorName,
+                                         SourceLocation AncestorLoc,
+                                         IdentifierInfo *ParentName,
+                                         SourceLocation ParentLoc,
+                                         IdentifierInfo *Name,
+                                         SourceLocation NameLoc) {
+  // Find the parent: a module or submodule defined earlier in this program,
+  // or else the one whose submodule file is on the module search path.
+  SmallString<64> ParentFullName(AncestorName->getName());
+  if (ParentName) {
+    ParentFullName += '@';
+    ParentFullName += ParentName->getName();
+  }
+  IdentifierInfo *ParentId = &Context.Idents.get(ParentFullName);
+  SourceLocation ParentIdLoc = ParentName ? ParentLoc : AncestorLoc;
+
+  LookupResult ParentR(*this, ParentId, ParentIdLoc, LookupNamespaceName);
+  LookupQualifiedName(ParentR, Context.getProgramDecl());
+  NamespaceDecl *Parent = ParentR.getAsSingle<NamespaceDecl>();
+  if (!Parent) {
+    if (!PP.getPCModuleLoader().loadFortranSubmoduleFile(ParentIdLoc,
+                                                         ParentFullName)) {
+      Diag(ParentIdLoc, diag::err_fortran_submodule_file_not_found)
+        << (ParentName ? ParentName : AncestorName) << (ParentName != 0);
+    } else {
+      ParentR.clear();
+      LookupQualifiedName(ParentR, Context.getProgramDecl());
+      Parent = ParentR.getAsSingle<NamespaceDecl>();
+      // The loader has already diagnosed a file it could not read.
+      if (!Parent && !Diags.hasErrorOccurred())
+        Diag(ParentIdLoc, diag::err_fortran_module_not_in_file) << ParentId;
+    }
+  }
+
+  SmallString<64> FullName(AncestorName->getName());
+  FullName += '@';
+  FullName += Name->getName();
+  IdentifierInfo *Id = &Context.Idents.get(FullName);
+
+  bool IsInvalid = !Parent;
+  DeclContext::lookup_result R = Context.getProgramDecl()->lookup(Id);
+  if (!R.empty()) {
+    Diag(NameLoc, diag::err_redefinition) << Name;
+    Diag(R.front()->getLocation(), diag::note_previous_definition);
+    IsInvalid = true;
+  }
+
+  NamespaceDecl *Submodule = NamespaceDecl::Create(Context, CurContext,
+                                                   /*Inline=*/false,
+                                                   SubmoduleLoc, NameLoc, Id,
+                                                   /*PrevDecl=*/0);
+  if (IsInvalid)
+    Submodule->setInvalidDecl();
+  else
+    FortranSubmodules.push_back(Submodule);
+
+  PushOnScopeChains(Submodule, S->getParent());
+  PushDeclContext(S, Submodule);
+
+  // Host association: the entities of the parent are visible in the
+  // submodule, unless the submodule declares the same name.
+  if (Parent) {
+    UsingDirectiveDecl *UDir
+      = UsingDirectiveDecl::Create(Context, CurContext, SubmoduleLoc,
+                                   SubmoduleLoc, NestedNameSpecifierLoc(),
+                                   ParentIdLoc, Parent,
+                                   Context.getProgramDecl());
+    UDir->setImplicit();
+    PushUsingDirective(S, UDir);
+  }
+
+  return Submodule;
+}
+
+Decl *Sema::ActOnFinishFortranSubmodule(Decl *D, SourceLocation EndLoc) {
+  NamespaceDecl *Submodule = cast<NamespaceDecl>(D);
+  Submodule->setRBraceLoc(EndLoc);
+  PopDeclContext();
+  return Submodule;
+}
+
+void Sema::ActOnFortranAccessStmt(Scope *S, SourceLocation AccessLoc,
+                                  bool IsPrivate,
+                                  ArrayRef<IdentifierLocPair> Names) {
+  NamespaceDecl *Module = dyn_cast<NamespaceDecl>(CurContext);
+  if (!Module || !Module->getParent()->isProgram()) {
+    Diag(AccessLoc, diag::err_fortran_access_stmt_outside_module)
+      << IsPrivate;
+    return;
+  }
+  if (isFortranSubmodule(Module)) {
+    Diag(AccessLoc, diag::err_fortran_access_stmt_in_submodule) << IsPrivate;
+    return;
+  }
+
+  FortranModuleAccessInfo &Access = CurFortranModuleAccess;
+  if (Names.empty()) {
+    if (Access.DefaultLoc.isValid()) {
+      Diag(AccessLoc, diag::err_fortran_default_access_twice)
+        << Module->getDeclName();
+      return;
+    }
+    Access.DefaultLoc = AccessLoc;
+    Access.DefaultPrivate = IsPrivate;
+    return;
+  }
+
+  for (unsigned I = 0, N = Names.size(); I != N; ++I)
+    Access.Names.push_back(std::make_pair(Names[I], IsPrivate));
+}
+
+NamespaceDecl *Sema::LookupFortranModule(IdentifierInfo *Name,
+                                         SourceLocation Loc,
+                                         bool IsIntrinsic) {
+  // Modules defined earlier in this program, and modules whose files have
+  // already been read, are found by name lookup at program scope.
+  LookupResult R(*this, Name, Loc, LookupNamespaceName);
+  LookupQualifiedName(R, Context.getProgramDecl());
+  if (NamespaceDecl *Module = R.getAsSingle<NamespaceDecl>())
+    return Module;
+
+  if (IsIntrinsic) {
+    Diag(Loc, diag::err_fortran_intrinsic_module_not_found) << Name;
+    return 0;
+  }
+
+  if (!PP.getPCModuleLoader().loadFortranModule(Loc, Name)) {
+    Diag(Loc, diag::err_fortran_module_not_found) << Name;
+    return 0;
+  }
+
+  // Reading the module file only registers its identifiers; this lookup
+  // deserializes the module's namespace, and nothing else.
+  R.clear();
+  LookupQualifiedName(R, Context.getProgramDecl());
+  if (NamespaceDecl *Module = R.getAsSingle<NamespaceDecl>())
+    return Module;
+
+  // The loader has already diagnosed a module file it could not read.
+  if (!Diags.hasErrorOccurred())
+    Diag(Loc, diag::err_fortran_module_not_in_file) << Name;
+  return 0;
+}
+
+Sema::DeclGroupPtrTy
+Sema::ActOnFortranUseStmt(Scope *S, SourceLocation UseLoc,
+                          IdentifierInfo *ModuleName,
+                          SourceLocation ModuleNameLoc, bool IsIntrinsic,
+                          bool HasOnly, ArrayRef<FortranUseItem> Items) {
+  NamespaceDecl *Module = LookupFortranModule(ModuleName, ModuleNameLoc,
+                                              IsIntrinsic);
+  if (!Module)
+    return DeclGroupPtrTy();
+
+  if (Module->Encloses(CurContext)) {
+    Diag(ModuleNameLoc, diag::err_fortran_module_uses_itself) << ModuleName;
+    return DeclGroupPtrTy();
+  }
+
+  // The ancestor of a submodule is accessed by host association instead.
+  for (DeclContext *DC = CurContext; !DC->isProgram(); DC = DC->getParent()) {
+    NamespaceDecl *Submodule = dyn_cast<NamespaceDecl>(DC);
+    if (Submodule && isFortranSubmodule(Submodule) &&
+        Submodule->getName().split('@').first == Module->getName()) {
+      Diag(ModuleNameLoc, diag::err_fortran_submodule_uses_ancestor)
+        << ModuleName;
+      return DeclGroupPtrTy();
+    }
+  }
+
+  SmallVector<Decl *, 8> Decls;
+
+  // Without an ONLY list, every public entity of the module is visible.
+  // FIXME: Entities renamed without an ONLY list should no longer be
+  // visible by their original names.
+  if (!HasOnly) {
+    DeclContext *CommonAncestor = Module;
+    while (CommonAncestor && !CommonAncestor->Encloses(CurContext))
+      CommonAncestor = CommonAncestor->getParent();
+
+    UsingDirectiveDecl *UDir
+      = UsingDirectiveDecl::Create(Context, CurContext, UseLoc, UseLoc,
+                                   NestedNameSpecifierLoc(), ModuleNameLoc,
+                                   Module, CommonAncestor);
+    PushUsingDirective(S, UDir);
+    Decls.push_back(UDir);
+  }
+
+  CXXScopeSpec SS;
+  SS.Extend(Context, Module, ModuleNameLoc, ModuleNameLoc);
+  for (unsigned I = 0, N = Items.size(); I != N; ++I) {
+    const FortranUseItem &Item = Items[I];
+
+    // A qualified lookup into the module reads only this entity from the
+    // module file.
+    LookupResult R(*this, Item.UseName, Item.UseNameLoc, LookupOrdinaryName);
+    LookupQualifiedName(R, Module);
+    if (R.empty() || R.isAmbiguous()) {
+      if (R.empty())
+        Diag(Item.UseNameLoc, diag::err_fortran_module_no_entity)
+          << Item.UseName << ModuleName;
+      continue;
+    }
+
+    DeclarationNameInfo NameInfo(Item.UseName, Item.UseNameLoc);
+    UsingDecl *UD = UsingDecl::Create(Context, CurContext, UseLoc,
+                                      SS.getWithLocInContext(Context),
+                                      NameInfo, /*IsTypeNameArg=*/false);
+    CurContext->addDecl(UD);
+    Decls.push_back(UD);
+
+    for (LookupResult::iterator D = R.begin(), DEnd = R.end(); D != DEnd;
+         ++D) {
+      NamedDecl *Target = *D;
+      if (UsingShadowDecl *Shadow = dyn_cast<UsingShadowDecl>(Target))
+        Target = Shadow->getTargetDecl();
+
+      UsingShadowDecl *Shadow
+        = UsingShadowDecl::Create(Context, CurContext, Item.LocalNameLoc, UD,
+                                  Target);
+      if (Item.LocalName != Item.UseName)
+        Shadow->setDeclName(Item.LocalName);
+      UD->addShadowDecl(Shadow);
+      PushOnScopeChains(Shadow, S);
+    }
+  }
+
+  return DeclGroupPtrTy::make(DeclGroupRef::Create(Context, Decls.data(),
+                                                   Decls.size()));
+}
+
+ImplicitTypeTable &Sema::getFortranDefaultImplicitTypes() {
+  if (!FortranDefaultImplicitTypes) {
+    FortranDefaultImplicitTypes = new (Context) ImplicitTypeTable();
+    for (int I = 0; I != ImplicitTypeTable::NumLetters; ++I) {
+      bool IsInteger = I >= 'i' - 'a' && I <= 'n' - 'a';
+      FortranDefaultImplicitTypes->setType(I, IsInteger ? Context.IntTy
+                                                        : Context.FloatTy);
+    }
+  }
+  return *FortranDefaultImplicitTypes;
+}
+
+QualType Sema::getFortranImplicitType(Scope *S, IdentifierInfo *II) {
+  ImplicitTypeTable *Types = S->getImplicitTypes();
+  if (!Types)
+    Types = &getFortranDefaultImplicitTypes();
+  return Types->getType(II->getName());
+}
+
+/// \brief Returns the implicit typing rules of the scoping unit of \p S for
+/// its IMPLICIT statements to change, first giving the scoping unit its own
+/// copy if it still shares the rules of its host.
+static ImplicitTypeTable *getOwnImplicitTypes(Sema &SemaRef, Scope *S) {
+  ImplicitTypeTable *Types = S->getImplicitTypes();
+  Scope *Parent = S->getParent();
+  if (Types && (!Parent || Parent->getImplicitTypes() != Types))
+    return Types;
+
+  const ImplicitTypeTable &Host
+    = Types ? *Types : SemaRef.getFortranDefaultImplicitTypes();
+  Types = new (SemaRef.Context) ImplicitTypeTable(
+    ImplicitTypeTable::inheritFrom(Host));
+  S->setImplicitTypes(Types);
+  return Types;
+}
+
+void Sema::ActOnFortranImplicitSpec(Scope *S, SourceLocation ImplicitLoc,
+                                    ParsedType Ty,
+                                    ArrayRef<FortranLetterSpec> Letters) {
+  QualType T = GetTypeFromParser(Ty);
+  if (T.isNull())
+    return;
+
+  ImplicitTypeTable *Types = getOwnImplicitTypes(*this, S);
+  if (Types->hasNone()) {
+    Diag(ImplicitLoc, diag::err_fortran_implicit_none_and_spec);
+    return;
+  }
+
+  for (unsigned I = 0, N = Letters.size(); I != N; ++I) {
+    const FortranLetterSpec &Spec = Letters[I];
+    int First = ImplicitTypeTable::getLetterIndex(Spec.First);
+    int Last = ImplicitTypeTable::getLetterIndex(Spec.Last);
+    if (First > Last) {
+      Diag(Spec.Loc, diag::err_fortran_implicit_letter_range)
+        << StringRef(&Spec.First, 1) << StringRef(&Spec.Last, 1);
+      continue;
+    }
+
+    for (int Letter = First; Letter <= Last; ++Letter) {
+      if (Types->isSpecified(Letter)) {
+        char Name = 'a' + Letter;
+        Diag(Spec.Loc, diag::err_fortran_implicit_letter_twice)
+          << StringRef(&Name, 1);
+        break;
+      }
+      Types->setType(Letter, T);
+    }
+  }
+}
+
+void Sema::ActOnFortranImplicitNone(Scope *S, SourceLocation ImplicitLoc) {
+  ImplicitTypeTable *Types = getOwnImplicitTypes(*this, S);
+  if (Types->hasNone() || Types->hasSpecifiedLetters()) {
+    Diag(ImplicitLoc, diag::err_fortran_implicit_none_and_spec);
+    return;
+  }
+  Types->setNone();
+}
+
 void Sema::ActOnPragmaRedefineExtname(IdentifierInfo* Name,
                                       IdentifierInfo* AliasName,
                                       SourceLocation PragmaLoc,
@@ -6456,6 +6456,9 @@ void Sema::PushUsingDirective(Scope *S, UsingDirectiveDecl *UDir) {
     // Otherwise, it is at block sope. The using-directives will affect lookup
     // only to the end of the scope.
     S->PushUsingDirective(UDir);
+
+  // Names already looked up by use association may now find more entities.
+  S->clearUseAssociatedDecls();
 }
 
 
@@ -1789,6 +1789,14 @@ ExprResult Sema::ActOnIdExpression(Scope *S,
   if (R.isAmbiguous())
     return ExprError();
 
+  // A Fortran name that is referenced as a procedure and has no other
+  // meaning in the scoping unit may be an intrinsic procedure.
+  if (R.empty() && HasTrailingLParen && II && !SS.isSet() &&
+      getLangOpts().F77) {
+    if (NamedDecl *D = LazilyCreateFortranIntrinsic(II, NameLoc))
+      R.addDecl(D);
+  }
+
   // Determine whether this name might be a candidate for
   // argument-dependent lookup.
   bool ADL = UseArgumentDependentLookup(SS, R, HasTrailingLParen);
@@ -1801,6 +1809,13 @@ ExprResult Sema::ActOnIdExpression(Scope *S,
       if (D) R.addDecl(D);
     }
 
+    // A Fortran variable that is not declared gets the implicit type of its
+    // initial letter in the scoping unit.
+    if (!HasTrailingLParen && II && !SS.isSet() && getLangOpts().F77) {
+      if (VarDecl *Var = ImplicitlyDeclareFortranVariable(NameLoc, *II, S))
+        R.addDecl(Var);
+    }
+
     // If this name wasn't predeclared and if this is not a function
     // call, diagnose the problem.
     if (R.empty()) {
@@ -2282,6 +2297,10 @@ bool Sema::UseArgumentDependentLookup(const CXXScopeSpec &SS,
       // But also builtin functions.
       if (FDecl->getBuiltinID() && FDecl->isImplicit())
         return false;
+
+      // And Fortran intrinsic procedures.
+      if (FDecl->hasAttr<FortranIntrinsicAttr>())
+        return false;
     } else if (!isa<SubprogramTemplateDecl>(D))
       return false;
   }
@@ -3870,6 +3889,10 @@ Sema::ActOnCallExpr(Scope *S, Expr *SubPgm, SourceLocation LParenLoc,
   if (Result.isInvalid()) return ExprError();
   SubPgm = Result.take();
 
+  // A parenthesized list after an array is an array element reference.
+  if (getLangOpts().F90 && Context.isFortranArrayType(SubPgm->getType()))
+    return BuildFortranArrayElementRef(SubPgm, LParenLoc, ArgExprs, RParenLoc);
+
   if (getLangOpts().F90) {
     // If this is a pseudo-destructor expression, build the call immediately.
     if (isa<CXXPseudoDestructorExpr>(SubPgm)) {
@@ -4057,6 +4080,12 @@ Sema::BuildResolvedCallExpr(Expr *SubPgm, NamedDecl *NDecl,
   if (BuiltinID && Context.BuiltinInfo.hasCustomTypechecking(BuiltinID))
     return CheckBuiltinSubprogramCall(BuiltinID, TheCall);
 
+  // Calls to Fortran intrinsic procedures are checked against the intrinsic
+  // table rather than a prototype.
+  if (FDecl)
+    if (const FortranIntrinsicAttr *IA = FDecl->getAttr<FortranIntrinsicAttr>())
+      return CheckFortranIntrinsicCall(IA->getIntrinsicID(), TheCall);
+
  retry:
   const SubprogramType *FuncT;
   if (const PointerType *PT = SubPgm->getType()->getAs<PointerType>()) {
@@ -8308,6 +8337,279 @@ static void DiagnoseSelfAssignment(Sema &S, Expr *LHSExpr, Expr *RHSExpr,
       << LHSExpr->getSourceRange() << RHSExpr->getSourceRange();
 }
 
+/// \brief Describe the shape of a Fortran array the way it is declared, for
+/// example "(10, 20)".
+static std::string getFortranShapeString(ASTContext &Ctx, QualType T) {
+  SmallVector<std::string, 4> Extents;
+  while (Ctx.isFortranArrayType(T)) {
+    const ArrayType *AT = Ctx.getAsArrayType(T);
+    if (const ConstantArrayType *CAT = dyn_cast<ConstantArrayType>(AT))
+      Extents.push_back(CAT->getSize().toString(10, /*Signed=*/false));
+    else
+      Extents.push_back(":");
+    T = AT->getElementType();
+  }
+
+  // The innermost array type is the first dimension.
+  std::string Shape = "(";
+  for (unsigned I = Extents.size(); I != 0; --I) {
+    Shape += Extents[I - 1];
+    if (I != 1)
+      Shape += ", ";
+  }
+  return Shape + ")";
+}
+
+/// \brief Determine whether two Fortran arrays have the same rank and, where
+/// they are known, the same extents.
+static bool haveSameFortranShape(ASTContext &Ctx, QualType A, QualType B) {
+  while (Ctx.isFortranArrayType(A) && Ctx.isFortranArrayType(B)) {
+    const ConstantArrayType *CA = Ctx.getAsConstantArrayType(A);
+    const ConstantArrayType *CB = Ctx.getAsConstantArrayType(B);
+    if (CA && CB &&
+        CA->getSize().getZExtValue() != CB->getSize().getZExtValue())
+      return false;
+    A = Ctx.getAsArrayType(A)->getElementType();
+    B = Ctx.getAsArrayType(B)->getElementType();
+  }
+  return Ctx.isFortranArrayType(A) == Ctx.isFortranArrayType(B);
+}
+
+bool Sema::CheckFortranArrayConformance(SourceLocation Loc, Expr *LHS,
+                                        Expr *RHS) {
+  if (haveSameFortranShape(Context, LHS->getType(), RHS->getType()))
+    return false;
+
+  Diag(Loc, diag::err_fortran_array_not_conformable)
+    << getFortranShapeString(Context, LHS->getType())
+    << getFortranShapeString(Context, RHS->getType())
+    << LHS->getSourceRange() << RHS->getSourceRange();
+  return true;
+}
+
+ExprResult Sema::BuildFortranArrayElementRef(Expr *Base,
+                                             SourceLocation LParenLoc,
+                                             MultiExprArg Subscripts,
+                                             SourceLocation RParenLoc) {
+  unsigned Rank = 0;
+  for (QualType T = Base->getType(); Context.isFortranArrayType(T);
+       T = Context.getAsArrayType(T)->getElementType())
+    ++Rank;
+  if (Subscripts.size() != Rank) {
+    Diag(LParenLoc, diag::err_fortran_array_subscript_count)
+      << Rank << unsigned(Subscripts.size()) << Base->getSourceRange();
+    return ExprError();
+  }
+
+  // FIXME: Explicit lower bounds are not parsed yet, so every dimension
+  // starts at one.
+  SmallVector<Expr *, 4> Offsets;
+  for (unsigned I = 0; I != Rank; ++I) {
+    ExprResult Sub = DefaultLvalueConversion(Subscripts[I]);
+    if (Sub.isInvalid())
+      return ExprError();
+    QualType SubTy = Sub.get()->getType();
+    if (!SubTy->isIntegerType() || SubTy->isBooleanType()) {
+      Diag(Sub.get()->getExprLoc(), diag::err_fortran_array_subscript_type)
+        << SubTy << Sub.get()->getSourceRange();
+      return ExprError();
+    }
+    SourceLocation Loc = Sub.get()->getExprLoc();
+    Expr *One = IntegerLiteral::Create(Context,
+                                       llvm::APInt(Context.getIntWidth(SubTy),
+                                                   1),
+                                       SubTy, Loc);
+    ExprResult Offset = CreateBuiltinBinOp(Loc, BO_Sub, Sub.take(), One);
+    if (Offset.isInvalid())
+      return ExprError();
+    Offsets.push_back(Offset.take());
+  }
+
+  // The outermost array type is the last dimension.
+  Expr *Elt = Base;
+  for (unsigned I = Rank; I != 0; --I) {
+    ExprResult R = CreateBuiltinArraySubscriptExpr(Elt, LParenLoc,
+                                                   Offsets[I - 1], RParenLoc);
+    if (R.isInvalid())
+      return ExprError();
+    Elt = R.take();
+  }
+  return Owned(Elt);
+}
+
+/// \brief Determine whether \p T is a Fortran numeric (integer, real or
+/// complex) type.
+static bool isFortranNumericType(ASTContext &Ctx, QualType T) {
+  return T->isArithmeticType() && !T->isBooleanType() &&
+         !Ctx.isFortranCharacterType(T);
+}
+
+/// \brief Convert the elements of the Fortran array or scalar \p E to the
+/// scalar type \p ScalarTy.
+///
+/// The conversion of an array is one array-typed implicit cast for each step
+/// of converting a single element; code generation applies them element by
+/// element.
+static ExprResult convertFortranElements(Sema &S, Expr *E,
+                                         QualType ScalarTy) {
+  ASTContext &Ctx = S.Context;
+  QualType EltTy = Ctx.getFortranScalarType(E->getType());
+  if (!Ctx.isFortranArrayType(E->getType())) {
+    ExprResult Res = S.DefaultLvalueConversion(E);
+    if (Res.isInvalid() || Ctx.hasSameUnqualifiedType(EltTy, ScalarTy))
+      return Res;
+    CastKind CK = S.PrepareScalarCast(Res, ScalarTy);
+    return S.ImpCastExprToType(Res.take(), ScalarTy, CK);
+  }
+
+  if (Ctx.hasSameUnqualifiedType(EltTy, ScalarTy))
+    return S.Owned(E);
+
+  // Convert a stand-in for one element the way a scalar is converted, and
+  // apply each step of that conversion to the whole array.
+  ExprResult EltRes = S.Owned(new (Ctx) OpaqueValueExpr(
+    E->getExprLoc(), EltTy.getUnqualifiedType(), VK_RValue));
+  CastKind CK = S.PrepareScalarCast(EltRes, ScalarTy);
+  if (ImplicitCastExpr *Step = dyn_cast<ImplicitCastExpr>(EltRes.get()))
+    E = S.ImpCastExprToType(E, Ctx.getFortranArrayOfShape(E->getType(),
+                                                          Step->getType()),
+                            Step->getCastKind()).take();
+  return S.ImpCastExprToType(E, Ctx.getFortranArrayOfShape(E->getType(),
+                                                           ScalarTy), CK);
+}
+
+ExprResult Sema::CreateFortranArrayBinOp(SourceLocation OpLoc,
+                                         BinaryOperatorKind Opc,
+                                         Expr *LHSExpr, Expr *RHSExpr) {
+  QualType LHSTy = LHSExpr->getType(), RHSTy = RHSExpr->getType();
+  bool LHSIsArray = Context.isFortranArrayType(LHSTy);
+  bool RHSIsArray = Context.isFortranArrayType(RHSTy);
+  QualType LHSEltTy = Context.getFortranScalarType(LHSTy).getUnqualifiedType();
+  QualType RHSEltTy = Context.getFortranScalarType(RHSTy).getUnqualifiedType();
+  bool LHSIsNumeric = isFortranNumericType(Context, LHSEltTy);
+  bool RHSIsNumeric = isFortranNumericType(Context, RHSEltTy);
+
+  if (Opc == BO_Assign && !LHSIsArray) {
+    Diag(OpLoc, diag::err_fortran_array_assign_to_scalar)
+      << getFortranShapeString(Context, RHSTy)
+      << LHSExpr->getSourceRange() << RHSExpr->getSourceRange();
+    return ExprError();
+  }
+
+  // An array conforms with a scalar, which stands for an array of that
+  // shape whose elements all have its value.
+  if (LHSIsArray && RHSIsArray &&
+      CheckFortranArrayConformance(OpLoc, LHSExpr, RHSExpr))
+    return ExprError();
+
+  // The type the elements of both operands are converted to, and the type of
+  // the elements of the result.
+  QualType OperandTy, ResultEltTy;
+  switch (Opc) {
+  case BO_Assign:
+    if (!(LHSIsNumeric && RHSIsNumeric) &&
+        !Context.hasSameType(LHSEltTy, RHSEltTy))
+      break;
+    OperandTy = ResultEltTy = LHSEltTy;
+    break;
+  case BO_Mul:
+  case BO_Div:
+  case BO_Add:
+  case BO_Sub:
+  case BO_LT:
+  case BO_GT:
+  case BO_LE:
+  case BO_GE:
+  case BO_EQ:
+  case BO_NE: {
+    if (!LHSIsNumeric || !RHSIsNumeric)
+      break;
+    ExprResult LHSElt = Owned(new (Context) OpaqueValueExpr(
+      LHSExpr->getExprLoc(), LHSEltTy, VK_RValue));
+    ExprResult RHSElt = Owned(new (Context) OpaqueValueExpr(
+      RHSExpr->getExprLoc(), RHSEltTy, VK_RValue));
+    OperandTy = UsualArithmeticConversions(LHSElt, RHSElt);
+    ResultEltTy = BinaryOperator::isComparisonOp(Opc) ? Context.BoolTy
+                                                      : OperandTy;
+    break;
+  }
+  case BO_LAnd:
+  case BO_LOr:
+    if (!LHSEltTy->isBooleanType() || !RHSEltTy->isBooleanType())
+      break;
+    OperandTy = ResultEltTy = Context.BoolTy;
+    break;
+  default:
+    break;
+  }
+  if (OperandTy.isNull()) {
+    Diag(OpLoc, diag::err_typecheck_invalid_operands)
+      << LHSTy << RHSTy << LHSExpr->getSourceRange()
+      << RHSExpr->getSourceRange();
+    return ExprError();
+  }
+
+  ExprResult LHS = Owned(LHSExpr);
+  ExprValueKind VK = VK_RValue;
+  QualType ResultTy;
+  if (Opc == BO_Assign) {
+    if (!LHSExpr->isLValue() || LHSTy.isConstQualified()) {
+      Diag(OpLoc, diag::err_typecheck_expression_not_modifiable_lvalue)
+        << LHSExpr->getSourceRange();
+      return ExprError();
+    }
+    VK = LHSExpr->getValueKind();
+    ResultTy = LHSTy;
+  } else {
+    LHS = convertFortranElements(*this, LHSExpr, OperandTy);
+    ResultTy = Context.getFortranArrayOfShape(LHSIsArray ? LHSTy : RHSTy,
+                                              ResultEltTy);
+  }
+  ExprResult RHS = convertFortranElements(*this, RHSExpr, OperandTy);
+  if (LHS.isInvalid() || RHS.isInvalid())
+    return ExprError();
+
+  return Owned(new (Context) BinaryOperator(LHS.take(), RHS.take(), Opc,
+                                            ResultTy, VK, OK_Ordinary, OpLoc,
+                                            FPFeatures.fp_contract));
+}
+
+ExprResult Sema::CreateFortranArrayUnaryOp(SourceLocation OpLoc,
+                                           UnaryOperatorKind Opc,
+                                           Expr *InputExpr) {
+  QualType InputTy = InputExpr->getType();
+  QualType EltTy = Context.getFortranScalarType(InputTy).getUnqualifiedType();
+
+  QualType ResultEltTy;
+  switch (Opc) {
+  case UO_Plus:
+  case UO_Minus:
+    // Promote the elements like a scalar operand.
+    if (isFortranNumericType(Context, EltTy))
+      ResultEltTy = EltTy->isPromotableIntegerType() ?
+        Context.getPromotedIntegerType(EltTy) : EltTy;
+    break;
+  case UO_LNot:
+    if (EltTy->isBooleanType())
+      ResultEltTy = Context.BoolTy;
+    break;
+  default:
+    break;
+  }
+  if (ResultEltTy.isNull()) {
+    Diag(OpLoc, diag::err_typecheck_unary_expr)
+      << InputTy << InputExpr->getSourceRange();
+    return ExprError();
+  }
+
+  ExprResult Input = convertFortranElements(*this, InputExpr, ResultEltTy);
+  if (Input.isInvalid())
+    return ExprError();
+  return Owned(new (Context) UnaryOperator(Input.take(), Opc,
+                 Context.getFortranArrayOfShape(InputTy, ResultEltTy),
+                 VK_RValue, OK_Ordinary, OpLoc));
+}
+
 /// CreateBuiltinBinOp - Creates a new built-in binary operation with
 /// operator @p Opc at location @c TokLoc. This routine only supports
 /// built-in operations; ActOnBinOp handles overloaded operators.
@@ -8332,6 +8634,12 @@ ExprResult Sema::CreateBuiltinBinOp(SourceLocation OpLoc,
     RHSExpr = Init.take();
   }
 
+  // Fortran intrinsic operations apply element by element to arrays.
+  if (getLangOpts().F90 &&
+      (Context.isFortranArrayType(LHSExpr->getType()) ||
+       Context.isFortranArrayType(RHSExpr->getType())))
+    return CreateFortranArrayBinOp(OpLoc, Opc, LHSExpr, RHSExpr);
+
   ExprResult LHS = Owned(LHSExpr), RHS = Owned(RHSExpr);
   QualType ResultTy;     // Result type of the binary operator.
   // The following two variables are used for compound assignment operators
@@ -8753,6 +9061,9 @@ ExprResult Sema::BuildBinOp(Scope *S, SourceLocation OpLoc,
 ExprResult Sema::CreateBuiltinUnaryOp(SourceLocation OpLoc,
                                       UnaryOperatorKind Opc,
                                       Expr *InputExpr) {
+  if (getLangOpts().F90 && Context.isFortranArrayType(InputExpr->getType()))
+    return CreateFortranArrayUnaryOp(OpLoc, Opc, InputExpr);
+
   ExprResult Input = Owned(InputExpr);
   ExprValueKind VK = VK_RValue;
   ExprObjectKind OK = OK_Ordinary;
@@ -1048,6 +1048,124 @@ bool Sema::CppLookupName(LookupResult &R, Scope *S) {
   return !R.empty();
 }
 
+/// \brief Determine whether every scope from \p S outwards is a Fortran
+/// scoping unit or block, which FortranLookupName() handles.
+static bool isFortranScopeChain(Scope *S) {
+  for (; S; S = S->getParent()) {
+    if (S->isClassScope() || S->isTemplateParamScope())
+      return false;
+    DeclContext *Ctx = static_cast<DeclContext *>(S->getEntity());
+    if (Ctx && !Ctx->isFileContext() &&
+        (!Ctx->isSubprogramOrMethod() || isa<ObjCMethodDecl>(Ctx)))
+      return false;
+  }
+  return true;
+}
+
+/// \brief Look for a name among the entities that the USE statements of the
+/// scoping unit \p S make accessible.
+///
+/// The entities are searched for in the USEd modules, and the modules they
+/// USE in turn, the first time the name is looked up in \p S.  Later lookups
+/// only probe the table of \p S, however many modules it USEs.
+static bool LookupFortranUseAssociated(LookupResult &R, Scope *S,
+                                       IdentifierInfo *II) {
+  const Scope::UseAssociatedDeclsTy *Decls = S->getUseAssociatedDecls(II);
+  if (!Decls) {
+    SmallVector<DeclContext *, 8> Worklist;
+    for (Scope::udir_iterator I = S->using_directives_begin(),
+                              E = S->using_directives_end(); I != E; ++I)
+      Worklist.push_back((*I)->getNominatedNamespace());
+    DeclContext *Ctx = static_cast<DeclContext *>(S->getEntity());
+    if (Ctx && Ctx->isFileContext()) {
+      DeclContext::udir_iterator I, E;
+      for (llvm::tie(I, E) = Ctx->getUsingDirectives(); I != E; ++I)
+        Worklist.push_back((*I)->getNominatedNamespace());
+    }
+    // Scopes without USE statements keep no table.
+    if (Worklist.empty())
+      return false;
+
+    Scope::UseAssociatedDeclsTy Found;
+    llvm::SmallPtrSet<DeclContext *, 8> Visited;
+    while (!Worklist.empty()) {
+      DeclContext *Module = Worklist.pop_back_val()->getPrimaryContext();
+      if (!Visited.insert(Module))
+        continue;
+
+      DeclContext::lookup_result Result = Module->lookup(II);
+      for (DeclContext::lookup_iterator I = Result.begin(), E = Result.end();
+           I != E; ++I)
+        Found.push_back(*I);
+
+      // The entities a module accesses by use association are accessible
+      // from it as well.
+      DeclContext::udir_iterator I, E;
+      for (llvm::tie(I, E) = Module->getUsingDirectives(); I != E; ++I)
+        Worklist.push_back((*I)->getNominatedNamespace());
+    }
+
+    S->setUseAssociatedDecls(II, Found);
+    Decls = S->getUseAssociatedDecls(II);
+  }
+
+  bool Found = false;
+  for (Scope::UseAssociatedDeclsTy::const_iterator I = Decls->begin(),
+                                                   E = Decls->end();
+       I != E; ++I) {
+    if (NamedDecl *ND = R.getAcceptableDecl(*I)) {
+      R.addDecl(ND);
+      Found = true;
+    }
+  }
+  return Found;
+}
+
+/// \brief Perform Fortran unqualified name lookup.
+///
+/// Each scoping unit from \p S outwards is searched for its local entities,
+/// then for the entities it accesses by use association; what is not found
+/// is accessed by host association from the next scoping unit.  Lookups this
+/// routine does not model, such as lookups for redeclaration, are handed to
+/// CppLookupName().
+bool Sema::FortranLookupName(LookupResult &R, Scope *S) {
+  DeclarationName Name = R.getLookupName();
+  IdentifierInfo *II = Name.getAsIdentifierInfo();
+  if (!II || R.isForRedeclaration() || R.getLookupKind() == LookupMemberName ||
+      !isFortranScopeChain(S))
+    return CppLookupName(R, S);
+
+  IdentifierResolver::iterator I = IdResolver.begin(Name),
+                               IEnd = IdResolver.end();
+  for (; S; S = S->getParent()) {
+    // The local entities of the scope, including those named in the ONLY
+    // lists of its USE statements.
+    bool Found = false;
+    for (; I != IEnd && S->isDeclScope(*I); ++I) {
+      if (NamedDecl *ND = R.getAcceptableDecl(*I)) {
+        Found = true;
+        R.addDecl(ND);
+      }
+    }
+
+    // Entities of a module or of the program that were read from an AST
+    // file are not on the identifier chain.
+    DeclContext *Ctx = static_cast<DeclContext *>(S->getEntity());
+    if (!Found && Ctx && Ctx->isFileContext())
+      Found = LookupDirect(*this, R, Ctx);
+
+    if (!Found)
+      Found = LookupFortranUseAssociated(R, S, II);
+
+    if (Found) {
+      R.resolveKind();
+      return true;
+    }
+  }
+
+  return false;
+}
+
 /// \brief Retrieve the visible declaration corresponding to D, if any.
 ///
 /// This routine determines whether the declaration D is visible in the current
@@ -1199,8 +1317,8 @@ bool Sema::LookupName(LookupResult &R, Scope *S, bool AllowBuiltinCreation) {
         return true;
       }
   } else {
-    // Perform C++ unqualified name lookup.
-    if (CppLookupName(R, S))
+    // Perform Fortran unqualified name lookup.
+    if (FortranLookupName(R, S))
       return true;
   }
 
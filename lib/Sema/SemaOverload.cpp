@@ -9823,6 +9823,68 @@ bool Sema::buildOverloadedCallSet(Scope *S, Expr *SubPgm,
   return false;
 }
 
+/// FinishResolvedOverloadedCallExpr - Builds the call to the function FDecl,
+/// found as FoundDecl, that overload resolution chose for a call to ULE.
+static ExprResult FinishResolvedOverloadedCallExpr(Sema &SemaRef, Expr *SubPgm,
+                                                   UnresolvedLookupExpr *ULE,
+                                                   SourceLocation LParenLoc,
+                                                   Expr **Args,
+                                                   unsigned NumArgs,
+                                                   SourceLocation RParenLoc,
+                                                   Expr *ExecConfig,
+                                                   DeclAccessPair FoundDecl,
+                                                   SubprogramDecl *FDecl) {
+  SemaRef.MarkSubprogramReferenced(SubPgm->getExprLoc(), FDecl);
+  SemaRef.CheckUnresolvedLookupAccess(ULE, FoundDecl);
+  SemaRef.DiagnoseUseOfDecl(FDecl, ULE->getNameLoc());
+  SubPgm = SemaRef.FixOverloadedSubprogramReference(SubPgm, FoundDecl, FDecl);
+  return SemaRef.BuildResolvedCallExpr(SubPgm, FDecl, LParenLoc, Args, NumArgs,
+                                       RParenLoc, ExecConfig);
+}
+
+/// \brief Computes the key of the resolution of a call to the generic \p ULE
+/// in Sema::GenericResolutions.
+///
+/// \returns false if the resolution may depend on more than the specifics
+/// in scope and the type, kind and rank of the actual arguments, in which
+/// case it is not cached.
+static bool getGenericResolutionKey(Sema &SemaRef, UnresolvedLookupExpr *ULE,
+                                    Expr **Args, unsigned NumArgs,
+                                    llvm::FoldingSetNodeID &ID) {
+  if (ULE->hasExplicitTemplateArgs())
+    return false;
+
+  SemaRef.GenericResolutions.addGenericName(ID, ULE->getName());
+  ID.AddInteger(ULE->requiresADL());
+  for (UnresolvedLookupExpr::decls_iterator I = ULE->decls_begin(),
+                                            E = ULE->decls_end();
+       I != E; ++I) {
+    if (!isa<SubprogramDecl>((*I)->getUnderlyingDecl()))
+      return false;
+    ID.AddPointer(*I);
+    ID.AddInteger(I.getAccess());
+  }
+
+  for (unsigned I = 0; I != NumArgs; ++I) {
+    Expr *Arg = Args[I];
+    QualType T = Arg->getType();
+    if (Arg->isTypeDependent() || T->isPlaceholderType())
+      return false;
+
+    // A null pointer constant converts unlike other integers of its type.
+    if (T->isIntegralOrEnumerationType() &&
+        Arg->isNullPointerConstant(SemaRef.Context,
+                                   Expr::NPC_ValueDependentIsNotNull))
+      return false;
+
+    // The kind and rank of an argument are part of its type.
+    ID.AddPointer(SemaRef.Context.getCanonicalType(T).getAsOpaquePtr());
+    ID.AddInteger(Arg->getValueKind());
+    ID.AddInteger(Arg->getObjectKind());
+  }
+  return true;
+}
+
 /// FinishOverloadedCallExpr - given an OverloadCandidateSet, builds and returns
 /// the completed call expression. If overload resolution fails, emits
 /// diagnostics and returns ExprError()
@@ -9843,15 +9905,11 @@ static ExprResult FinishOverloadedCallExpr(Sema &SemaRef, Scope *S, Expr *SubPgm
                                  AllowTypoCorrection);
 
   switch (OverloadResult) {
-  case OR_Success: {
-    SubprogramDecl *FDecl = (*Best)->Subprogram;
-    SemaRef.MarkSubprogramReferenced(SubPgm->getExprLoc(), FDecl);
-    SemaRef.CheckUnresolvedLookupAccess(ULE, (*Best)->FoundDecl);
-    SemaRef.DiagnoseUseOfDecl(FDecl, ULE->getNameLoc());
-    SubPgm = SemaRef.FixOverloadedSubprogramReference(SubPgm, (*Best)->FoundDecl, FDecl);
-    return SemaRef.BuildResolvedCallExpr(SubPgm, FDecl, LParenLoc, Args, NumArgs,
-                                         RParenLoc, ExecConfig);
-  }
+  case OR_Success:
+    return FinishResolvedOverloadedCallExpr(SemaRef, SubPgm, ULE, LParenLoc,
+                                            Args, NumArgs, RParenLoc,
+                                            ExecConfig, (*Best)->FoundDecl,
+                                            (*Best)->Subprogram);
 
   case OR_No_Viable_Subprogram: {
     // Try to recover by looking for viable functions which the user might
@@ -9914,6 +9972,20 @@ ExprResult Sema::BuildOverloadedCallExpr(Scope *S, Expr *SubPgm,
                                          SourceLocation RParenLoc,
                                          Expr *ExecConfig,
                                          bool AllowTypoCorrection) {
+  // Generics tend to be called with the same argument signatures over and
+  // over; reuse the specific that an earlier call resolved to.
+  llvm::FoldingSetNodeID ID;
+  bool IsCacheable = getGenericResolutionKey(*this, ULE, Args, NumArgs, ID);
+  if (IsCacheable) {
+    if (GenericResolutionCache::Resolution *Resolution
+          = GenericResolutions.lookup(ID))
+      return FinishResolvedOverloadedCallExpr(
+        *this, SubPgm, ULE, LParenLoc, Args, NumArgs, RParenLoc, ExecConfig,
+        DeclAccessPair::make(Resolution->getFoundDecl(),
+                             Resolution->getFoundAccess()),
+        Resolution->getSpecific());
+  }
+
   OverloadCandidateSet CandidateSet(SubPgm->getExprLoc());
   ExprResult result;
 
@@ -9925,6 +9997,12 @@ ExprResult Sema::BuildOverloadedCallExpr(Scope *S, Expr *SubPgm,
   OverloadingResult OverloadResult =
       CandidateSet.BestViableSubprogram(*this, SubPgm->getLocStart(), Best);
 
+  // Resolving the call may have resolved others, so the insertion position
+  // is looked up again.
+  if (IsCacheable && OverloadResult == OR_Success)
+    GenericResolutions.insert(ID, Best->Subprogram, Best->FoundDecl.getDecl(),
+                              Best->FoundDecl.getAccess());
+
   return FinishOverloadedCallExpr(*this, S, SubPgm, ULE, LParenLoc, Args, NumArgs,
                                   RParenLoc, ExecConfig, &CandidateSet,
                                   &Best, OverloadResult,
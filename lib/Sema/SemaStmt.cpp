@@ -1167,6 +1167,164 @@ Sema::ActOnDoStmt(SourceLocation DoLoc, Stmt *Body,
   return Owned(new (Context) DoStmt(Body, Cond, DoLoc, WhileLoc, CondRParen));
 }
 
+VarDecl *Sema::ActOnDoConcurrentIndex(Scope *S, IdentifierInfo *Name,
+                                      SourceLocation NameLoc, ParsedType Ty) {
+  LookupResult R(*this, Name, NameLoc, LookupOrdinaryName);
+  LookupName(R, S);
+  VarDecl *Prev = R.getAsSingle<VarDecl>();
+  if (Prev && S->isDeclScope(Prev)) {
+    Diag(NameLoc, diag::err_fortran_do_concurrent_index_twice) << Name;
+    return 0;
+  }
+
+  // F2008 16.4: an index-name without an integer-type-spec has the type it
+  // would have as a variable of the enclosing scoping unit.
+  QualType T;
+  if (Ty)
+    T = GetTypeFromParser(Ty);
+  else if (Prev)
+    T = Prev->getType().getUnqualifiedType();
+  else
+    T = getFortranImplicitType(S, Name);
+  if (T.isNull() || !T->isIntegerType() || T->isBooleanType()) {
+    Diag(NameLoc, diag::err_fortran_do_concurrent_index_type)
+      << Name << !T.isNull() << T;
+    return 0;
+  }
+
+  VarDecl *Index = VarDecl::Create(Context, CurContext, NameLoc, NameLoc,
+                                   Name, T,
+                                   Context.getTrivialTypeSourceInfo(T, NameLoc),
+                                   SC_None, SC_None);
+  PushOnScopeChains(Index, S);
+  return Index;
+}
+
+/// \brief Convert one lower bound, upper bound or stride of a
+/// concurrent-triplet to the type of its index-name.
+static ExprResult CheckConcurrentLimit(Sema &S, Expr *E, unsigned Which,
+                                       QualType IndexTy) {
+  ExprResult Result = S.DefaultLvalueConversion(E);
+  if (Result.isInvalid())
+    return ExprError();
+  E = Result.take();
+
+  QualType T = E->getType();
+  if (!T->isIntegerType() || T->isBooleanType()) {
+    S.Diag(E->getExprLoc(), diag::err_fortran_do_concurrent_limit_type)
+      << Which << T << E->getSourceRange();
+    return ExprError();
+  }
+
+  llvm::APSInt Value;
+  if (Which == DoConcurrentStmt::STEP &&
+      E->isIntegerConstantExpr(Value, S.Context) && !Value) {
+    S.Diag(E->getExprLoc(), diag::err_fortran_do_concurrent_zero_step)
+      << E->getSourceRange();
+    return ExprError();
+  }
+
+  if (!S.Context.hasSameUnqualifiedType(T, IndexTy))
+    E = S.ImpCastExprToType(E, IndexTy, CK_IntegralCast).take();
+  return S.Owned(E);
+}
+
+namespace {
+  /// \brief Diagnoses RETURN statements and branches that leave the body of
+  /// a DO CONCURRENT construct (F2008 C821 and C824).
+  class ConcurrentBranchChecker {
+    Sema &S;
+    llvm::SmallPtrSet<LabelDecl *, 8> Labels;
+    SmallVector<GotoStmt *, 4> Gotos;
+    bool Invalid;
+
+    void collect(Stmt *Child) {
+      if (LabelStmt *Label = dyn_cast<LabelStmt>(Child))
+        Labels.insert(Label->getDecl());
+      else if (GotoStmt *Goto = dyn_cast<GotoStmt>(Child))
+        Gotos.push_back(Goto);
+      else if (isa<ReturnStmt>(Child)) {
+        S.Diag(Child->getLocStart(), diag::err_fortran_do_concurrent_branch)
+          << 0;
+        Invalid = true;
+      }
+      for (Stmt::child_range C = Child->children(); C; ++C)
+        if (*C)
+          collect(*C);
+    }
+
+  public:
+    ConcurrentBranchChecker(Sema &S) : S(S), Invalid(false) { }
+
+    bool check(Stmt *Body) {
+      collect(Body);
+      for (unsigned I = 0, N = Gotos.size(); I != N; ++I)
+        if (!Labels.count(Gotos[I]->getLabel())) {
+          S.Diag(Gotos[I]->getGotoLoc(), diag::err_fortran_do_concurrent_branch)
+            << 1;
+          Invalid = true;
+        }
+      return Invalid;
+    }
+  };
+}
+
+StmtResult
+Sema::ActOnDoConcurrentStmt(SourceLocation DoLoc, SourceLocation LParenLoc,
+                            ArrayRef<VarDecl *> Indices, MultiExprArg Limits,
+                            Expr *Mask, SourceLocation RParenLoc, Stmt *Body,
+                            SourceLocation EndLoc) {
+  assert(Limits.size() ==
+           Indices.size() * DoConcurrentStmt::LIMITS_PER_INDEX &&
+         "wrong number of concurrent-triplet limits");
+  bool Invalid = false;
+
+  SmallVector<Expr *, 12> Converted;
+  for (unsigned I = 0, N = Limits.size(); I != N; ++I) {
+    // An omitted stride is stored as a null expression.
+    if (!Limits[I]) {
+      Converted.push_back(0);
+      continue;
+    }
+    QualType IndexTy =
+      Indices[I / DoConcurrentStmt::LIMITS_PER_INDEX]->getType();
+    ExprResult Limit =
+      CheckConcurrentLimit(*this, Limits[I],
+                           I % DoConcurrentStmt::LIMITS_PER_INDEX, IndexTy);
+    if (Limit.isInvalid())
+      Invalid = true;
+    Converted.push_back(Limit.take());
+  }
+
+  if (Mask) {
+    ExprResult MaskResult = DefaultLvalueConversion(Mask);
+    if (MaskResult.isInvalid())
+      Invalid = true;
+    else if (!MaskResult.get()->getType()->isBooleanType()) {
+      Diag(Mask->getExprLoc(), diag::err_fortran_do_concurrent_mask_type)
+        << MaskResult.get()->getType() << Mask->getSourceRange();
+      Invalid = true;
+    } else
+      Mask = MaskResult.take();
+  }
+
+  if (ConcurrentBranchChecker(*this).check(Body))
+    Invalid = true;
+  if (Invalid)
+    return StmtError();
+
+  DiagnoseUnusedExprResult(Body);
+
+  SmallVector<Decl *, 4> Decls(Indices.begin(), Indices.end());
+  DeclStmt *IndexStmt =
+    new (Context) DeclStmt(DeclGroupRef::Create(Context, Decls.data(),
+                                                Decls.size()),
+                           LParenLoc, RParenLoc);
+  return Owned(new (Context) DoConcurrentStmt(Context, DoLoc, LParenLoc,
+                                              IndexStmt, Converted, Mask,
+                                              RParenLoc, Body, EndLoc));
+}
+
 namespace {
   // This visitor will traverse a conditional statement and store all
   // the evaluated decls into a vector.  Simple is set to true if none
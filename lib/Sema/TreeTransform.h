@@ -1133,6 +1133,20 @@ public:
                                   CondVar, Inc, RParenLoc, Body);
   }
 
+  /// \brief Build a new DO CONCURRENT construct.
+  ///
+  /// By default, performs semantic analysis to build the new statement.
+  /// Subclasses may override this routine to provide different behavior.
+  StmtResult RebuildDoConcurrentStmt(SourceLocation DoLoc,
+                                     SourceLocation LParenLoc,
+                                     ArrayRef<VarDecl *> Indices,
+                                     MultiExprArg Limits, Expr *Mask,
+                                     SourceLocation RParenLoc, Stmt *Body,
+                                     SourceLocation EndLoc) {
+    return getSema().ActOnDoConcurrentStmt(DoLoc, LParenLoc, Indices, Limits,
+                                           Mask, RParenLoc, Body, EndLoc);
+  }
+
   /// \brief Build a new goto statement.
   ///
   /// By default, performs semantic analysis to build the new statement.
@@ -5470,6 +5484,56 @@ TreeTransform<Derived>::TransformForStmt(ForStmt *S) {
                                      FullInc, S->getRParenLoc(), Body.get());
 }
 
+template<typename Derived>
+StmtResult
+TreeTransform<Derived>::TransformDoConcurrentStmt(DoConcurrentStmt *S) {
+  // Transform the index-names
+  SmallVector<VarDecl *, 4> Indices;
+  bool Changed = false;
+  for (unsigned I = 0, N = S->getNumIndices(); I != N; ++I) {
+    VarDecl *Index = S->getIndexVar(I);
+    VarDecl *NewIndex = cast_or_null<VarDecl>(
+        getDerived().TransformDefinition(Index->getLocation(), Index));
+    if (!NewIndex)
+      return StmtError();
+    Changed |= NewIndex != Index;
+    Indices.push_back(NewIndex);
+  }
+
+  // Transform the limits of each index, keeping omitted steps null
+  SmallVector<Expr *, 12> Limits;
+  for (unsigned I = 0, N = S->getNumIndices(); I != N; ++I) {
+    Expr *Old[] = { S->getLower(I), S->getUpper(I), S->getStep(I) };
+    for (unsigned J = 0; J != DoConcurrentStmt::LIMITS_PER_INDEX; ++J) {
+      ExprResult Limit = getDerived().TransformExpr(Old[J]);
+      if (Limit.isInvalid())
+        return StmtError();
+      Changed |= Limit.get() != Old[J];
+      Limits.push_back(Limit.take());
+    }
+  }
+
+  // Transform the mask
+  ExprResult Mask = getDerived().TransformExpr(S->getMask());
+  if (Mask.isInvalid())
+    return StmtError();
+
+  // Transform the body
+  StmtResult Body = getDerived().TransformStmt(S->getBody());
+  if (Body.isInvalid())
+    return StmtError();
+
+  if (!getDerived().AlwaysRebuild() && !Changed &&
+      Mask.get() == S->getMask() &&
+      Body.get() == S->getBody())
+    return SemaRef.Owned(S);
+
+  return getDerived().RebuildDoConcurrentStmt(S->getDoLoc(), S->getLParenLoc(),
+                                              Indices, Limits, Mask.get(),
+                                              S->getRParenLoc(), Body.get(),
+                                              S->getEndLoc());
+}
+
 template<typename Derived>
 StmtResult
 TreeTransform<Derived>::TransformGotoStmt(GotoStmt *S) {
@@ -1818,6 +1818,19 @@ ASTReader::ReadControlBlock(PCModuleFile &F,
       F.InputFileOffsets = (const uint32_t *)BlobStart;
       F.InputFilesLoaded.resize(Record[0]);
       break;
+
+    case FORTRAN_MODULE_INTERFACES: {
+      unsigned Idx = 0, N = Record.size();
+      while (Idx < N) {
+        std::string Name = ReadString(Record, Idx);
+        FortranModuleInterfaceHashes[Name] = Record[Idx++];
+      }
+      break;
+    }
+
+    case FORTRAN_SUBMODULE_FILE:
+      F.FortranSubmoduleFile = true;
+      break;
     }
   }
 
@@ -3300,6 +3313,15 @@ bool ASTReader::readASTFileControlBlock(StringRef Filename,
         break;
       }
 
+      case FORTRAN_MODULE_INTERFACES: {
+        unsigned Idx = 0, N = Record.size();
+        while (Idx < N) {
+          std::string Name = ReadString(Record, Idx);
+          Listener.ReadFortranModuleInterface(Name, Record[Idx++]);
+        }
+        break;
+      }
+
       default:
         // No other validation to perform.
         break;
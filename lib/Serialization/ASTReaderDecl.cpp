@@ -376,7 +376,8 @@ void ASTDeclReader::VisitDecl(Decl *D) {
   D->setAccess((AccessSpecifier)Record[Idx++]);
   D->FromASTFile = true;
   D->setPCModulePrivate(Record[Idx++]);
-  D->Hidden = D->isPCModulePrivate();
+  // The private entities of a Fortran module are visible to its submodules.
+  D->Hidden = D->isPCModulePrivate() && !F.FortranSubmoduleFile;
   
   // Determine whether this declaration is part of a (sub)module. If so, it
   // may not yet be visible.
@@ -236,6 +236,24 @@ void ASTStmtReader::VisitForStmt(ForStmt *S) {
   S->setRParenLoc(ReadSourceLocation(Record, Idx));
 }
 
+void ASTStmtReader::VisitDoConcurrentStmt(DoConcurrentStmt *S) {
+  VisitStmt(S);
+  unsigned NumIndices = Record[Idx++];
+  assert(NumIndices == S->getNumIndices() && "NumStmtFields is wrong ?");
+  S->setIndexDeclStmt(cast_or_null<DeclStmt>(Reader.ReadSubStmt()));
+  for (unsigned I = 0; I != NumIndices; ++I) {
+    S->setLower(I, Reader.ReadSubExpr());
+    S->setUpper(I, Reader.ReadSubExpr());
+    S->setStep(I, Reader.ReadSubExpr());
+  }
+  S->setMask(Reader.ReadSubExpr());
+  S->setBody(Reader.ReadSubStmt());
+  S->setDoLoc(ReadSourceLocation(Record, Idx));
+  S->setLParenLoc(ReadSourceLocation(Record, Idx));
+  S->setRParenLoc(ReadSourceLocation(Record, Idx));
+  S->setEndLoc(ReadSourceLocation(Record, Idx));
+}
+
 void ASTStmtReader::VisitGotoStmt(GotoStmt *S) {
   VisitStmt(S);
   S->setLabel(ReadDeclAs<LabelDecl>(Record, Idx));
@@ -1686,6 +1704,11 @@ Stmt *ASTReader::ReadStmtFromStream(PCModuleFile &F) {
       S = new (Context) ForStmt(Empty);
       break;
 
+    case STMT_DO_CONCURRENT:
+      S = DoConcurrentStmt::CreateEmpty(Context,
+                                        Record[ASTStmtReader::NumStmtFields]);
+      break;
+
     case STMT_GOTO:
       S = new (Context) GotoStmt(Empty);
       break;
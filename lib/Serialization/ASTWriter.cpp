@@ -783,6 +783,8 @@ void ASTWriter::WriteBlockInfoBlock() {
   RECORD(FILE_SYSTEM_OPTIONS);
   RECORD(HEADER_SEARCH_OPTIONS);
   RECORD(PREPROCESSOR_OPTIONS);
+  RECORD(FORTRAN_MODULE_INTERFACES);
+  RECORD(FORTRAN_SUBMODULE_FILE);
 
   BLOCK(INPUT_FILES_BLOCK);
   RECORD(INPUT_FILE);
@@ -990,8 +992,8 @@ adjustFilenameForRelocatablePCH(const char *Filename, StringRef isysroot) {
 }
 
 /// \brief Write the control block.
-void ASTWriter::WriteControlBlock(Preprocessor &PP, ASTContext &Context,
-                                  StringRef isysroot,
+void ASTWriter::WriteControlBlock(Sema &SemaRef, Preprocessor &PP,
+                                  ASTContext &Context, StringRef isysroot,
                                   const std::string &OutputFile) {
   using namespace llvm;
   Stream.EnterSubblock(CONTROL_BLOCK_ID, 5);
@@ -1202,6 +1204,24 @@ void ASTWriter::WriteControlBlock(Preprocessor &PP, ASTContext &Context,
     Stream.EmitRecordWithBlob(AbbrevCode, Record, origDir);
   }
 
+  // Fortran module interface hashes.  These let a build tool tell whether
+  // the programs that use a module need to be recompiled, without reading
+  // more than the control block.
+  if (WritingFortranModuleFile) {
+    Record.clear();
+    for (unsigned I = 0, N = SemaRef.FortranModules.size(); I != N; ++I) {
+      NamespaceDecl *Module = SemaRef.FortranModules[I];
+      AddString(Module->getName(), Record);
+      Record.push_back(SemaRef.FortranModuleInterfaceHashes.lookup(Module));
+    }
+    Stream.EmitRecord(FORTRAN_MODULE_INTERFACES, Record);
+
+    if (WritingFortranSubmoduleFile) {
+      Record.clear();
+      Stream.EmitRecord(FORTRAN_SUBMODULE_FILE, Record);
+    }
+  }
+
   WriteInputFiles(Context.SourceMgr, isysroot);
   Stream.ExitBlock();
 }
@@ -2731,7 +2751,8 @@ public:
       for (IdentifierResolver::iterator D = IdResolver.begin(II),
                                      DEnd = IdResolver.end();
            D != DEnd; ++D)
-        DataLen += sizeof(DeclID);
+        if (Writer.isWrittenProgramScopeDecl(*D))
+          DataLen += sizeof(DeclID);
     }
     lfort::io::Emit16(Out, DataLen);
     // We emit the key length after the data length so that every
@@ -2791,7 +2812,8 @@ public:
     for (SmallVector<Decl *, 16>::reverse_iterator D = Decls.rbegin(),
                                                 DEnd = Decls.rend();
          D != DEnd; ++D)
-      lfort::io::Emit32(Out, Writer.getDeclID(*D));
+      if (Writer.isWrittenProgramScopeDecl(*D))
+        lfort::io::Emit32(Out, Writer.getDeclID(*D));
   }
 };
 } // end anonymous namespace
@@ -3105,6 +3127,15 @@ void ASTWriter::WriteDeclContextVisibleUpdate(const DeclContext *DC) {
        D != DEnd; ++D) {
     DeclarationName Name = D->first;
     DeclContext::lookup_result Result = D->second.getLookupResult();
+    if (DC->isProgram()) {
+      bool AllWritten = true;
+      for (DeclContext::lookup_iterator I = Result.begin(), E = Result.end();
+           I != E && AllWritten; ++I)
+        AllWritten = isWrittenProgramScopeDecl(*I);
+      if (!AllWritten)
+        continue;
+    }
+
     // For any name that appears in this table, the results are complete, i.e.
     // they overwrite results from previous PCHs. Merging is always a mess.
     if (!Result.empty())
@@ -3347,7 +3378,8 @@ void ASTWriter::SetSelectorOffset(Selector Sel, uint32_t Offset) {
 ASTWriter::ASTWriter(llvm::BitstreamWriter &Stream)
   : Stream(Stream), Context(0), PP(0), Chain(0), WritingPCModule(0),
     WritingAST(false), DoneWritingDeclsAndTypes(false),
-    ASTHasCompilerErrors(false),
+    ASTHasCompilerErrors(false), WritingFortranModuleFile(false),
+    WritingFortranSubmoduleFile(false),
     FirstDeclID(NUM_PREDEF_DECL_IDS), NextDeclID(FirstDeclID),
     FirstTypeID(NUM_PREDEF_TYPE_IDS), NextTypeID(FirstTypeID),
     FirstIdentID(NUM_PREDEF_IDENT_IDS), NextIdentID(FirstIdentID),
@@ -3402,6 +3434,12 @@ void ASTWriter::WriteAST(Sema &SemaRef,
   WritingAST = false;
 }
 
+bool ASTWriter::isWrittenProgramScopeDecl(const Decl *D) const {
+  // A Fortran module is a namespace; the rest of the program stays out of
+  // its module file.
+  return !WritingFortranModuleFile || isa<NamespaceDecl>(D);
+}
+
 template<typename Vector>
 static void AddLazyVectorDecls(ASTWriter &Writer, Vector &Vec,
                                ASTWriter::RecordData &Record) {
@@ -3469,13 +3507,19 @@ void ASTWriter::WriteASTCore(Sema &SemaRef,
   // Build a record containing all of the tentative definitions in this file, in
   // TentativeDefinitions order.  Generally, this record will be empty for
   // headers.
+  //
+  // A Fortran module file leaves out these records, and the others that refer
+  // to the program rather than to its modules.
   RecordData TentativeDefinitions;
-  AddLazyVectorDecls(*this, SemaRef.TentativeDefinitions, TentativeDefinitions);
+  if (!WritingFortranModuleFile)
+    AddLazyVectorDecls(*this, SemaRef.TentativeDefinitions,
+                       TentativeDefinitions);
   
   // Build a record containing all of the file scoped decls in this file.
   RecordData UnusedFileScopedDecls;
-  AddLazyVectorDecls(*this, SemaRef.UnusedFileScopedDecls, 
-                     UnusedFileScopedDecls);
+  if (!WritingFortranModuleFile)
+    AddLazyVectorDecls(*this, SemaRef.UnusedFileScopedDecls, 
+                       UnusedFileScopedDecls);
 
   // Build a record containing all of the delegating constructors we still need
   // to resolve.
@@ -3506,7 +3550,7 @@ void ASTWriter::WriteASTCore(Sema &SemaRef,
   for (llvm::DenseMap<DeclarationName, NamedDecl *>::iterator
          TD = SemaRef.LocallyScopedExternalDecls.begin(),
          TDEnd = SemaRef.LocallyScopedExternalDecls.end();
-       TD != TDEnd; ++TD) {
+       TD != TDEnd && !WritingFortranModuleFile; ++TD) {
     if (!TD->second->isFromASTFile())
       AddDeclRef(TD->second, LocallyScopedExternalDecls);
   }
@@ -3563,7 +3607,7 @@ void ASTWriter::WriteASTCore(Sema &SemaRef,
   }
 
   // Write the control block
-  WriteControlBlock(PP, Context, isysroot, OutputFile);
+  WriteControlBlock(SemaRef, PP, Context, isysroot, OutputFile);
 
   // Write the remaining AST contents.
   RecordData Record;
@@ -3582,7 +3626,7 @@ void ASTWriter::WriteASTCore(Sema &SemaRef,
   for (DeclContext::decl_iterator I = Pgm->noload_decls_begin(),
                                   E = Pgm->noload_decls_end();
        I != E; ++I) {
-    if (!(*I)->isFromASTFile())
+    if (!(*I)->isFromASTFile() && isWrittenProgramScopeDecl(*I))
       NewGlobalDecls.push_back(std::make_pair((*I)->getKind(), GetDeclRef(*I)));
   }
   
@@ -3704,7 +3748,9 @@ void ASTWriter::WriteASTCore(Sema &SemaRef,
     Stream.EmitRecordWithBlob(PCModuleOffsetMapAbbrev, Record,
                               Buffer.data(), Buffer.size());
   }
-  WritePreprocessor(PP, WritingPCModule != 0);
+  // Like a precompiled module, a Fortran module file only exports the macros
+  // that were made public.
+  WritePreprocessor(PP, WritingPCModule != 0 || WritingFortranModuleFile);
   WriteHeaderSearch(PP.getHeaderSearchInfo(), isysroot);
   WriteSelectors(SemaRef);
   WriteReferencedSelectorsPool(SemaRef);
@@ -1758,6 +1758,10 @@ void ASTWriter::WriteDecl(ASTContext &Context, Decl *D) {
   // AST file later.
   //
   // FIXME: This should be renamed, the predicate is much more complicated.
-  if (isRequiredDecl(D, Context))
+  //
+  // A Fortran module file has none: the definitions of module entities are
+  // emitted with the module itself, and the programs that use the module read
+  // entities only when they refer to them.
+  if (!WritingFortranModuleFile && isRequiredDecl(D, Context))
     ExternalDefinitions.push_back(ID);
 }
@@ -170,6 +170,24 @@ void ASTStmtWriter::VisitForStmt(ForStmt *S) {
   Code = serialization::STMT_FOR;
 }
 
+void ASTStmtWriter::VisitDoConcurrentStmt(DoConcurrentStmt *S) {
+  VisitStmt(S);
+  Record.push_back(S->getNumIndices());
+  Writer.AddStmt(S->getIndexDeclStmt());
+  for (unsigned I = 0, N = S->getNumIndices(); I != N; ++I) {
+    Writer.AddStmt(S->getLower(I));
+    Writer.AddStmt(S->getUpper(I));
+    Writer.AddStmt(S->getStep(I));
+  }
+  Writer.AddStmt(S->getMask());
+  Writer.AddStmt(S->getBody());
+  Writer.AddSourceLocation(S->getDoLoc(), Record);
+  Writer.AddSourceLocation(S->getLParenLoc(), Record);
+  Writer.AddSourceLocation(S->getRParenLoc(), Record);
+  Writer.AddSourceLocation(S->getEndLoc(), Record);
+  Code = serialization::STMT_DO_CONCURRENT;
+}
+
 void ASTStmtWriter::VisitGotoStmt(GotoStmt *S) {
   VisitStmt(S);
   Writer.AddDeclRef(S->getLabel(), Record);
@@ -0,0 +1,126 @@
+//===--- GenerateFortranModule.cpp - Writing Fortran module files ---------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+//  This file defines the FortranModuleFileGenerator, a SemaConsumer that
+//  writes the module or submodule files of the Fortran modules and
+//  submodules defined in a program.
+//
+//===----------------------------------------------------------------------===//
+
+#include "lfort/Serialization/ASTWriter.h"
+#include "lfort/AST/ASTConsumer.h"
+#include "lfort/AST/ASTContext.h"
+#include "lfort/Lex/Preprocessor.h"
+#include "lfort/Sema/Sema.h"
+#include "lfort/Sema/SemaConsumer.h"
+#include "lfort/Serialization/SerializationDiagnostic.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Bitcode/BitstreamWriter.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Support/system_error.h"
+#include <string>
+
+using namespace lfort;
+
+FortranModuleFileGenerator::FortranModuleFileGenerator(const Preprocessor &PP,
+                                                       StringRef OutputDir,
+                                                       bool SubmoduleFiles)
+  : PP(PP), OutputDir(OutputDir.str()), SubmoduleFiles(SubmoduleFiles),
+    SemaPtr(0), Stream(Buffer), Writer(Stream) {
+  Writer.setWritingFortranModuleFile(true);
+  Writer.setWritingFortranSubmoduleFile(SubmoduleFiles);
+}
+
+FortranModuleFileGenerator::~FortranModuleFileGenerator() {
+}
+
+/// \brief Write \p Contents to \p Path through a temporary file, so that a
+/// concurrent reader never sees a partially written module file.
+static llvm::error_code writeFileAtomically(StringRef Path,
+                                            ArrayRef<char> Contents) {
+  SmallString<128> TempPath(Path);
+  TempPath += "-%%%%%%%%";
+  int FD;
+  if (llvm::error_code EC = llvm::sys::fs::unique_file(TempPath.str(), FD,
+                                                       TempPath,
+                                                       /*makeAbsolute=*/false,
+                                                       0664))
+    return EC;
+
+  {
+    llvm::raw_fd_ostream Out(FD, /*shouldClose=*/true);
+    Out.write(Contents.data(), Contents.size());
+    Out.close();
+    if (Out.has_error()) {
+      Out.clear_error();
+      bool Existed;
+      llvm::sys::fs::remove(TempPath.str(), Existed);
+      return llvm::make_error_code(llvm::errc::io_error);
+    }
+  }
+
+  llvm::error_code EC = llvm::sys::fs::rename(TempPath.str(), Path);
+  if (EC) {
+    bool Existed;
+    llvm::sys::fs::remove(TempPath.str(), Existed);
+  }
+  return EC;
+}
+
+void FortranModuleFileGenerator::HandleProgram(ASTContext &Ctx) {
+  assert(SemaPtr && "No Sema?");
+  if (PP.getDiagnostics().hasErrorOccurred())
+    return;
+
+  // Submodules cannot be used, so they only get submodule files.  Their
+  // namespaces are already named "module@submodule".
+  SmallVector<NamespaceDecl *, 4> Modules(SemaPtr->FortranModules.begin(),
+                                          SemaPtr->FortranModules.end());
+  if (SubmoduleFiles)
+    Modules.append(SemaPtr->FortranSubmodules.begin(),
+                   SemaPtr->FortranSubmodules.end());
+  if (Modules.empty())
+    return;
+
+  SmallVector<std::string, 4> Paths;
+  for (unsigned I = 0, N = Modules.size(); I != N; ++I) {
+    SmallString<128> Path(OutputDir.empty() ? "." : OutputDir);
+    llvm::sys::path::append(Path, Modules[I]->getName().lower() +
+                                  (SubmoduleFiles ? ".smod" : ".mod"));
+    Paths.push_back(Path.str());
+  }
+
+  // All of the modules defined by the program share one AST file, which is
+  // stored under the name of each of them.
+  Writer.WriteAST(*SemaPtr, Paths.front(), /*WritingPCModule=*/0,
+                  /*isysroot=*/"");
+
+  for (unsigned I = 0, N = Paths.size(); I != N; ++I)
+    if (llvm::error_code EC = writeFileAtomically(Paths[I], Buffer))
+      PP.getDiagnostics().Report(diag::err_fe_unable_to_write_module_file)
+        << Paths[I] << EC.message();
+
+  // Free up some memory, in case the process is kept alive.
+  Buffer.clear();
+}
+
+PPMutationListener *FortranModuleFileGenerator::GetPPMutationListener() {
+  return &Writer;
+}
+
+ASTMutationListener *FortranModuleFileGenerator::GetASTMutationListener() {
+  return &Writer;
+}
+
+ASTDeserializationListener *
+FortranModuleFileGenerator::GetASTDeserializationListener() {
+  return &Writer;
+}
@@ -21,7 +21,7 @@ using namespace serialization;
 using namespace reader;
 
 PCModuleFile::PCModuleFile(PCModuleKind Kind, unsigned Generation)
-  : Kind(Kind), File(0), DirectlyImported(false),
+  : Kind(Kind), FortranSubmoduleFile(false), File(0), DirectlyImported(false),
     Generation(Generation), SizeInBits(0),
     LocalNumSLocEntries(0), SLocEntryBaseID(0),
     SLocEntryBaseOffset(0), SLocEntryOffsets(0),
@@ -51,6 +51,9 @@ const char *const CommonOptionsParser::HelpMessage =
     "\tworking directory. \"./\" prefixes in the relative files will be\n"
     "\tautomatically removed, but the rest of a relative path must be a\n"
     "\tsuffix of a path in the compile command database.\n"
+    "\n"
+    "-j <N> processes up to N source files at the same time. Messages for\n"
+    "\teach file are still printed in the order of the files.\n"
     "\n";
 
 CommonOptionsParser::CommonOptionsParser(int &argc, const char **argv) {
@@ -60,10 +63,15 @@ CommonOptionsParser::CommonOptionsParser(int &argc, const char **argv) {
   static cl::list<std::string> SourcePaths(
       cl::Positional, cl::desc("<source0> [... <sourceN>]"), cl::OneOrMore);
 
+  static cl::opt<unsigned> Jobs(
+      "j", cl::desc("Number of source files to process in parallel"),
+      cl::init(1), cl::Prefix);
+
   Compilations.reset(FixedCompilationDatabase::loadFromCommandLine(argc,
                                                                    argv));
   cl::ParseCommandLineOptions(argc, argv);
   SourcePathList = SourcePaths;
+  NumThreads = Jobs ? Jobs : 1;
   if (!Compilations) {
     std::string ErrorMessage;
     if (!BuildPath.empty()) {
@@ -22,8 +22,11 @@
 #include "lfort/Tooling/ArgumentsAdjusters.h"
 #include "lfort/Tooling/CompilationDatabase.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/Config/llvm-config.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/Host.h"
+#include "llvm/Support/Mutex.h"
+#include "llvm/Support/Threading.h"
 #include "llvm/Support/raw_ostream.h"
 
 // For chdir, see the comment in LFortTool::run for more information.
@@ -33,6 +36,10 @@
 #  include <unistd.h>
 #endif
 
+#ifdef LLVM_ON_UNIX
+#  include <pthread.h>
+#endif
+
 namespace lfort {
 namespace tooling {
 
@@ -145,7 +152,8 @@ std::string getAbsolutePath(StringRef File) {
 ToolInvocation::ToolInvocation(
     ArrayRef<std::string> CommandLine, FrontendAction *ToolAction,
     FileManager *Files)
-    : CommandLine(CommandLine.vec()), ToolAction(ToolAction), Files(Files) {
+    : CommandLine(CommandLine.vec()), ToolAction(ToolAction), Files(Files),
+      DiagnosticStream(0) {
 }
 
 void ToolInvocation::mapVirtualFile(StringRef FilePath, StringRef Content) {
@@ -161,7 +169,7 @@ bool ToolInvocation::run() {
   const char *const BinaryName = Argv[0];
   IntrusiveRefCntPtr<DiagnosticOptions> DiagOpts = new DiagnosticOptions();
   TextDiagnosticPrinter DiagnosticPrinter(
-      llvm::errs(), &*DiagOpts);
+      DiagnosticStream ? *DiagnosticStream : llvm::errs(), &*DiagOpts);
   DiagnosticsEngine Diagnostics(
     llvm::IntrusiveRefCntPtr<lfort::DiagnosticIDs>(new DiagnosticIDs()),
     &*DiagOpts, &DiagnosticPrinter, false);
@@ -188,11 +196,13 @@ bool ToolInvocation::runInvocation(
     lfort::driver::Compilation *Compilation,
     lfort::CompilerInvocation *Invocation,
     const lfort::driver::ArgStringList &CC1Args) {
+  raw_ostream &DiagOS = DiagnosticStream ? *DiagnosticStream : llvm::errs();
+
   // Show the invocation, with -v.
   if (Invocation->getHeaderSearchOpts().Verbose) {
-    llvm::errs() << "lfort Invocation:\n";
-    Compilation->PrintJob(llvm::errs(), Compilation->getJobs(), "\n", true);
-    llvm::errs() << "\n";
+    DiagOS << "lfort Invocation:\n";
+    Compilation->PrintJob(DiagOS, Compilation->getJobs(), "\n", true);
+    DiagOS << "\n";
   }
 
   // Create a compiler instance to handle the actual work.
@@ -207,8 +217,17 @@ bool ToolInvocation::runInvocation(
   llvm::OwningPtr<FrontendAction> ScopedToolAction(ToolAction.take());
 
   // Create the compilers actual diagnostics engine.
-  Compiler.createDiagnostics(CC1Args.size(),
-                             const_cast<char**>(CC1Args.data()));
+  if (DiagnosticStream)
+    Compiler.createDiagnostics(CC1Args.size(),
+                               const_cast<char**>(CC1Args.data()),
+                               new TextDiagnosticPrinter(
+                                 *DiagnosticStream,
+                                 &Compiler.getDiagnosticOpts()),
+                               /*ShouldOwnClient=*/true,
+                               /*ShouldCloneClient=*/false);
+  else
+    Compiler.createDiagnostics(CC1Args.size(),
+                               const_cast<char**>(CC1Args.data()));
   if (!Compiler.hasDiagnostics())
     return false;
 
@@ -239,7 +258,7 @@ void ToolInvocation::addFileMappingsTo(SourceManager &Sources) {
 LFortTool::LFortTool(const CompilationDatabase &Compilations,
                      ArrayRef<std::string> SourcePaths)
     : Files((FileSystemOptions())),
-      ArgsAdjuster(new LFortSyntaxOnlyAdjuster()) {
+      ArgsAdjuster(new LFortSyntaxOnlyAdjuster()), NumThreads(1) {
   for (unsigned I = 0, E = SourcePaths.size(); I != E; ++I) {
     llvm::SmallString<1024> File(getAbsolutePath(SourcePaths[I]));
 
@@ -269,6 +288,108 @@ void LFortTool::setArgumentsAdjuster(ArgumentsAdjuster *Adjuster) {
   ArgsAdjuster.reset(Adjuster);
 }
 
+bool LFortTool::runCommand(unsigned Index, const std::string &MainExecutable,
+                           FrontendAction *Action, FileManager &CommandFiles,
+                           raw_ostream &Out, raw_ostream &DiagOut) {
+  const std::string &File = CompileCommands[Index].first;
+  std::vector<std::string> CommandLine =
+    ArgsAdjuster->Adjust(CompileCommands[Index].second.CommandLine);
+  assert(!CommandLine.empty());
+  CommandLine[0] = MainExecutable;
+  Out << "Processing: " << File << ".\n";
+  ToolInvocation Invocation(CommandLine, Action, &CommandFiles);
+  Invocation.setDiagnosticStream(&DiagOut);
+  for (int I = 0, E = MappedFileContents.size(); I != E; ++I) {
+    Invocation.mapVirtualFile(MappedFileContents[I].first,
+                              MappedFileContents[I].second);
+  }
+  if (!Invocation.run()) {
+    Out << "Error while processing " << File << ".\n";
+    return false;
+  }
+  return true;
+}
+
+#ifdef LLVM_ON_UNIX
+/// \brief Hands out the compile commands of a LFortTool to worker threads
+/// and prints their results in order.
+struct ToolWorkQueue {
+  ToolWorkQueue(LFortTool &Tool, const std::string &MainExecutable,
+                FrontendActionFactory *ActionFactory)
+    : Tool(Tool), MainExecutable(MainExecutable),
+      ActionFactory(ActionFactory), NextCommand(0), NextToPrint(0),
+      Results(Tool.CompileCommands.size()), Failed(false) {}
+
+  /// \brief The output of one compile command, held until all earlier
+  /// commands have been printed.
+  struct Result {
+    Result() : Done(false) {}
+    std::string Out;
+    std::string DiagOut;
+    bool Done;
+  };
+
+  LFortTool &Tool;
+  const std::string &MainExecutable;
+  FrontendActionFactory *ActionFactory;
+
+  /// \brief Guards everything below, and the action factory.
+  llvm::sys::Mutex Lock;
+  unsigned NextCommand;
+  unsigned NextToPrint;
+  std::vector<Result> Results;
+  bool Failed;
+
+  static void *runWorker(void *Queue) {
+    static_cast<ToolWorkQueue *>(Queue)->work();
+    return 0;
+  }
+
+  void work() {
+    while (true) {
+      unsigned Index;
+      FrontendAction *Action;
+      {
+        llvm::sys::ScopedLock Guard(Lock);
+        if (NextCommand == Results.size())
+          return;
+        Index = NextCommand++;
+        Action = ActionFactory->create();
+      }
+
+      // Relative paths in the command are resolved by the FileManager
+      // against the command's directory.
+      FileSystemOptions FileSystemOpts;
+      FileSystemOpts.WorkingDir = Tool.CompileCommands[Index].second.Directory;
+      FileManager CommandFiles(FileSystemOpts);
+
+      Result Res;
+      bool Success;
+      {
+        llvm::raw_string_ostream Out(Res.Out), DiagOut(Res.DiagOut);
+        Success = Tool.runCommand(Index, MainExecutable, Action, CommandFiles,
+                                  Out, DiagOut);
+      }
+
+      llvm::sys::ScopedLock Guard(Lock);
+      Results[Index].Out.swap(Res.Out);
+      Results[Index].DiagOut.swap(Res.DiagOut);
+      Results[Index].Done = true;
+      Failed |= !Success;
+      for (; NextToPrint != Results.size() && Results[NextToPrint].Done;
+           ++NextToPrint) {
+        Result &Next = Results[NextToPrint];
+        llvm::outs() << Next.Out;
+        llvm::outs().flush();
+        llvm::errs() << Next.DiagOut;
+        std::string().swap(Next.Out);
+        std::string().swap(Next.DiagOut);
+      }
+    }
+  }
+};
+#endif
+
 int LFortTool::run(FrontendActionFactory *ActionFactory) {
   // Exists solely for the purpose of lookup of the resource path.
   // This just needs to be some symbol in the binary.
@@ -281,33 +402,50 @@ int LFortTool::run(FrontendActionFactory *ActionFactory) {
   std::string MainExecutable =
     llvm::sys::Path::GetMainExecutable("lfort_tool", &StaticSymbol).str();
 
+#ifdef LLVM_ON_UNIX
+  unsigned NumWorkers = std::min<size_t>(NumThreads, CompileCommands.size());
+  if (NumWorkers > 1 && llvm::llvm_start_multithreaded()) {
+    ToolWorkQueue Queue(*this, MainExecutable, ActionFactory);
+
+    // Parsing recurses deeply, so give the workers the same stack as the
+    // main thread usually has.
+    pthread_attr_t Attr;
+    pthread_attr_init(&Attr);
+    pthread_attr_setstacksize(&Attr, 8 << 20);
+    std::vector<pthread_t> Workers;
+    for (unsigned I = 0; I != NumWorkers; ++I) {
+      pthread_t Worker;
+      if (pthread_create(&Worker, &Attr, &ToolWorkQueue::runWorker, &Queue))
+        break;
+      Workers.push_back(Worker);
+    }
+    pthread_attr_destroy(&Attr);
+
+    // If no thread could be started, do the work here.
+    if (Workers.empty())
+      Queue.work();
+    for (unsigned I = 0, E = Workers.size(); I != E; ++I)
+      pthread_join(Workers[I], 0);
+    return Queue.Failed ? 1 : 0;
+  }
+#endif
+
   bool ProcessingFailed = false;
   for (unsigned I = 0; I < CompileCommands.size(); ++I) {
-    std::string File = CompileCommands[I].first;
     // FIXME: chdir is thread hostile; on the other hand, creating the same
     // behavior as chdir is complex: chdir resolves the path once, thus
     // guaranteeing that all subsequent relative path operations work
     // on the same path the original chdir resulted in. This makes a difference
     // for example on network filesystems, where symlinks might be switched
     // during runtime of the tool. Fixing this depends on having a file system
-    // abstraction that allows openat() style interactions.
+    // abstraction that allows openat() style interactions.  Running on
+    // several threads uses FileSystemOptions::WorkingDir instead.
     if (chdir(CompileCommands[I].second.Directory.c_str()))
       llvm::report_fatal_error("Cannot chdir into \"" +
                                CompileCommands[I].second.Directory + "\n!");
-    std::vector<std::string> CommandLine =
-      ArgsAdjuster->Adjust(CompileCommands[I].second.CommandLine);
-    assert(!CommandLine.empty());
-    CommandLine[0] = MainExecutable;
-    llvm::outs() << "Processing: " << File << ".\n";
-    ToolInvocation Invocation(CommandLine, ActionFactory->create(), &Files);
-    for (int I = 0, E = MappedFileContents.size(); I != E; ++I) {
-      Invocation.mapVirtualFile(MappedFileContents[I].first,
-                                MappedFileContents[I].second);
-    }
-    if (!Invocation.run()) {
-      llvm::outs() << "Error while processing " << File << ".\n";
+    if (!runCommand(I, MainExecutable, ActionFactory->create(), Files,
+                    llvm::outs(), llvm::errs()))
       ProcessingFailed = true;
-    }
   }
   return ProcessingFailed ? 1 : 0;
 }
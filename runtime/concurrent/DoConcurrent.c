@@ -0,0 +1,205 @@
+/*===- DoConcurrent.c - Thread pool for DO CONCURRENT constructs ----------===*\
+|*
+|*                     The LLVM Compiler Infrastructure
+|*
+|* This file is distributed under the University of Illinois Open Source
+|* License. See LICENSE.TXT for details.
+|*
+|*===----------------------------------------------------------------------===*|
+|*
+|* With -fparallel-do-concurrent, the outermost loop of a DO CONCURRENT
+|* construct is outlined into a function that runs a range of its iterations,
+|* and the construct becomes a call to __lfort_do_concurrent.  The iterations
+|* are divided evenly among the threads of a pool; a thread that runs out of
+|* iterations steals half of what is left to another, so uneven iterations
+|* still keep every thread busy.
+|*
+|* The pool has LFORT_NUM_THREADS threads, or one per online processor,
+|* including the calling thread.  Constructs nested in a parallel one, and
+|* constructs started while another is running, run on the calling thread.
+|*
+\*===----------------------------------------------------------------------===*/
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+typedef void (*ConcurrentFn)(void *Ctx, int64_t Begin, int64_t End);
+
+/* The iterations [Begin, End) not yet claimed from one thread's share.  The
+ * padding keeps the shares of different threads on different cache lines. */
+typedef struct {
+  pthread_mutex_t Lock;
+  int64_t Begin;
+  int64_t End;
+  char Pad[64];
+} Share;
+
+static pthread_once_t PoolOnce = PTHREAD_ONCE_INIT;
+static unsigned NumThreads = 1;
+static Share *Shares;
+
+/* Only one construct runs on the pool at a time. */
+static pthread_mutex_t RunLock = PTHREAD_MUTEX_INITIALIZER;
+
+/* The construct being run, published to the workers under PoolLock by
+ * bumping Generation.  The caller waits until Active drops to zero. */
+static pthread_mutex_t PoolLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t WorkReady = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t WorkDone = PTHREAD_COND_INITIALIZER;
+static ConcurrentFn CurFn;
+static void *CurCtx;
+static unsigned long Generation;
+static unsigned Active;
+
+/* Whether this thread is running iterations of a construct. */
+static __thread int InConstruct;
+
+/* Claim the next chunk of the share of thread Id: a quarter of what is
+ * left, and at least one iteration. */
+static int claim(unsigned Id, int64_t *Begin, int64_t *End) {
+  Share *S = &Shares[Id];
+  int64_t Chunk;
+  int Found = 0;
+  pthread_mutex_lock(&S->Lock);
+  if (S->Begin < S->End) {
+    Chunk = (S->End - S->Begin) / 4;
+    if (Chunk < 1)
+      Chunk = 1;
+    *Begin = S->Begin;
+    *End = S->Begin + Chunk;
+    S->Begin = *End;
+    Found = 1;
+  }
+  pthread_mutex_unlock(&S->Lock);
+  return Found;
+}
+
+/* Move the upper half of the iterations left in another thread's share to
+ * the share of thread Id. */
+static int steal(unsigned Id) {
+  unsigned I;
+  for (I = 1; I != NumThreads; ++I) {
+    Share *Victim = &Shares[(Id + I) % NumThreads];
+    int64_t Begin = 0, End = 0;
+    pthread_mutex_lock(&Victim->Lock);
+    if (Victim->Begin < Victim->End) {
+      Begin = Victim->Begin + (Victim->End - Victim->Begin) / 2;
+      End = Victim->End;
+      Victim->End = Begin;
+    }
+    pthread_mutex_unlock(&Victim->Lock);
+
+    if (Begin < End) {
+      pthread_mutex_lock(&Shares[Id].Lock);
+      Shares[Id].Begin = Begin;
+      Shares[Id].End = End;
+      pthread_mutex_unlock(&Shares[Id].Lock);
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/* Run iterations as thread Id until none are left anywhere. */
+static void runIterations(unsigned Id) {
+  int64_t Begin, End;
+  for (;;) {
+    while (claim(Id, &Begin, &End))
+      CurFn(CurCtx, Begin, End);
+    if (!steal(Id))
+      return;
+  }
+}
+
+static void *workerMain(void *Arg) {
+  unsigned Id = (unsigned)(uintptr_t)Arg;
+  unsigned long Seen = 0;
+
+  InConstruct = 1;
+  pthread_mutex_lock(&PoolLock);
+  for (;;) {
+    while (Generation == Seen)
+      pthread_cond_wait(&WorkReady, &PoolLock);
+    Seen = Generation;
+    pthread_mutex_unlock(&PoolLock);
+
+    runIterations(Id);
+
+    pthread_mutex_lock(&PoolLock);
+    if (--Active == 0)
+      pthread_cond_signal(&WorkDone);
+  }
+  return 0;
+}
+
+static void startPool(void) {
+  const char *Env = getenv("LFORT_NUM_THREADS");
+  long Count = Env ? atol(Env) : 0;
+  unsigned Requested, I;
+
+  if (Count <= 0)
+    Count = sysconf(_SC_NPROCESSORS_ONLN);
+  Requested = Count > 0 ? (unsigned)Count : 1;
+
+  Shares = calloc(Requested, sizeof(Share));
+  if (!Shares)
+    return;
+  for (I = 0; I != Requested; ++I)
+    pthread_mutex_init(&Shares[I].Lock, 0);
+
+  /* Thread 0 is the thread that starts each construct. */
+  NumThreads = 1;
+  for (I = 1; I != Requested; ++I) {
+    pthread_t Thread;
+    if (pthread_create(&Thread, 0, workerMain, (void *)(uintptr_t)I))
+      break;
+    pthread_detach(Thread);
+    ++NumThreads;
+  }
+}
+
+void __lfort_do_concurrent(ConcurrentFn Fn, void *Ctx, int64_t N) {
+  unsigned I;
+
+  if (N <= 0)
+    return;
+  if (N == 1 || InConstruct) {
+    Fn(Ctx, 0, N);
+    return;
+  }
+
+  pthread_once(&PoolOnce, startPool);
+  if (NumThreads == 1 || pthread_mutex_trylock(&RunLock)) {
+    Fn(Ctx, 0, N);
+    return;
+  }
+
+  /* Every worker has finished the previous construct, so the shares can be
+   * set up before the workers are woken. */
+  for (I = 0; I != NumThreads; ++I) {
+    int64_t Extra = N % NumThreads;
+    Shares[I].Begin = N / NumThreads * I + (I < Extra ? I : Extra);
+    Shares[I].End = Shares[I].Begin + N / NumThreads + (I < Extra);
+  }
+
+  pthread_mutex_lock(&PoolLock);
+  CurFn = Fn;
+  CurCtx = Ctx;
+  Active = NumThreads - 1;
+  ++Generation;
+  pthread_cond_broadcast(&WorkReady);
+  pthread_mutex_unlock(&PoolLock);
+
+  InConstruct = 1;
+  runIterations(0);
+  InConstruct = 0;
+
+  pthread_mutex_lock(&PoolLock);
+  while (Active)
+    pthread_cond_wait(&WorkDone, &PoolLock);
+  pthread_mutex_unlock(&PoolLock);
+
+  pthread_mutex_unlock(&RunLock);
+}
@@ -0,0 +1,12 @@
+! RUN: %lfort_cc1 -emit-pth -o %t.pth %s
+! RUN: %lfort_cc1 -token-cache %t.pth -E %s -o - | FileCheck %s
+!
+! Keywords and dot-operators have token kinds that do not fit in a byte.
+include 'fortran-include-keywords.inc'
+! CHECK: subroutine step(x, ok)
+! CHECK: use iso_c_binding
+! CHECK: real :: x
+! CHECK: logical :: ok
+! CHECK: ok = ok .and. x > 0.0
+! CHECK: rewind 10
+! CHECK: end subroutine
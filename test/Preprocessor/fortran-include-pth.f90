@@ -0,0 +1,16 @@
+! RUN: %lfort_cc1 -emit-pth -o %t.pth %s
+! RUN: %lfort_cc1 -token-cache %t.pth -E %s -o - | FileCheck %s
+!
+! The same sources under a different path are found by their contents.
+! RUN: rm -rf %t.dir && mkdir %t.dir
+! RUN: cp %s %t.dir/copy.f90 && cp %S/fortran-include.inc %t.dir
+! RUN: %lfort_cc1 -token-cache %t.pth -E %t.dir/copy.f90 -o - | FileCheck %s
+program test
+include 'fortran-include.inc'
+! CHECK: included file
+10 continue
+! CHECK: {{^10 continue}}
+INCLUDE 'fortran-include.inc'
+! CHECK: included file
+end program
+! CHECK: end program
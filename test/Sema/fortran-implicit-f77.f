@@ -0,0 +1,7 @@
+C RUN: %lfort_cc1 -fsyntax-only %s
+C Undeclared variables get their implicit types in F77 mode too.
+      program f77
+      i = 1
+      x = 2.5
+      y = x * i
+      end
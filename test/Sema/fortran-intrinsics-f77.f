@@ -0,0 +1,9 @@
+C RUN: %lfort_cc1 -triple x86_64-apple-darwin -fsyntax-only %s
+C Intrinsic procedures resolve in F77 mode too.
+      program f77
+      integer i, j
+      real x
+      x = sqrt(x)
+      x = abs(x)
+      i = max(i, j, 3)
+      end
@@ -145,6 +145,7 @@ int main(int argc, const char **argv) {
   CommonOptionsParser OptionsParser(argc, argv);
   LFortTool Tool(OptionsParser.getCompilations(),
                  OptionsParser.getSourcePathList());
+  Tool.setNumThreads(OptionsParser.getNumThreads());
   if (Fixit)
     return Tool.run(newFrontendActionFactory<FixItAction>());
   lfort_check::LFortCheckActionFactory Factory;
@@ -125,6 +125,10 @@ CXCursor cxcursor::MakeCXCursor(Stmt *S, Decl *Parent, CXProgram Pgm,
   case Stmt::ForStmtClass:
     K = CXCursor_ForStmt;
     break;
+
+  case Stmt::DoConcurrentStmtClass:
+    K = CXCursor_UnexposedStmt;
+    break;
   
   case Stmt::GotoStmtClass:
     K = CXCursor_GotoStmt;
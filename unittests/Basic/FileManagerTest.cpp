@@ -10,6 +10,11 @@
 #include "lfort/Basic/FileManager.h"
 #include "lfort/Basic/FileSystemOptions.h"
 #include "lfort/Basic/FileSystemStatCache.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
 #include "gtest/gtest.h"
 
 using namespace llvm;
@@ -61,6 +66,20 @@ public:
   }
 };
 
+// Counts the lookups that get past the stat caches in front of it.
+class CountingStatCache : public FileSystemStatCache {
+public:
+  CountingStatCache() : NumStats(0) { }
+
+  unsigned NumStats;
+
+  virtual LookupResult getStat(const char *Path, struct stat &StatBuf,
+                               bool isFile, int *FileDescriptor) {
+    ++NumStats;
+    return statChained(Path, StatBuf, isFile, FileDescriptor);
+  }
+};
+
 // The test fixture.
 class FileManagerTest : public ::testing::Test {
  protected:
@@ -217,6 +236,90 @@ TEST_F(FileManagerTest, getFileReturnsSameFileEntryForAliasedVirtualFiles) {
   EXPECT_EQ(manager.getFile("abc/foo.cpp"), manager.getFile("abc/bar.cpp"));
 }
 
+// Lookups of files that are not in a directory's listing never reach the
+// file system, while files that are present are stat'ed as usual.
+TEST(DirectoryListingStatCacheTest, missingFilesAreNotStated) {
+  SmallString<128> Dir;
+  llvm::sys::path::system_temp_directory(/*erasedOnReboot=*/true, Dir);
+  llvm::sys::path::append(Dir, "lfort-dirlist-%%%%%%");
+  int FD;
+  ASSERT_FALSE(llvm::sys::fs::unique_file(Dir.str(), FD, Dir));
+  { llvm::raw_fd_ostream Closer(FD, /*shouldClose=*/true); }
+  bool Existed;
+  llvm::sys::fs::remove(Dir.str(), Existed);
+  ASSERT_FALSE(llvm::sys::fs::create_directory(Dir.str(), Existed));
+
+  SmallString<128> Present(Dir), Missing(Dir), InMissingDir(Dir);
+  llvm::sys::path::append(Present, "present.inc");
+  llvm::sys::path::append(Missing, "missing.inc");
+  llvm::sys::path::append(InMissingDir, "nodir", "missing.inc");
+  std::string ErrorInfo;
+  { llvm::raw_fd_ostream Out(Present.c_str(), ErrorInfo); Out << "x\n"; }
+  ASSERT_TRUE(ErrorInfo.empty());
+
+  DirectoryListingStatCache Cache;
+  CountingStatCache *Counter = new CountingStatCache;
+  Cache.setNextStatCache(Counter);
+  struct stat StatBuf;
+
+  EXPECT_TRUE(FileSystemStatCache::get(Missing.c_str(), StatBuf, true, 0,
+                                       &Cache));
+  EXPECT_TRUE(FileSystemStatCache::get(InMissingDir.c_str(), StatBuf, true, 0,
+                                       &Cache));
+  EXPECT_EQ(0u, Counter->NumStats);
+  EXPECT_FALSE(FileSystemStatCache::get(Present.c_str(), StatBuf, true, 0,
+                                        &Cache));
+  EXPECT_EQ(1u, Counter->NumStats);
+
+  // A file created after the directory was read is only found once the
+  // listing has been invalidated.
+  { llvm::raw_fd_ostream Out(Missing.c_str(), ErrorInfo); Out << "y\n"; }
+  EXPECT_TRUE(FileSystemStatCache::get(Missing.c_str(), StatBuf, true, 0,
+                                       &Cache));
+  Cache.invalidateDirectory(Dir.str());
+  EXPECT_FALSE(FileSystemStatCache::get(Missing.c_str(), StatBuf, true, 0,
+                                        &Cache));
+  EXPECT_EQ(2u, Counter->NumStats);
+
+  llvm::sys::fs::remove(Present.str(), Existed);
+  llvm::sys::fs::remove(Missing.str(), Existed);
+  llvm::sys::fs::remove(Dir.str(), Existed);
+}
+
+// Buffers for the same file obtained through different FileManagers share
+// one read-only mapping, which stays valid until the last buffer goes away.
+TEST(FileManagerMappingTest, sourceFilesShareMappings) {
+  SmallString<128> Path;
+  int FD;
+  ASSERT_FALSE(llvm::sys::fs::unique_file("lfort-mapped-%%%%%%.f", FD, Path));
+  {
+    llvm::raw_fd_ostream Out(FD, /*shouldClose=*/true);
+    for (unsigned I = 0; I != 1000; ++I)
+      Out << "      X = X + 1\n";
+  }
+
+  FileSystemOptions Opts;
+  Opts.MapSourceFiles = true;
+  FileManager FirstMgr(Opts), SecondMgr(Opts);
+  const FileEntry *FirstEntry = FirstMgr.getFile(Path.str());
+  const FileEntry *SecondEntry = SecondMgr.getFile(Path.str());
+  ASSERT_TRUE(FirstEntry != NULL);
+  ASSERT_TRUE(SecondEntry != NULL);
+
+  OwningPtr<llvm::MemoryBuffer> First(FirstMgr.getBufferForFile(FirstEntry));
+  OwningPtr<llvm::MemoryBuffer> Second(SecondMgr.getBufferForFile(SecondEntry));
+  ASSERT_TRUE(First && Second);
+  EXPECT_EQ(llvm::MemoryBuffer::MemoryBuffer_MMap, First->getBufferKind());
+  EXPECT_EQ(First->getBufferStart(), Second->getBufferStart());
+  EXPECT_EQ('\0', *First->getBufferEnd());
+
+  First.reset();
+  EXPECT_EQ(StringRef("      X = X + 1\n"), Second->getBuffer().substr(0, 16));
+
+  bool Existed;
+  llvm::sys::fs::remove(Path.str(), Existed);
+}
+
 #endif  // !_WIN32
 
 } // anonymous namespace
@@ -0,0 +1,156 @@
+//===- unittests/Basic/SourceManagerBenchmark.cpp - Line table benchmarks -===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// These tests ask for line and column numbers in a large synthetic Fortran
+// source and report the time taken, checking the answers against a plain
+// scan of the buffer.  Timings are only reported, never checked, so that the
+// tests stay deterministic.
+//
+//===----------------------------------------------------------------------===//
+
+#include "lfort/Basic/SourceManager.h"
+#include "lfort/Basic/Diagnostic.h"
+#include "lfort/Basic/DiagnosticOptions.h"
+#include "lfort/Basic/FileManager.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Timer.h"
+#include "llvm/Support/raw_ostream.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+using namespace lfort;
+
+namespace {
+
+// The test fixture.
+class SourceManagerBenchmark : public ::testing::Test {
+protected:
+  SourceManagerBenchmark()
+    : FileMgr(FileMgrOpts),
+      DiagID(new DiagnosticIDs()),
+      Diags(DiagID, new DiagnosticOptions, new IgnoringDiagConsumer()) {
+  }
+
+  /// \brief Build a fixed-form source of \p NumLines lines, recording the
+  /// offset at which each line starts.  Some lines end in "\r\n" and some
+  /// are tab-format.
+  static std::string buildSource(unsigned NumLines,
+                                 std::vector<unsigned> &LineStarts) {
+    std::string Source;
+    raw_string_ostream OS(Source);
+    for (unsigned I = 0; I != NumLines; ++I) {
+      OS.flush();
+      LineStarts.push_back(Source.size());
+      if (I % 97 == 0)
+        OS << "C     generated block " << I << '\n';
+      else if (I % 13 == 0)
+        OS << "\tX" << I % 10 << " = X" << I % 10 << " + 1.0D0\r\n";
+      else
+        OS << "      A(" << I % 1000 << ") = B(" << I % 1000
+           << ") * C + D\n";
+    }
+    OS.flush();
+    return Source;
+  }
+
+  static double elapsed(const TimeRecord &Start, const TimeRecord &End) {
+    return End.getWallTime() - Start.getWallTime();
+  }
+
+  FileSystemOptions FileMgrOpts;
+  FileManager FileMgr;
+  IntrusiveRefCntPtr<DiagnosticIDs> DiagID;
+  DiagnosticsEngine Diags;
+};
+
+TEST_F(SourceManagerBenchmark, LazyLineTable) {
+  const unsigned NumLines = 500000;
+  std::vector<unsigned> LineStarts;
+  std::string Source = buildSource(NumLines, LineStarts);
+
+  SourceManager SourceMgr(Diags, FileMgr);
+  FileID FID = SourceMgr.createMainFileIDForMemBuffer(
+                 MemoryBuffer::getMemBufferCopy(Source, "big.f"));
+
+  // A diagnostic near the top of the file only scans the first part of it.
+  TimeRecord Start = TimeRecord::getCurrentTime(/*Start=*/true);
+  EXPECT_EQ(11u, SourceMgr.getLineNumber(FID, LineStarts[10] + 3));
+  TimeRecord AfterFirst = TimeRecord::getCurrentTime(/*Start=*/false);
+  EXPECT_EQ(NumLines, SourceMgr.getLineNumber(FID, LineStarts.back()));
+  TimeRecord AfterLast = TimeRecord::getCurrentTime(/*Start=*/false);
+
+  // Walk the file as diagnostics and debug info would, in order.
+  unsigned NumQueries = 0;
+  for (unsigned I = 0; I < NumLines; I += 7, ++NumQueries)
+    ASSERT_EQ(I + 1, SourceMgr.getLineNumber(FID, LineStarts[I] + 1));
+  TimeRecord AfterWalk = TimeRecord::getCurrentTime(/*Start=*/false);
+
+  // Lines may also be asked for by number.
+  SourceLocation FileStart = SourceMgr.getLocForStartOfFile(FID);
+  for (unsigned I = 0; I < NumLines; I += 4999)
+    ASSERT_EQ(FileStart.getLocWithOffset(LineStarts[I]),
+              SourceMgr.translateLineCol(FID, I + 1, 1));
+
+  errs() << "Line table for " << NumLines << " lines ("
+         << Source.size() << " bytes): "
+         << format("%.6f", elapsed(Start, AfterFirst)) << "s to line 11, "
+         << format("%.4f", elapsed(AfterFirst, AfterLast))
+         << "s to the last line, "
+         << format("%.4f", elapsed(AfterLast, AfterWalk)) << "s for "
+         << NumQueries << " ordered queries\n";
+}
+
+TEST_F(SourceManagerBenchmark, LineTableOutOfOrder) {
+  std::vector<unsigned> LineStarts;
+  std::string Source = buildSource(20000, LineStarts);
+
+  SourceManager SourceMgr(Diags, FileMgr);
+  FileID FID = SourceMgr.createMainFileIDForMemBuffer(
+                 MemoryBuffer::getMemBufferCopy(Source, "shuffled.f"));
+
+  // Start in the middle, then go back and forth so that the table is
+  // extended while earlier queries are still cached.
+  for (unsigned Step = 0; Step != 2000; ++Step) {
+    unsigned Line = (Step * 7919) % LineStarts.size();
+    ASSERT_EQ(Line + 1, SourceMgr.getLineNumber(FID, LineStarts[Line] + 2));
+  }
+  EXPECT_EQ(LineStarts.size() + 1,
+            SourceMgr.getLineNumber(FID, Source.size()));
+}
+
+TEST_F(SourceManagerBenchmark, FixedFormCardColumns) {
+  const char *Source =
+    "      X = 1\n"
+    "\tY = 2\n"
+    "10\tZ = X +\tY\n";
+
+  SourceManager SourceMgr(Diags, FileMgr);
+  FileID FID = SourceMgr.createMainFileIDForMemBuffer(
+                 MemoryBuffer::getMemBuffer(Source));
+  SourceLocation Start = SourceMgr.getLocForStartOfFile(FID);
+
+  // Byte columns are unaffected by the mode.
+  SourceMgr.setFixedFormColumns(true);
+  EXPECT_EQ(2u, SourceMgr.getColumnNumber(FID, 13));
+
+  // Tabs in the label field go to column 7, others to the next tab stop.
+  EXPECT_EQ(7u, SourceMgr.getCardColumnNumber(FID, 6));
+  EXPECT_EQ(7u, SourceMgr.getCardColumnNumber(FID, 13));
+  EXPECT_EQ(7u, SourceMgr.getCardColumnNumber(FID, 22));
+  EXPECT_EQ(17u, SourceMgr.getCardColumnNumber(FID, 30));
+
+  EXPECT_EQ(7u, SourceMgr.getPresumedLoc(Start.getLocWithOffset(13))
+                  .getColumn());
+  SourceMgr.setFixedFormColumns(false);
+  EXPECT_EQ(2u, SourceMgr.getPresumedLoc(Start.getLocWithOffset(13))
+                  .getColumn());
+}
+
+} // anonymous namespace
@@ -0,0 +1,137 @@
+//===- unittests/Lex/HeaderSearchTest.cpp - HeaderSearch tests ------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "lfort/Lex/HeaderSearch.h"
+#include "lfort/Basic/Diagnostic.h"
+#include "lfort/Basic/FileManager.h"
+#include "lfort/Basic/LangOptions.h"
+#include "lfort/Basic/TargetInfo.h"
+#include "lfort/Basic/TargetOptions.h"
+#include "lfort/Lex/HeaderSearchOptions.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+using namespace lfort;
+
+namespace {
+
+// HeaderSearch test fixture, with two real search directories.
+class HeaderSearchTest : public ::testing::Test {
+protected:
+  HeaderSearchTest()
+    : FileMgr(FileMgrOpts),
+      DiagID(new DiagnosticIDs()),
+      DiagOpts(new DiagnosticOptions()),
+      Diags(DiagID, DiagOpts.getPtr(), new IgnoringDiagConsumer()) {
+    TargetOpts = new TargetOptions();
+    TargetOpts->Triple = "x86_64-unknown-linux-gnu";
+    Target = TargetInfo::CreateTargetInfo(Diags, &*TargetOpts);
+  }
+
+  virtual void SetUp() {
+    createTempDir(FirstDir);
+    createTempDir(SecondDir);
+  }
+
+  virtual void TearDown() {
+    uint32_t Removed;
+    llvm::sys::fs::remove_all(FirstDir.str(), Removed);
+    llvm::sys::fs::remove_all(SecondDir.str(), Removed);
+  }
+
+  void createTempDir(SmallString<128> &Dir) {
+    llvm::sys::path::system_temp_directory(/*erasedOnReboot=*/true, Dir);
+    llvm::sys::path::append(Dir, "lfort-modsearch-%%%%%%");
+    int FD;
+    ASSERT_FALSE(llvm::sys::fs::unique_file(Dir.str(), FD, Dir));
+    { llvm::raw_fd_ostream Closer(FD, /*shouldClose=*/true); }
+    bool Existed;
+    llvm::sys::fs::remove(Dir.str(), Existed);
+    ASSERT_FALSE(llvm::sys::fs::create_directory(Dir.str(), Existed));
+  }
+
+  std::string createFile(StringRef Dir, StringRef Name) {
+    SmallString<128> Path(Dir);
+    llvm::sys::path::append(Path, Name);
+    std::string ErrorInfo;
+    llvm::raw_fd_ostream Out(Path.c_str(), ErrorInfo);
+    Out << "module\n";
+    return Path.str();
+  }
+
+  // Create a HeaderSearch over the two directories, without the current
+  // directory.
+  HeaderSearch *createHeaderSearch(FileManager &FM) {
+    HeaderSearch *HS = new HeaderSearch(new HeaderSearchOptions(), FM, Diags,
+                                        LangOpts, Target.getPtr());
+    std::vector<DirectoryLookup> Dirs;
+    Dirs.push_back(DirectoryLookup(FM.getDirectory(FirstDir.str()),
+                                   SrcMgr::C_User, true, false));
+    Dirs.push_back(DirectoryLookup(FM.getDirectory(SecondDir.str()),
+                                   SrcMgr::C_User, true, false));
+    HS->SetSearchPaths(Dirs, 0, Dirs.size(), /*noCurDirSearch=*/true);
+    return HS;
+  }
+
+  FileSystemOptions FileMgrOpts;
+  FileManager FileMgr;
+  IntrusiveRefCntPtr<DiagnosticIDs> DiagID;
+  IntrusiveRefCntPtr<DiagnosticOptions> DiagOpts;
+  DiagnosticsEngine Diags;
+  LangOptions LangOpts;
+  IntrusiveRefCntPtr<TargetOptions> TargetOpts;
+  IntrusiveRefCntPtr<TargetInfo> Target;
+  SmallString<128> FirstDir, SecondDir;
+};
+
+TEST_F(HeaderSearchTest, FortranModuleFileSearchOrder) {
+  std::string FirstBar = createFile(FirstDir, "bar.mod");
+  createFile(SecondDir, "bar.mod");
+  std::string Foo = createFile(SecondDir, "foo.mod");
+  createFile(SecondDir, "baz.f90");
+
+  OwningPtr<HeaderSearch> HS(createHeaderSearch(FileMgr));
+  EXPECT_EQ(FileMgr.getFile(FirstBar), HS->lookupFortranModuleFile("bar"));
+  EXPECT_EQ(FileMgr.getFile(Foo), HS->lookupFortranModuleFile("FOO"));
+  EXPECT_EQ(FileMgr.getFile(Foo), HS->lookupFortranModuleFile("Foo"));
+  EXPECT_EQ(NULL, HS->lookupFortranModuleFile("baz"));
+}
+
+TEST_F(HeaderSearchTest, FortranSubmoduleFiles) {
+  std::string Mod = createFile(FirstDir, "shapes.mod");
+  std::string Smod = createFile(SecondDir, "shapes.smod");
+  std::string SubSmod = createFile(SecondDir, "Shapes@Impl.smod");
+
+  OwningPtr<HeaderSearch> HS(createHeaderSearch(FileMgr));
+  EXPECT_EQ(FileMgr.getFile(Mod), HS->lookupFortranModuleFile("shapes"));
+  EXPECT_EQ(FileMgr.getFile(Smod), HS->lookupFortranSubmoduleFile("shapes"));
+  EXPECT_EQ(FileMgr.getFile(SubSmod),
+            HS->lookupFortranSubmoduleFile("shapes@impl"));
+  EXPECT_EQ(NULL, HS->lookupFortranModuleFile("shapes@impl"));
+}
+
+TEST_F(HeaderSearchTest, FortranModuleFileIndexFollowsDirectoryChanges) {
+  createFile(SecondDir, "foo.mod");
+
+  OwningPtr<HeaderSearch> HS(createHeaderSearch(FileMgr));
+  EXPECT_EQ(NULL, HS->lookupFortranModuleFile("quux"));
+
+  // The shared index of a directory is rebuilt once the directory changes.
+  std::string Quux = createFile(SecondDir, "quux.mod");
+  FileManager OtherFileMgr(FileMgrOpts);
+  OwningPtr<HeaderSearch> OtherHS(createHeaderSearch(OtherFileMgr));
+  EXPECT_EQ(OtherFileMgr.getFile(Quux),
+            OtherHS->lookupFortranModuleFile("quux"));
+}
+
+} // anonymous namespace
@@ -0,0 +1,390 @@
+//===- unittests/Lex/LexerBenchmark.cpp ------ Lexer benchmarks -----------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// These tests lex large synthetic Fortran sources and report the time taken,
+// alongside the structural properties (token counts, identifier table sizes)
+// that the fast paths are expected to preserve or improve.  Timings are only
+// reported, never checked, so that the tests stay deterministic.
+//
+//===----------------------------------------------------------------------===//
+
+#include "lfort/Basic/Diagnostic.h"
+#include "lfort/Basic/DiagnosticOptions.h"
+#include "lfort/Basic/FileManager.h"
+#include "lfort/Basic/LangOptions.h"
+#include "lfort/Basic/SourceManager.h"
+#include "lfort/Basic/TargetInfo.h"
+#include "lfort/Basic/TargetOptions.h"
+#include "lfort/Lex/HeaderSearch.h"
+#include "lfort/Lex/HeaderSearchOptions.h"
+#include "lfort/Lex/LiteralSupport.h"
+#include "lfort/Lex/PCModuleLoader.h"
+#include "lfort/Lex/Preprocessor.h"
+#include "lfort/Lex/PreprocessorOptions.h"
+#include "llvm/ADT/OwningPtr.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Timer.h"
+#include "llvm/Support/raw_ostream.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+using namespace lfort;
+
+namespace {
+
+class VoidPCModuleLoader : public PCModuleLoader {
+  virtual PCModuleLoadResult loadPCModule(SourceLocation ImportLoc,
+                                      PCModuleIdPath Path,
+                                      PCModule::NameVisibilityKind Visibility,
+                                      bool IsInclusionDirective) {
+    return PCModuleLoadResult();
+  }
+};
+
+/// \brief What one run of the lexer over a benchmark source produced.
+struct LexRun {
+  unsigned NumTokens;
+  unsigned NumIdentifiers;
+  double WallTime;
+};
+
+// The test fixture.
+class LexerBenchmark : public ::testing::Test {
+protected:
+  LexerBenchmark()
+    : FileMgr(FileMgrOpts),
+      DiagID(new DiagnosticIDs()),
+      Diags(DiagID, new DiagnosticOptions, new IgnoringDiagConsumer()),
+      TargetOpts(new TargetOptions)
+  {
+    TargetOpts->Triple = "x86_64-apple-darwin11.1.0";
+    Target = TargetInfo::CreateTargetInfo(Diags, &*TargetOpts);
+  }
+
+  /// \brief Create a preprocessor that reads \p Source with \p LangOpts,
+  /// replacing the one made for the previous source.  It stays alive until
+  /// the next call, so that the tokens lexed from it can still be looked at.
+  Preprocessor &createPreprocessor(StringRef Source,
+                                   const LangOptions &LangOpts) {
+    PP.reset();
+    HeaderInfo.reset();
+    PPLangOpts = LangOpts;
+
+    SourceMgr.reset(new SourceManager(Diags, FileMgr));
+    MemoryBuffer *Buf = MemoryBuffer::getMemBufferCopy(Source, "bench.f");
+    (void)SourceMgr->createMainFileIDForMemBuffer(Buf);
+
+    HeaderInfo.reset(new HeaderSearch(new HeaderSearchOptions, FileMgr, Diags,
+                                      PPLangOpts, Target.getPtr()));
+    PP.reset(new Preprocessor(new PreprocessorOptions(), Diags, PPLangOpts,
+                              Target.getPtr(), *SourceMgr, *HeaderInfo,
+                              ModLoader,
+                              /*IILookup =*/ 0,
+                              /*OwnsHeaderSearch =*/false,
+                              /*DelayInitialization =*/ false));
+    return *PP;
+  }
+
+  /// \brief Lex all of \p Source with \p LangOpts and summarize the run.
+  /// If \p Toks is given, every token lexed is appended to it, together with
+  /// its spelling in \p Spellings.  The preprocessor used is left in PP.
+  LexRun lex(StringRef Source, const LangOptions &LangOpts,
+             std::vector<Token> *Toks = 0,
+             std::vector<std::string> *Spellings = 0) {
+    Preprocessor &PP = createPreprocessor(Source, LangOpts);
+    unsigned InitialIdentifiers = PP.getIdentifierTable().size();
+    PP.EnterMainSourceFile();
+
+    LexRun Run;
+    Run.NumTokens = 0;
+    TimeRecord Start = TimeRecord::getCurrentTime(/*Start=*/true);
+    Token Tok;
+    do {
+      PP.Lex(Tok);
+      ++Run.NumTokens;
+      if (Toks)
+        Toks->push_back(Tok);
+    } while (Tok.isNot(tok::eof));
+    TimeRecord End = TimeRecord::getCurrentTime(/*Start=*/false);
+
+    if (Spellings)
+      for (unsigned I = 0, E = Toks->size(); I != E; ++I)
+        Spellings->push_back(PP.getSpelling((*Toks)[I]));
+
+    Run.NumIdentifiers = PP.getIdentifierTable().size() - InitialIdentifiers;
+    Run.WallTime = End.getWallTime() - Start.getWallTime();
+    return Run;
+  }
+
+  static void report(StringRef Name, const LexRun &Run) {
+    errs() << "  " << Name << ": " << Run.NumTokens << " tokens, "
+           << Run.NumIdentifiers << " new identifiers, "
+           << format("%.4f", Run.WallTime) << "s\n";
+  }
+
+  /// \brief Lex \p Source with and without joined continuation lines and check
+  /// that the tokens are indistinguishable.
+  void checkContinuedSource(StringRef Source, bool FreeForm) {
+    LangOptions Direct;
+    Direct.FreeForm = FreeForm;
+    LangOptions Joined = Direct;
+    Joined.JoinContinuationLines = 1;
+
+    std::vector<Token> DirectToks, JoinedToks;
+    std::vector<std::string> DirectSpellings, JoinedSpellings;
+    LexRun DirectRun = lex(Source, Direct, &DirectToks,
+                          &DirectSpellings);
+    LexRun JoinedRun = lex(Source, Joined, &JoinedToks,
+                          &JoinedSpellings);
+
+    errs() << (FreeForm ? "Free-form" : "Fixed-form")
+           << " continuation lines:\n";
+    report("direct", DirectRun);
+    report("joined", JoinedRun);
+
+    ASSERT_EQ(DirectToks.size(), JoinedToks.size());
+    for (unsigned I = 0, E = DirectToks.size(); I != E; ++I) {
+      EXPECT_EQ(DirectToks[I].getKind(), JoinedToks[I].getKind());
+      EXPECT_EQ(DirectToks[I].getLocation(), JoinedToks[I].getLocation());
+      EXPECT_EQ(DirectToks[I].getLength(), JoinedToks[I].getLength());
+      EXPECT_EQ(DirectToks[I].isAtStartOfLine(),
+                JoinedToks[I].isAtStartOfLine());
+      EXPECT_EQ(DirectToks[I].hadContinuation(),
+                JoinedToks[I].hadContinuation());
+      EXPECT_EQ(DirectSpellings[I], JoinedSpellings[I]);
+    }
+  }
+
+  FileSystemOptions FileMgrOpts;
+  FileManager FileMgr;
+  IntrusiveRefCntPtr<DiagnosticIDs> DiagID;
+  DiagnosticsEngine Diags;
+  IntrusiveRefCntPtr<TargetOptions> TargetOpts;
+  IntrusiveRefCntPtr<TargetInfo> Target;
+  LangOptions PPLangOpts;
+  VoidPCModuleLoader ModLoader;
+  OwningPtr<SourceManager> SourceMgr;
+  OwningPtr<HeaderSearch> HeaderInfo;
+  OwningPtr<Preprocessor> PP;
+};
+
+/// \brief Build free-form source in which every name is spelled in several
+/// different cases, the way long-lived codes tend to end up.
+static std::string buildMixedCaseSource(unsigned NumLines) {
+  static const char *const Spellings[][4] = {
+    { "velocity", "VELOCITY", "Velocity", "veLocity" },
+    { "pressure", "PRESSURE", "Pressure", "pRESSURE" },
+    { "density",  "DENSITY",  "Density",  "densITY"  },
+    { "nx",       "NX",       "Nx",       "nX"       }
+  };
+
+  // Line I assigns to the names with suffix I % 16, using the spelling chosen
+  // by (I / 16) % 4, so that every name shows up in all four spellings.
+  std::string Source;
+  raw_string_ostream OS(Source);
+  for (unsigned I = 0; I != NumLines; ++I) {
+    unsigned Suffix = I % 16, Case = (I / 16) % 4;
+    OS << Spellings[0][Case] << Suffix << " = "
+       << Spellings[1][(Case + 1) % 4] << Suffix << " * "
+       << Spellings[2][(Case + 2) % 4] << Suffix << " + "
+       << Spellings[3][(Case + 3) % 4] << Suffix << "\n";
+  }
+  return OS.str();
+}
+
+TEST_F(LexerBenchmark, MixedCaseIdentifiers) {
+  std::string Source = buildMixedCaseSource(100000);
+
+  LangOptions Exact;
+  Exact.FreeForm = 1;
+  LangOptions Folded = Exact;
+  Folded.FoldIdentifierCase = 1;
+
+  LexRun ExactRun = lex(Source, Exact);
+  LexRun FoldedRun = lex(Source, Folded);
+
+  errs() << "Mixed-case identifiers:\n";
+  report("exact", ExactRun);
+  report("folded", FoldedRun);
+
+  // Folding must not change how the source is split into tokens, but each
+  // name must now be interned once instead of once per spelling.
+  EXPECT_EQ(ExactRun.NumTokens, FoldedRun.NumTokens);
+  EXPECT_EQ(4U * 16U * 4U, ExactRun.NumIdentifiers);
+  EXPECT_EQ(4U * 16U, FoldedRun.NumIdentifiers);
+}
+
+/// \brief Build a large DATA statement with NumLines continuation lines.
+static std::string buildContinuedSource(unsigned NumLines, bool FreeForm) {
+  std::string Source;
+  raw_string_ostream OS(Source);
+  OS << (FreeForm ? "data coeffs / &\n" : "      data coeffs /\n");
+  for (unsigned I = 0; I != NumLines; ++I) {
+    OS << (FreeForm ? "    " : "     &");
+    for (unsigned J = 0; J != 8; ++J)
+      OS << " " << (I * 8 + J) << ",";
+    OS << (FreeForm ? " &\n" : "\n");
+  }
+  OS << (FreeForm ? "    " : "     &") << " 0 /\n";
+  return OS.str();
+}
+
+TEST_F(LexerBenchmark, FreeFormContinuationLines) {
+  checkContinuedSource(buildContinuedSource(50000, true), true);
+}
+
+TEST_F(LexerBenchmark, FixedFormContinuationLines) {
+  checkContinuedSource(buildContinuedSource(50000, false), false);
+}
+
+TEST_F(LexerBenchmark, ContinuationLinesThatAreNotJoined) {
+  // Split tokens, character contexts and intervening comments are all lexed
+  // from the file; the result must be the same either way.
+  checkContinuedSource("x = ab&\n"
+                       "    &cd\n"
+                       "y = 'a &\n"
+                       "    &b'\n"
+                       "z = 1 + & ! comment\n"
+                       "    2\n"
+                       "w = 3 + &\n"
+                       "\n"
+                       "    & 4 ! trailing\n", true);
+}
+
+/// \brief Build a coefficient table that uses every form of numeric constant
+/// on each line.
+static std::string buildNumericSource(unsigned NumLines) {
+  std::string Source;
+  raw_string_ostream OS(Source);
+  for (unsigned I = 0; I != NumLines; ++I)
+    OS << "coeffs = [" << I << ", " << I << ".5, " << I << ".0d0, .25e-3_dp, "
+       << I << "_8, 7.25q+1, z'ff', b'1011', o'17', 1.5D+300]\n";
+  return OS.str();
+}
+
+TEST_F(LexerBenchmark, NumericConstants) {
+  std::string Source = buildNumericSource(20000);
+
+  LangOptions LangOpts;
+  LangOpts.FreeForm = 1;
+
+  Preprocessor &PP = createPreprocessor(Source, LangOpts);
+  PP.EnterMainSourceFile();
+
+  // Parse each constant right after lexing it, the way the parser does, and
+  // again from a copy of its spelling that the lexer has never seen.
+  unsigned NumConstants = 0;
+  double CachedTime = 0, UncachedTime = 0;
+  Token Tok;
+  do {
+    PP.Lex(Tok);
+    if (Tok.isNot(tok::numeric_constant))
+      continue;
+    ++NumConstants;
+
+    SmallString<32> Buffer;
+    StringRef Spelling = PP.getSpelling(Tok, Buffer);
+    std::string Copy = Spelling.str();
+
+    TimeRecord Start = TimeRecord::getCurrentTime(/*Start=*/true);
+    NumericLiteralParser Cached(Spelling, Tok.getLocation(), PP);
+    TimeRecord Mid = TimeRecord::getCurrentTime(/*Start=*/false);
+    NumericLiteralParser Uncached(Copy, Tok.getLocation(), PP);
+    TimeRecord End = TimeRecord::getCurrentTime(/*Start=*/false);
+    CachedTime += Mid.getWallTime() - Start.getWallTime();
+    UncachedTime += End.getWallTime() - Mid.getWallTime();
+
+    ASSERT_FALSE(Cached.hadError) << Spelling.str();
+    ASSERT_FALSE(Uncached.hadError) << Spelling.str();
+    EXPECT_EQ(Uncached.getRadix(), Cached.getRadix());
+    EXPECT_EQ(Uncached.isFloatingLiteral(), Cached.isFloatingLiteral());
+    EXPECT_EQ(Uncached.isLong, Cached.isLong);
+    EXPECT_EQ(Uncached.getExponentLetter(), Cached.getExponentLetter());
+    ASSERT_EQ(Uncached.hasKindParam(), Cached.hasKindParam());
+    if (Cached.hasKindParam())
+      EXPECT_EQ(Uncached.getKindParam(), Cached.getKindParam());
+
+    if (Cached.isFloatingLiteral()) {
+      APFloat CachedVal(APFloat::IEEEdouble), UncachedVal(APFloat::IEEEdouble);
+      Cached.GetFloatValue(CachedVal);
+      Uncached.GetFloatValue(UncachedVal);
+      EXPECT_TRUE(CachedVal.bitwiseIsEqual(UncachedVal)) << Spelling.str();
+    } else {
+      APInt CachedVal(64, 0), UncachedVal(64, 0);
+      EXPECT_FALSE(Cached.GetIntegerValue(CachedVal));
+      EXPECT_FALSE(Uncached.GetIntegerValue(UncachedVal));
+      EXPECT_EQ(UncachedVal, CachedVal) << Spelling.str();
+    }
+  } while (Tok.isNot(tok::eof));
+
+  errs() << "Numeric constants: " << NumConstants << " parsed in "
+         << format("%.4f", CachedTime) << "s after lexing, "
+         << format("%.4f", UncachedTime) << "s from scratch\n";
+
+  // Every constant, kind parameter and exponent included, is a single token.
+  EXPECT_EQ(20000U * 10U, NumConstants);
+}
+
+TEST_F(LexerBenchmark, NumericConstantsBeforeDotOperators) {
+  LangOptions LangOpts;
+  LangOpts.FreeForm = 1;
+
+  std::vector<Token> Toks;
+  std::vector<std::string> Spellings;
+  lex("x = 1.eq.n .or. 2.5.lt.y .and. 1.e5.gt.3\n", LangOpts, &Toks,
+      &Spellings);
+
+  std::vector<std::string> Constants;
+  for (unsigned I = 0, E = Toks.size(); I != E; ++I)
+    if (Toks[I].is(tok::numeric_constant))
+      Constants.push_back(Spellings[I]);
+
+  ASSERT_EQ(4U, Constants.size());
+  EXPECT_EQ("1", Constants[0]);
+  EXPECT_EQ("2.5", Constants[1]);
+  EXPECT_EQ("1.e5", Constants[2]);
+  EXPECT_EQ("3", Constants[3]);
+}
+
+TEST_F(LexerBenchmark, FoldedIdentifiersShareInfo) {
+  LangOptions LangOpts;
+  LangOpts.FreeForm = 1;
+  LangOpts.FoldIdentifierCase = 1;
+
+  std::vector<Token> Toks;
+  lex("FOO = Foo + foo\n"
+      "Program x\n", LangOpts, &Toks);
+
+  ASSERT_EQ(8U, Toks.size());
+  EXPECT_EQ(Toks[0].getIdentifierInfo(), Toks[2].getIdentifierInfo());
+  EXPECT_EQ(Toks[0].getIdentifierInfo(), Toks[4].getIdentifierInfo());
+  EXPECT_EQ("foo", Toks[0].getIdentifierInfo()->getName());
+  EXPECT_EQ(tok::kw_program, Toks[5].getKind());
+
+  // The original spelling is still what the token refers to.
+  EXPECT_EQ("Foo", PP->getSpelling(Toks[2]));
+}
+
+TEST_F(LexerBenchmark, FoldedIdentifiersAreCleanedFirst) {
+  LangOptions LangOpts;
+  LangOpts.FreeForm = 1;
+  LangOpts.FoldIdentifierCase = 1;
+
+  std::vector<Token> Toks;
+  lex("Fo\\\nO = foo\n", LangOpts, &Toks);
+
+  // The escaped newline is not part of the name.
+  ASSERT_EQ(4U, Toks.size());
+  EXPECT_TRUE(Toks[0].needsCleaning());
+  EXPECT_EQ(Toks[0].getIdentifierInfo(), Toks[2].getIdentifierInfo());
+  EXPECT_EQ("foo", Toks[0].getIdentifierInfo()->getName());
+}
+
+} // anonymous namespace
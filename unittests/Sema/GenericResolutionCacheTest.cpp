@@ -0,0 +1,105 @@
+//===- unittests/Sema/GenericResolutionCacheTest.cpp - Generic cache tests ===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "lfort/Sema/GenericResolutionCache.h"
+#include "lfort/Basic/IdentifierTable.h"
+#include "lfort/Basic/LangOptions.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+using namespace lfort;
+
+namespace {
+
+// The cache never looks inside the declarations it records, so the tests
+// stand them in with distinct addresses.
+class GenericResolutionCacheTest : public ::testing::Test {
+protected:
+  GenericResolutionCacheTest()
+    : Idents(LangOpts),
+      Swap(&Idents.get("swap")),
+      Norm(&Idents.get("norm")) {}
+
+  SubprogramDecl *specific(unsigned I) {
+    return reinterpret_cast<SubprogramDecl *>(&Decls[I]);
+  }
+  NamedDecl *found(unsigned I) {
+    return reinterpret_cast<NamedDecl *>(&Decls[I]);
+  }
+
+  /// \brief Builds the key of a call to \p Name with specifics 0 and 1 in
+  /// scope and arguments of the (stand-in) type \p ArgType.
+  FoldingSetNodeID key(DeclarationName Name, unsigned ArgType) {
+    FoldingSetNodeID ID;
+    Cache.addGenericName(ID, Name);
+    ID.AddPointer(specific(0));
+    ID.AddPointer(specific(1));
+    ID.AddInteger(ArgType);
+    return ID;
+  }
+
+  LangOptions LangOpts;
+  IdentifierTable Idents;
+  DeclarationName Swap, Norm;
+  GenericResolutionCache Cache;
+  void *Decls[4];
+};
+
+TEST_F(GenericResolutionCacheTest, FindsRecordedResolution) {
+  FoldingSetNodeID Reals = key(Swap, 1);
+  EXPECT_TRUE(Cache.lookup(Reals) == 0);
+
+  Cache.insert(Reals, specific(1), found(1), AS_public);
+  GenericResolutionCache::Resolution *R = Cache.lookup(key(Swap, 1));
+  ASSERT_TRUE(R != 0);
+  EXPECT_EQ(specific(1), R->getSpecific());
+  EXPECT_EQ(found(1), R->getFoundDecl());
+  EXPECT_EQ(AS_public, R->getFoundAccess());
+}
+
+TEST_F(GenericResolutionCacheTest, KeysOnArgumentsAndName) {
+  Cache.insert(key(Swap, 1), specific(1), found(1), AS_public);
+
+  // Another argument signature, or another generic with the same
+  // specifics, must be resolved on its own.
+  EXPECT_TRUE(Cache.lookup(key(Swap, 2)) == 0);
+  EXPECT_TRUE(Cache.lookup(key(Norm, 1)) == 0);
+
+  Cache.insert(key(Swap, 2), specific(0), found(0), AS_public);
+  EXPECT_EQ(specific(0), Cache.lookup(key(Swap, 2))->getSpecific());
+  EXPECT_EQ(specific(1), Cache.lookup(key(Swap, 1))->getSpecific());
+}
+
+TEST_F(GenericResolutionCacheTest, ExtendingGenericInvalidates) {
+  Cache.insert(key(Swap, 1), specific(1), found(1), AS_public);
+  Cache.insert(key(Norm, 1), specific(0), found(0), AS_public);
+
+  // A new specific for swap may be a better match for the same arguments.
+  Cache.noteSpecificDeclared(Swap);
+  EXPECT_TRUE(Cache.lookup(key(Swap, 1)) == 0);
+
+  // Other generics keep their resolutions.
+  ASSERT_TRUE(Cache.lookup(key(Norm, 1)) != 0);
+  EXPECT_EQ(specific(0), Cache.lookup(key(Norm, 1))->getSpecific());
+
+  // Resolutions recorded after the extension are found again.
+  Cache.insert(key(Swap, 1), specific(2), found(2), AS_public);
+  ASSERT_TRUE(Cache.lookup(key(Swap, 1)) != 0);
+  EXPECT_EQ(specific(2), Cache.lookup(key(Swap, 1))->getSpecific());
+}
+
+TEST_F(GenericResolutionCacheTest, DeclaringUnusedNameKeepsResolutions) {
+  Cache.insert(key(Swap, 1), specific(1), found(1), AS_public);
+
+  // A name that was never called as a generic has nothing to invalidate.
+  Cache.noteSpecificDeclared(DeclarationName(&Idents.get("other")));
+  EXPECT_TRUE(Cache.lookup(key(Swap, 1)) != 0);
+}
+
+} // anonymous namespace
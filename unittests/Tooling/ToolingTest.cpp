@@ -167,6 +167,26 @@ TEST(newFrontendActionFactory, InjectsEndOfSourceFileCallback) {
   EXPECT_TRUE(EndCallback.Matched);
   EXPECT_EQ(2u, EndCallback.Called);
 }
+
+TEST(LFortTool, RunsCompileCommandsOnSeveralThreads) {
+  FixedCompilationDatabase Compilations("/", std::vector<std::string>());
+  std::vector<std::string> Sources;
+  for (char Name = 'a'; Name != 'h'; ++Name)
+    Sources.push_back(std::string("/") + Name + ".f90");
+  LFortTool Tool(Compilations, Sources);
+  Tool.setNumThreads(4);
+  for (unsigned I = 0, E = Sources.size(); I != E; ++I)
+    Tool.mapVirtualFile(Sources[I], "end");
+  EXPECT_EQ(0, Tool.run(newFrontendActionFactory<SyntaxOnlyAction>()));
+
+  // A failure on any thread is reported.
+  Sources.push_back("/lfort-tooling-test-missing.f90");
+  LFortTool FailingTool(Compilations, Sources);
+  FailingTool.setNumThreads(4);
+  for (unsigned I = 0, E = Sources.size() - 1; I != E; ++I)
+    FailingTool.mapVirtualFile(Sources[I], "end");
+  EXPECT_EQ(1, FailingTool.run(newFrontendActionFactory<SyntaxOnlyAction>()));
+}
 #endif
 
 struct SkipBodyConsumer : public lfort::ASTConsumer {
@@ -0,0 +1,138 @@
+//===--- LFortIntrinsicsEmitter.cpp - Generate Fortran intrinsic tables ---===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This tablegen backend emits the table of Fortran intrinsic procedures, an
+// efficient matcher for their names and the mapping of intrinsics onto LLVM
+// intrinsics.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ADT/StringSet.h"
+#include "llvm/TableGen/Error.h"
+#include "llvm/TableGen/Record.h"
+#include "llvm/TableGen/StringMatcher.h"
+#include <cstring>
+#include <vector>
+
+using namespace llvm;
+
+/// \brief Check the argument and result type strings of an intrinsic and
+/// return the number of arguments it describes.
+static unsigned checkIntrinsic(const Record &R) {
+  std::string Args = R.getValueAsString("ArgTypes");
+  bool Variadic = !Args.empty() && Args[Args.size() - 1] == '.';
+  unsigned NumArgs = Args.size() - Variadic;
+
+  for (unsigned I = 0; I != NumArgs; ++I) {
+    if (!strchr("irxcfnlsak=", Args[I]))
+      PrintFatalError(R.getLoc(), "Intrinsic '" + R.getName() +
+                      "' has an invalid argument type '" + Args[I] + "'");
+    if (Args[I] == '=' && I == 0)
+      PrintFatalError(R.getLoc(), "Intrinsic '" + R.getName() +
+                      "' has no first argument to match");
+  }
+
+  std::string Result = R.getValueAsString("ResultType");
+  if (Result.size() != 1 || !strchr("=pqemirdclhsjav", Result[0]))
+    PrintFatalError(R.getLoc(), "Intrinsic '" + R.getName() +
+                    "' has an invalid result type '" + Result + "'");
+
+  if (R.getValueAsListOfStrings("Keywords").size() != NumArgs)
+    PrintFatalError(R.getLoc(), "Intrinsic '" + R.getName() +
+                    "' does not name each of its arguments");
+
+  int64_t NumRequired = R.getValueAsInt("NumRequired");
+  if (NumRequired > (int64_t)NumArgs)
+    PrintFatalError(R.getLoc(), "Intrinsic '" + R.getName() +
+                    "' requires more arguments than it has");
+
+  int64_t KindArg = R.getValueAsInt("KindArg");
+  if (KindArg >= 0 && ((unsigned)KindArg >= NumArgs || Args[KindArg] != 'k'))
+    PrintFatalError(R.getLoc(), "Intrinsic '" + R.getName() +
+                    "' names an argument that is not a kind as its KIND");
+
+  return NumArgs;
+}
+
+namespace lfort {
+void EmitLFortIntrinsics(RecordKeeper &Records, raw_ostream &OS) {
+  std::vector<Record *> Intrinsics =
+    Records.getAllDerivedDefinitions("Intrinsic");
+
+  OS << "// This file is generated by TableGen.  Do not edit.\n\n";
+
+  // The list of intrinsics, from which the enumeration of intrinsic IDs is
+  // built.
+  OS << "#ifdef GET_FORTRAN_INTRINSIC_LIST\n";
+  StringSet<> Names;
+  for (size_t i = 0, e = Intrinsics.size(); i != e; ++i) {
+    Record &R = *Intrinsics[i];
+    std::string Name = R.getValueAsString("Name");
+    if (!Names.insert(Name))
+      PrintFatalError(R.getLoc(), "Intrinsic '" + Name +
+                      "' is defined more than once");
+    OS << "FORTRAN_INTRINSIC(" << Name << ")\n";
+  }
+  OS << "#endif\n\n";
+
+  // The description of each intrinsic, in the order of the list.
+  OS << "#ifdef GET_FORTRAN_INTRINSIC_INFO\n";
+  for (size_t i = 0, e = Intrinsics.size(); i != e; ++i) {
+    Record &R = *Intrinsics[i];
+    unsigned NumArgs = checkIntrinsic(R);
+    int64_t NumRequired = R.getValueAsInt("NumRequired");
+    if (NumRequired < 0)
+      NumRequired = NumArgs;
+
+    std::vector<std::string> Keywords = R.getValueAsListOfStrings("Keywords");
+    std::string KeywordList;
+    for (unsigned I = 0, N = Keywords.size(); I != N; ++I) {
+      if (I)
+        KeywordList += ',';
+      KeywordList += Keywords[I];
+    }
+
+    OS << "  { "
+       << "\"" << R.getValueAsString("Name") << "\", "
+       << "\"" << KeywordList << "\", "
+       << "\"" << R.getValueAsString("ArgTypes") << "\", "
+       << "'" << R.getValueAsString("ResultType") << "', "
+       << NumRequired << ", "
+       << R.getValueAsInt("KindArg") << ", "
+       << R.getValueAsBit("Elemental")
+       << " },\n";
+  }
+  OS << "#endif\n\n";
+
+  // The matcher for intrinsic names, which are lowercase like the
+  // identifiers the parser hands to Sema.
+  std::vector<StringMatcher::StringPair> Matches;
+  for (size_t i = 0, e = Intrinsics.size(); i != e; ++i) {
+    std::string Name = Intrinsics[i]->getValueAsString("Name");
+    Matches.push_back(StringMatcher::StringPair(Name,
+                                                "return FI_" + Name + ";"));
+  }
+
+  OS << "#ifdef GET_FORTRAN_INTRINSIC_LOOKUP\n";
+  StringMatcher("Name", Matches, OS).Emit();
+  OS << "#endif\n\n";
+
+  // The LLVM intrinsics that calls to intrinsic procedures map onto.
+  OS << "#ifdef GET_FORTRAN_INTRINSIC_LLVM_IDS\n";
+  for (size_t i = 0, e = Intrinsics.size(); i != e; ++i) {
+    Record &R = *Intrinsics[i];
+    std::string LLVMName = R.getValueAsString("LLVMIntrinsic");
+    if (LLVMName.empty())
+      continue;
+    OS << "  case intrinsic::FI_" << R.getValueAsString("Name")
+       << ": return llvm::Intrinsic::" << LLVMName << ";\n";
+  }
+  OS << "#endif\n\n";
+}
+} // end namespace lfort
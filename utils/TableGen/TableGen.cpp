@@ -43,6 +43,7 @@ enum ActionType {
   GenLFortCommentHTMLTags,
   GenLFortCommentHTMLTagsProperties,
   GenLFortCommentCommandInfo,
+  GenLFortIntrinsics,
   GenOptParserDefs, GenOptParserImpl,
   GenArmNeon,
   GenArmNeonSema,
@@ -108,6 +109,9 @@ namespace {
                                "gen-lfort-comment-command-info",
                                "Generate list of commands that are used in "
                                "documentation comments"),
+                    clEnumValN(GenLFortIntrinsics, "gen-lfort-intrinsics",
+                               "Generate LFort Fortran intrinsic procedure "
+                               "tables"),
                     clEnumValN(GenArmNeon, "gen-arm-neon",
                                "Generate arm_neon.h for lfort"),
                     clEnumValN(GenArmNeonSema, "gen-arm-neon-sema",
@@ -184,6 +188,9 @@ bool LFortTableGenMain(raw_ostream &OS, RecordKeeper &Records) {
   case GenLFortCommentCommandInfo:
     EmitLFortCommentCommandInfo(Records, OS);
     break;
+  case GenLFortIntrinsics:
+    EmitLFortIntrinsics(Records, OS);
+    break;
   case GenOptParserDefs:
     EmitOptParser(Records, OS, true);
     break;
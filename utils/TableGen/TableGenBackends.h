@@ -52,6 +52,8 @@ void EmitLFortCommentHTMLTagsProperties(RecordKeeper &Records, raw_ostream &OS);
 
 void EmitLFortCommentCommandInfo(RecordKeeper &Records, raw_ostream &OS);
 
+void EmitLFortIntrinsics(RecordKeeper &Records, raw_ostream &OS);
+
 void EmitNeon(RecordKeeper &Records, raw_ostream &OS);
 void EmitNeonSema(RecordKeeper &Records, raw_ostream &OS);
 void EmitNeonTest(RecordKeeper &Records, raw_ostream &OS);